@@ -11,6 +11,7 @@
 
 #include <libe15-fpa.h>
 #include <libe15-pid.h>
+#include <foc.h>
 
 #define deadloop 1
 
@@ -75,64 +76,14 @@ pid_state_t current_id_loop = {0};
 #define MOTOR_STEP_PER_ROUND 4096 //* step per round of motor, depends on encoder resolution
 #define MOTOR_INITIAL_ANGLE 0     //* initial angle of motor, in step
 
-void foc_do_Park_transform(int32_t position, fixed_t I_a, fixed_t I_b, fixed_t *I_d_out, fixed_t *I_q_out)
-{
-    // calculate the angle of motor shaft
-    int32_t motor_pos = position - MOTOR_INITIAL_ANGLE;
-    motor_pos %= MOTOR_STEP_PER_ROUND;
-
-    // convert to fixed_t and convert to radian
-    fixed_t motor_angle = fixed_from_int(motor_pos);
-
-    // convert to electrical angle
-    // * proceducaly, convert to radian first, then convert to electrical angle
-    // * but radian conversion involves a division, for precision reason,
-    // * we first multiply the pole pair count.
-    motor_angle = fixed_mul(motor_angle, fixed_from_int(MOTOR_POLAR_COUNT));
-
-    // * then convert to radian
-    motor_angle = fixed_mul(motor_angle, FIXED_2PI);
-    motor_angle = fixed_div(motor_angle, fixed_from_int(MOTOR_STEP_PER_ROUND));
-
-    // reverse the angle
-    motor_angle.val = -motor_angle.val;
+// encoder count to electrical angle, the division is done once at init
+angle_encoder_t motor_encoder;
 
-    fixed_t cos_angle = fixed_cos(motor_angle);
-    fixed_t sin_angle = fixed_sin(motor_angle);
-
-    // mat rotation
-    *I_d_out = fixed_sub(fixed_mul(I_a, cos_angle), fixed_mul(I_b, sin_angle));
-    *I_q_out = fixed_add(fixed_mul(I_a, sin_angle), fixed_mul(I_b, cos_angle));
-}
-
-void foc_do_reverse_Park_transform(int32_t position, fixed_t I_d, fixed_t I_q, fixed_t *I_a_out, fixed_t *I_b_out)
-{
-    // calculate the angle of motor shaft
-    int32_t motor_pos = position - MOTOR_INITIAL_ANGLE;
-    motor_pos %= MOTOR_STEP_PER_ROUND;
-
-    // convert to fixed_t and convert to radian
-    fixed_t motor_angle = fixed_from_int(motor_pos);
-
-    // convert to electrical angle
-    // * proceducaly, convert to radian first, then convert to electrical angle
-    // * but radian conversion involves a division, for precision reason,
-    // * we first multiply the pole pair count.
-    motor_angle = fixed_mul(motor_angle, fixed_from_int(MOTOR_POLAR_COUNT));
-
-    // * then convert to radian
-    motor_angle = fixed_mul(motor_angle, FIXED_2PI);
-    motor_angle = fixed_div(motor_angle, fixed_from_int(MOTOR_STEP_PER_ROUND));
-
-    fixed_t cos_angle = fixed_cos(motor_angle);
-    fixed_t sin_angle = fixed_sin(motor_angle);
-
-    // mat rotation
-    *I_a_out = fixed_sub(fixed_mul(I_d, cos_angle), fixed_mul(I_q, sin_angle));
-    *I_b_out = fixed_add(fixed_mul(I_d, sin_angle), fixed_mul(I_q, cos_angle));
-}
 int main()
 {
+    angle_encoder_init(&motor_encoder, MOTOR_STEP_PER_ROUND, MOTOR_POLAR_COUNT);
+    // the electrical angle is 0 at MOTOR_INITIAL_ANGLE
+    motor_encoder.offset = 0u - angle_encoder_electrical(&motor_encoder, MOTOR_INITIAL_ANGLE);
 
     while (deadloop)
     {
@@ -143,9 +94,10 @@ int main()
         fixed_t current_a = foc_adc_get_current_pole_a();
         fixed_t current_b = foc_adc_get_current_pole_b();
 
-        fixed_t Iq, Id;
-
-        foc_do_Park_transform(position, current_a, current_b, &Id, &Iq);
+        // one sin / cos for both transforms. the two phases of this motor
+        // are already at 90 degrees, so they are alpha / beta as they are.
+        foc_sincos_t sc = foc_sincos_angle(angle_encoder_electrical(&motor_encoder, position));
+        foc_dq_t I = foc_park((foc_ab_t){current_a, current_b}, sc);
 
         int32_t position_expect = foc_get_expect_position();
         fixed_t position_error = fixed_from_int(position_expect - position);
@@ -155,18 +107,17 @@ int main()
         fixed_t current_id_expect = pid_get_value(&current_id_loop);
         fixed_t current_iq_expect = FIXED_ZERO;
 
-        fixed_t current_id_error = fixed_sub(current_id_expect, Id);
-        fixed_t currend_iq_error = fixed_sub(current_iq_expect, Iq);
+        fixed_t current_id_error = fixed_sub(current_id_expect, I.d);
+        fixed_t currend_iq_error = fixed_sub(current_iq_expect, I.q);
 
         pid_update_controller(&current_id_loop, current_id_error);
         pid_update_controller(&current_iq_loop, currend_iq_error);
 
-        fixed_t duty_a, duty_b;
-
-        foc_do_reverse_Park_transform(position, pid_get_value(&current_id_loop), pid_get_value(&current_iq_loop), &duty_a, &duty_b);
+        foc_dq_t V = {pid_get_value(&current_id_loop), pid_get_value(&current_iq_loop)};
+        foc_ab_t duty = foc_inverse_park(V, sc);
 
-        foc_pwm_set_duty_a(duty_a);
+        foc_pwm_set_duty_a(duty.alpha);
 
-        foc_pwm_set_duty_b(duty_b);
+        foc_pwm_set_duty_b(duty.beta);
     }
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
 .SECONDEXPANSION:
 CHEAT_HEADER := $(BUILD_DIR)/cheat.h
 CHEAT_URL := https://raw.githubusercontent.com/Tuplanolla/cheat/master/cheat.h
-TEST_SUITS = $(shell find test -name "*.c")
+TEST_SUITS = $(shell find test -name "*.c" -o -name "*.cpp")
 
 TARGET ?= all
 
@@ -9,7 +9,7 @@ TARGET ?= all
 ifeq ($(TARGET),all)
 SELECTED_TEST_SUITS := $(TEST_SUITS)
 else
-SELECTED_TEST_SUITS := $(filter $(TARGET:%=test/test.%.c),$(TEST_SUITS))
+SELECTED_TEST_SUITS := $(filter $(TARGET:%=test/test.%.c) $(TARGET:%=test/test.%.cpp),$(TEST_SUITS))
 endif
 
 # check if target is valid
@@ -43,6 +43,25 @@ CFLAGS += $(addprefix -I,$(INC_DIRS))
 
 CFLAGS := -g $(CFLAGS)
 
+# target flags of the library and the suites, e.g. TEST_ARCH_FLAGS=-mavx2
+TEST_ARCH_FLAGS ?=
+CFLAGS += $(TEST_ARCH_FLAGS)
+
+# x86-64 hosts run the suites again with the SSE4.1 and the AVX2 kernels of
+# fpa_array.c, filter.c and pid.c, the default build only targets SSE2.
+# each one builds in $(BUILD_DIR)/simd-<arch>, if this cpu can run it.
+ifeq ($(shell uname -m),x86_64)
+TEST_SIMD_ARCHS ?= $(if $(shell grep -m1 -w sse4_1 /proc/cpuinfo),sse4.1) \
+                   $(if $(shell grep -m1 -w avx2 /proc/cpuinfo),avx2)
+endif
+
+TEST_SIMD_RUNS := $(strip $(TEST_SIMD_ARCHS:%=test_simd_%))
+
+test_simd_%: $(AUTOCONF_PATH) $(CHEAT_HEADER)
+	@mkdir -p $(BUILD_DIR)/simd-$*
+	@cp $(AUTOCONF_PATH) $(CHEAT_HEADER) $(BUILD_DIR)/simd-$*/
+	@$(MAKE) --no-print-directory test BUILD_DIR=$(BUILD_DIR)/simd-$* TEST_ARCH_FLAGS=-m$* TEST_SIMD_ARCHS=
+
 # Compilation patterns
 $(BUILD_DIR)/%.o: $(SOURCE_DIR)/%.c $(AUTO_DEP)
 	@echo "+ CC    $<"
@@ -57,12 +76,19 @@ $(BUILD_DIR)/%.o: $(SOURCE_DIR)/%.cpp $(AUTO_DEP)
 	$(call call_fixdep,$(@:%=%.d),$@,$(CFLAGS))
 
 # Generate test-suits
-$(BUILD_DIR)/test/test.%: $(TESTS_DIR)/test.%.c build/$$*/$$*.o $(CHEAT_HEADER) $(AUTO_DEP) 
+$(BUILD_DIR)/test/test.%: $(TESTS_DIR)/test.%.c $(BUILD_DIR)/$$*/$$*.o $(CHEAT_HEADER) $(AUTO_DEP) 
 	@echo "+ LD    $@"
 	@mkdir -p $(dir $@)
 	@$(CC) $(CFLAGS) -MMD -MF $(@:%=%.d) -o $@ $(sort $(abspath $(filter %.c %.o %.s ,$^))) $(LDLIBS)
 	$(call call_fixdep,$(@:%=%.d), $@,$(CFLAGS))
 
+# C++ test-suits, for the C++ headers
+$(BUILD_DIR)/test/test.%: $(TESTS_DIR)/test.%.cpp $(BUILD_DIR)/$$*/$$*.o $(CHEAT_HEADER) $(AUTO_DEP)
+	@echo "+ LD    $@"
+	@mkdir -p $(dir $@)
+	@$(CXX) -std=c++14 $(CFLAGS) $(CXXFLAGS) -MMD -MF $(@:%=%.d) -o $@ $(sort $(abspath $(filter %.cpp %.o %.s ,$^))) $(LDLIBS)
+	$(call call_fixdep,$(@:%=%.d), $@,$(CFLAGS))
+
 # Execute tests:
 $(BUILD_DIR)/$(EXECUTION_LOG_DIR)/%.log: $(BUILD_DIR)/test/%
 	@echo ""
@@ -71,6 +97,6 @@ $(BUILD_DIR)/$(EXECUTION_LOG_DIR)/%.log: $(BUILD_DIR)/test/%
 	@echo "TEST  $(@:%.log=%) END"
 
 # test target file path
-TEST_TARGET := $(addprefix $(BUILD_DIR)/,$(SELECTED_TEST_SUITS:%.c=%))
+TEST_TARGET := $(addprefix $(BUILD_DIR)/,$(basename $(SELECTED_TEST_SUITS)))
 
 TEST_TARGET_LOGS := $(TEST_TARGET:$(BUILD_DIR)/test/%=$(BUILD_DIR)/$(EXECUTION_LOG_DIR)/%.log)
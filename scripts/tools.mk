@@ -3,8 +3,16 @@
 
 AUTO_DEP := $(BUILD_DIR)/tools/autodep
 CORDIC := $(BUILD_DIR)/tools/cordic
+BENCH := $(BUILD_DIR)/tools/bench
+SWEEP := $(BUILD_DIR)/tools/sweep
+TWIDDLE := $(BUILD_DIR)/tools/twiddle
+ZIGGURAT := $(BUILD_DIR)/tools/ziggurat
+FILTER_DESIGN := $(BUILD_DIR)/tools/filter_design
+PLANT_SIM := $(BUILD_DIR)/tools/plant_sim
 
 CORDIC_HEADER := $(BUILD_DIR)/cordic.h
+TWIDDLE_HEADER := $(BUILD_DIR)/fft_twiddle.h
+ZIGGURAT_HEADER := $(BUILD_DIR)/ziggurat_table.h
 
 DENPENDENCIES := $(shell find . -name '*.d')
 
@@ -21,12 +29,72 @@ define call_fixdep
 	@mv $(1).temp $(1)
 endef
 
-$(CORDIC) : $(TOOLS_SRC_DIR)/cordic/cordic.c
+# the generated tables follow the trig backend selected in menuconfig,
+# -O2 as `make trig_report` times the table lookup of fpa_sin_lut.h
+$(CORDIC) : $(TOOLS_SRC_DIR)/cordic/cordic.c $(SOURCE_DIR)/math/fpa_sin_lut.h $(wildcard $(AUTOCONF_PATH))
 	@echo "+ CC    $<"
 	@mkdir -p $(dir $@)
-	@$(CC) $(CFLAGS) $< $(LDLIBS) -o $@
+	@$(CC) -O2 $(CFLAGS) $< $(LDLIBS) -o $@
+
+# closed loop simulation of the PID / FOC code
+PLANT_SIM_SOURCES := $(TOOLS_SRC_DIR)/plant_sim/plant_sim.c $(SOURCE_DIR)/math/fpa.c \
+	$(SOURCE_DIR)/math/pid.c $(SOURCE_DIR)/math/foc.c $(SOURCE_DIR)/math/angle.c
+
+$(PLANT_SIM) : $(PLANT_SIM_SOURCES) $(CORDIC_HEADER)
+	@echo "+ CC    $<"
+	@mkdir -p $(dir $@)
+	@$(CC) -O2 $(CFLAGS) $(PLANT_SIM_SOURCES) $(LDLIBS) -o $@
 
 $(CORDIC_HEADER) : $(CORDIC)
 	@echo "+ GEN   $@"
 	@mkdir -p $(dir $@)
-	@$(CORDIC) > $@
\ No newline at end of file
+	@$(CORDIC) > $@
+
+# FFT tables, sized by FFT_MAX_POINTS_LOG2
+$(TWIDDLE) : $(TOOLS_SRC_DIR)/twiddle/twiddle.c $(wildcard $(AUTOCONF_PATH))
+	@echo "+ CC    $<"
+	@mkdir -p $(dir $@)
+	@$(CC) $(CFLAGS) $< $(LDLIBS) -o $@
+
+$(TWIDDLE_HEADER) : $(TWIDDLE)
+	@echo "+ GEN   $@"
+	@mkdir -p $(dir $@)
+	@$(TWIDDLE) > $@
+
+# normal distribution tables of random.c
+$(ZIGGURAT) : $(TOOLS_SRC_DIR)/ziggurat/ziggurat.c
+	@echo "+ CC    $<"
+	@mkdir -p $(dir $@)
+	@$(CC) $(CFLAGS) $< $(LDLIBS) -o $@
+
+$(ZIGGURAT_HEADER) : $(ZIGGURAT)
+	@echo "+ GEN   $@"
+	@mkdir -p $(dir $@)
+	@$(ZIGGURAT) > $@
+
+# host benchmark, built from the library sources with optimization on.
+# -march=native lets the array kernels pick the SIMD backend of this cpu.
+BENCH_SOURCES := $(TOOLS_SRC_DIR)/bench/bench.c $(SOURCE_DIR)/math/fpa.c $(SOURCE_DIR)/math/fpa_array.c $(SOURCE_DIR)/math/fft.c \
+                 $(SOURCE_DIR)/math/filter.c $(SOURCE_DIR)/math/foc.c \
+                 $(SOURCE_DIR)/math/angle.c $(SOURCE_DIR)/math/pid.c $(SOURCE_DIR)/math/random.c \
+                 $(SOURCE_DIR)/hardware/modbus/modbus.c
+BENCH_CFLAGS ?= -O2 -march=native
+
+$(BENCH) : $(BENCH_SOURCES) $(CORDIC_HEADER) $(TWIDDLE_HEADER) $(ZIGGURAT_HEADER)
+	@echo "+ CC    $<"
+	@mkdir -p $(dir $@)
+	@$(CC) $(BENCH_CFLAGS) $(CFLAGS) $(BENCH_SOURCES) $(LDLIBS) -o $@
+
+# accuracy sweep against libm, on all cores
+SWEEP_SOURCES := $(TOOLS_SRC_DIR)/sweep/sweep.c $(SOURCE_DIR)/math/fpa.c
+
+$(SWEEP) : $(SWEEP_SOURCES) $(CORDIC_HEADER)
+	@echo "+ CC    $<"
+	@mkdir -p $(dir $@)
+	@$(CC) -O2 $(CFLAGS) $(SWEEP_SOURCES) $(LDLIBS) -lpthread -o $@
+
+# filter coefficients for filter.h
+$(FILTER_DESIGN) : $(TOOLS_SRC_DIR)/filter_design/filter_design.c
+	@echo "+ CC    $<"
+	@mkdir -p $(dir $@)
+	@$(CC) $(CFLAGS) $< $(LDLIBS) -o $@
@@ -65,7 +65,10 @@ static const uint16_t modbus_crc_table[256] = {
         (crc) ^= modbus_crc_table[xor_val];        \
     } while (0U)
 
-static inline uint16_t modbus_crc_calc(uint8_t *pdata, uint32_t size)
+/// big endian 16bit field of a frame
+#define MODBUS_GET_U16(p) (((uint32_t)(p)[0] << 8) | (p)[1])
+
+static inline uint16_t modbus_crc_calc(const uint8_t *pdata, uint32_t size)
 {
     uint16_t crc = 0xFFFF;
     for (int i = 0; i < size; i++)
@@ -76,44 +79,266 @@ static inline uint16_t modbus_crc_calc(uint8_t *pdata, uint32_t size)
     return crc;
 }
 
-void modbus_slave_recv_cplt_handler(modbus_slave_t *slave)
+/**
+ * @brief sift `regs[root]` down the max heap of the first `cnt` entries,
+ * keyed on the start address.
+ */
+static void modbus_reg_sift(modbus_reg_desc_t *regs, uint32_t root, uint32_t cnt)
 {
-    uint32_t recv_cnt = slave->rx_cnt;
-    uint8_t *recv_buf = slave->recv_buf;
+    modbus_reg_desc_t key = regs[root];
+    for (uint32_t child; (child = 2 * root + 1) < cnt; root = child)
+    {
+        if (child + 1 < cnt && regs[child + 1].reg_start_addr > regs[child].reg_start_addr)
+            child++;
+        if (regs[child].reg_start_addr <= key.reg_start_addr)
+            break;
+        regs[root] = regs[child];
+    }
+    regs[root] = key;
+}
 
-    uint16_t crc = slave->crc;
+/**
+ * @brief sort a register map by start address, heap sort so a map of
+ * thousands of ranges sorts in place in O(n log n) without allocating,
+ * then check that no range is empty, runs past 0xFFFF or overlaps the
+ * next one.
+ */
+static error_t modbus_reg_sort(modbus_reg_desc_t *regs, uint32_t cnt)
+{
+    for (uint32_t i = cnt / 2; i-- > 0;)
+        modbus_reg_sift(regs, i, cnt);
+    for (uint32_t i = cnt; i-- > 1;)
+    {
+        modbus_reg_desc_t top = regs[0];
+        regs[0] = regs[i];
+        regs[i] = top;
+        modbus_reg_sift(regs, 0, i);
+    }
 
-    uint16_t recv_crc = (recv_buf[recv_cnt - 1] << 8) | recv_buf[recv_cnt - 2];
+    for (uint32_t i = 0; i < cnt; i++)
+    {
+        uint32_t end = regs[i].reg_start_addr + regs[i].reg_map_len;
+        if (regs[i].reg_map_len == 0 || end > 0x10000)
+            return E_INVALID_ARGUMENT;
+        if (i + 1 < cnt && end > regs[i + 1].reg_start_addr)
+            return E_INVALID_ARGUMENT;
+    }
+    return ALL_OK;
+}
 
-    if (recv_crc != crc)
+/**
+ * @brief find the ranges of `qty` registers from `addr`
+ * @param idx_out index of the range holding `addr`, the others follow it
+ * @param write the ranges need a write handler instead of a read handler
+ * @return MODBUS_ERR_NONE or MODBUS_ERR_ILLEGAL_DATA_ADDRESS
+ */
+static uint8_t modbus_reg_lookup(const modbus_reg_desc_t *regs, uint32_t cnt, uint32_t addr, uint32_t qty,
+                                 int write, uint32_t *idx_out)
+{
+    // last range starting at or below addr
+    uint32_t lo = 0, hi = cnt;
+    while (lo < hi)
     {
-        slave->rx_state = RX_STATE_IDLE;
-        return;
+        uint32_t mid = (lo + hi) / 2;
+        if (regs[mid].reg_start_addr <= addr)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo == 0)
+        return MODBUS_ERR_ILLEGAL_DATA_ADDRESS;
+
+    *idx_out = lo - 1;
+    for (uint32_t i = lo - 1; i < cnt; i++)
+    {
+        const modbus_reg_desc_t *reg = &regs[i];
+        int handled = write ? reg->write_handler != NULL : reg->read_handler != NULL;
+        if (reg->reg_start_addr > addr || !handled)
+            break;
+
+        uint32_t end = reg->reg_start_addr + reg->reg_map_len;
+        if (addr + qty <= end)
+            return MODBUS_ERR_NONE;
+        if (addr >= end)
+            break;
+        qty -= end - addr;
+        addr = end;
     }
+    return MODBUS_ERR_ILLEGAL_DATA_ADDRESS;
+}
+
+/// the exception code of a failed handler call
+static inline uint8_t modbus_handler_error(uint8_t error_code)
+{
+    return error_code != MODBUS_ERR_NONE ? error_code : MODBUS_ERR_SLAVE_DEVICE_FAILURE;
+}
 
-    uint32_t func = recv_buf[1];
-    uint32_t tx_total = 0;
+/**
+ * @brief read `qty` registers from `addr` into `out`, high byte first
+ * @return MODBUS_ERR_NONE or the exception code
+ */
+static uint8_t modbus_reg_read(const modbus_reg_desc_t *regs, uint32_t cnt, uint32_t addr, uint32_t qty,
+                               uint8_t *out)
+{
+    uint32_t idx;
+    uint8_t code = modbus_reg_lookup(regs, cnt, addr, qty, 0, &idx);
+    if (code != MODBUS_ERR_NONE)
+        return code;
+
+    for (; qty; idx++)
+    {
+        const modbus_reg_desc_t *reg = &regs[idx];
+        uint32_t offset = addr - reg->reg_start_addr;
+        uint32_t size = reg->reg_map_len - offset;
+        if (size > qty)
+            size = qty;
+
+        if (reg->read_handler(offset, size, out, &code) != ALL_OK)
+            return modbus_handler_error(code);
+        out += 2 * size;
+        addr += size;
+        qty -= size;
+    }
+    return MODBUS_ERR_NONE;
+}
+
+/**
+ * @brief write `qty` registers from `addr`, the values are high byte first
+ * @return MODBUS_ERR_NONE or the exception code
+ */
+static uint8_t modbus_reg_write(const modbus_reg_desc_t *regs, uint32_t cnt, uint32_t addr, uint32_t qty,
+                                const uint8_t *values)
+{
+    uint32_t idx;
+    uint8_t code = modbus_reg_lookup(regs, cnt, addr, qty, 1, &idx);
+    if (code != MODBUS_ERR_NONE)
+        return code;
+
+    for (uint32_t i = 0; i < qty; i++, addr++)
+    {
+        if (addr >= regs[idx].reg_start_addr + regs[idx].reg_map_len)
+            idx++;
+
+        uint32_t value = MODBUS_GET_U16(&values[2 * i]);
+        if (regs[idx].write_handler(addr - regs[idx].reg_start_addr, value, &code) != ALL_OK)
+            return modbus_handler_error(code);
+    }
+    return MODBUS_ERR_NONE;
+}
+
+/**
+ * @brief process the request in `req` and build the response in send_buf
+ * @param recv_cnt size of the request, with address and CRC
+ * @return size of the response PDU
+ */
+static uint32_t modbus_slave_process(modbus_slave_t *slave, const uint8_t *req, uint32_t recv_cnt)
+{
+    const modbus_slave_init_t *desc = slave->desc;
+    uint8_t *resp = slave->send_buf;
+
+    // address and quantity are only read once the length is checked
+    uint32_t func = req[1];
+    uint32_t addr, qty;
+    uint8_t code = MODBUS_ERR_NONE;
+
+    resp[1] = func;
 
     switch (func)
     {
-    default:
+    case MODBUS_FN_READ_HOLDING_REGISTERS:
+    case MODBUS_FN_READ_INPUT_REGISTERS:
     {
-        slave->send_buf[0] = slave->slave_addr;
-        slave->send_buf[1] = func | 0x80;
-        slave->send_buf[2] = MODBUS_ERR_ILLEGAL_FUNCTION;
-        uint16_t tx_crc = modbus_crc_calc(slave->send_buf, 3);
-        slave->send_buf[3] = tx_crc & 0xFF;
-        slave->send_buf[4] = tx_crc >> 8;
-        tx_total = 5;
+        int holding = func == MODBUS_FN_READ_HOLDING_REGISTERS;
+        if (recv_cnt != 8)
+        {
+            code = MODBUS_ERR_ILLEGAL_DATA_VALUE;
+            break;
+        }
+        addr = MODBUS_GET_U16(&req[2]);
+        qty = MODBUS_GET_U16(&req[4]);
+        if (qty == 0 || qty > MODBUS_READ_REGS_MAX)
+        {
+            code = MODBUS_ERR_ILLEGAL_DATA_VALUE;
+            break;
+        }
+        code = modbus_reg_read(holding ? desc->holding_regs : desc->input_regs,
+                               holding ? desc->holding_reg_cnt : desc->input_reg_cnt, addr, qty, &resp[3]);
+        resp[2] = 2 * qty;
+        if (code == MODBUS_ERR_NONE)
+            return 2 + 2 * qty;
     }
     break;
+
+    case MODBUS_FN_WRITE_SINGLE_REGISTER:
+        if (recv_cnt != 8)
+        {
+            code = MODBUS_ERR_ILLEGAL_DATA_VALUE;
+            break;
+        }
+        addr = MODBUS_GET_U16(&req[2]);
+        code = modbus_reg_write(desc->holding_regs, desc->holding_reg_cnt, addr, 1, &req[4]);
+        if (code == MODBUS_ERR_NONE)
+        {
+            // the response echoes the request
+            memcpy(&resp[2], &req[2], 4);
+            return 5;
+        }
+        break;
+
+    case MODBUS_FN_WRITE_MULTIPLE_REGISTERS:
+        if (recv_cnt < 9)
+        {
+            code = MODBUS_ERR_ILLEGAL_DATA_VALUE;
+            break;
+        }
+        addr = MODBUS_GET_U16(&req[2]);
+        qty = MODBUS_GET_U16(&req[4]);
+        if (qty == 0 || qty > MODBUS_WRITE_REGS_MAX || req[6] != 2 * qty || recv_cnt != 9 + 2 * qty)
+        {
+            code = MODBUS_ERR_ILLEGAL_DATA_VALUE;
+            break;
+        }
+        code = modbus_reg_write(desc->holding_regs, desc->holding_reg_cnt, addr, qty, &req[7]);
+        if (code == MODBUS_ERR_NONE)
+        {
+            memcpy(&resp[2], &req[2], 4);
+            return 5;
+        }
+        break;
+
+    default:
+        code = MODBUS_ERR_ILLEGAL_FUNCTION;
+        break;
     }
 
-    slave->rx_cnt = 0;
+    resp[1] = func | 0x80;
+    resp[2] = code;
+    return 2;
+}
+
+/**
+ * @brief answer a request with a good CRC that is addressed to this slave
+ * or broadcast
+ * @param req the request, with address and CRC, not modified
+ * @param size size of the request
+ */
+static void modbus_slave_handle(modbus_slave_t *slave, const uint8_t *req, uint32_t size)
+{
+    // a broadcast may only write, it is executed but never answered
+    int broadcast = req[0] == 0;
+    if (broadcast && req[1] != MODBUS_FN_WRITE_SINGLE_REGISTER && req[1] != MODBUS_FN_WRITE_MULTIPLE_REGISTERS)
+        return;
+
+    slave->send_buf[0] = slave->slave_addr;
+    uint32_t tx_total = 1 + modbus_slave_process(slave, req, size);
+    uint16_t tx_crc = modbus_crc_calc(slave->send_buf, tx_total);
+    slave->send_buf[tx_total++] = tx_crc & 0xFF;
+    slave->send_buf[tx_total++] = tx_crc >> 8;
 
-    if (tx_total == 0)
+    if (broadcast)
         return;
 
+    slave->tx_cnt = 0;
     error_t result = slave->desc->request_pdu_transmit(tx_total, slave->send_buf);
     if (result == ALL_OK)
     {
@@ -126,6 +351,67 @@ void modbus_slave_recv_cplt_handler(modbus_slave_t *slave)
     }
 }
 
+void modbus_slave_recv_cplt_handler(modbus_slave_t *slave)
+{
+    uint32_t recv_cnt = slave->rx_cnt;
+    uint8_t *recv_buf = slave->recv_buf;
+
+    uint16_t crc = slave->crc;
+
+    // address, function and CRC at least
+    if (recv_cnt < 4)
+    {
+        slave->rx_state = RX_STATE_IDLE;
+        return;
+    }
+
+    uint16_t recv_crc = (recv_buf[recv_cnt - 1] << 8) | recv_buf[recv_cnt - 2];
+
+    if (recv_crc != crc)
+    {
+        slave->rx_state = RX_STATE_IDLE;
+        return;
+    }
+
+    slave->rx_cnt = 0;
+    modbus_slave_handle(slave, recv_buf, recv_cnt);
+}
+
+error_t modbus_slave_recv_frame(modbus_slave_t *slave, const uint8_t *frame, uint32_t size)
+{
+    if (slave == NULL || frame == NULL || size < 4 || size > MODBUS_ADU_MAX)
+        return E_INVALID_ARGUMENT;
+
+    // another slave on the bus
+    if (frame[0] != 0 && frame[0] != slave->slave_addr)
+        return ALL_OK;
+
+    // the CRC over a frame with its own CRC appended is 0
+    if (modbus_crc_calc(frame, size) != 0)
+        return E_INVALID_ARGUMENT;
+
+    modbus_slave_handle(slave, frame, size);
+    return ALL_OK;
+}
+
+error_t modbus_slave_recv_ring(modbus_slave_t *slave, const uint8_t *ring, uint32_t ring_size, uint32_t start,
+                               uint32_t size)
+{
+    if (slave == NULL || ring == NULL || start >= ring_size || size > ring_size)
+        return E_INVALID_ARGUMENT;
+
+    if (start + size <= ring_size)
+        return modbus_slave_recv_frame(slave, ring + start, size);
+
+    // the frame wraps around the end of the ring, join its two parts
+    if (size > sizeof(slave->recv_buf))
+        return E_INVALID_ARGUMENT;
+    uint32_t first = ring_size - start;
+    memcpy(slave->recv_buf, ring + start, first);
+    memcpy(slave->recv_buf + first, ring, size - first);
+    return modbus_slave_recv_frame(slave, slave->recv_buf, size);
+}
+
 uint32_t modbus_slave_send_get_data(modbus_slave_t *slave, uint8_t *data_out)
 {
     if (slave->tx_total == 0)
@@ -144,6 +430,22 @@ uint32_t modbus_slave_send_get_data(modbus_slave_t *slave, uint8_t *data_out)
     return MODBUS_SEND_NORMAL;
 }
 
+error_t modbus_slave_send_frame(const modbus_slave_t *slave, const uint8_t **frame_out, uint32_t *size_out)
+{
+    if (slave->tx_total == 0)
+        return E_INVALID_OPERATION;
+
+    *frame_out = slave->send_buf;
+    *size_out = slave->tx_total;
+    return ALL_OK;
+}
+
+void modbus_slave_send_cplt_handler(modbus_slave_t *slave)
+{
+    slave->tx_cnt = 0;
+    slave->tx_total = 0;
+}
+
 void modbus_slave_recv_handler(modbus_slave_t *slave, uint32_t byte, uint32_t state)
 {
     switch (state)
@@ -155,7 +457,6 @@ void modbus_slave_recv_handler(modbus_slave_t *slave, uint32_t byte, uint32_t st
             // 0: broadcast check if this packet need to be processed
             if (byte == 0 || byte == slave->slave_addr)
             {
-                memset(slave->recv_buf, 0, sizeof(slave->recv_buf));
                 slave->recv_buf[0] = byte;
                 slave->rx_cnt = 1;
                 slave->rx_state = RX_STATE_IN_PROGRESS;
@@ -169,6 +470,13 @@ void modbus_slave_recv_handler(modbus_slave_t *slave, uint32_t byte, uint32_t st
         }
         else if (slave->rx_state == RX_STATE_IN_PROGRESS)
         {
+            if (slave->rx_cnt >= sizeof(slave->recv_buf))
+            {
+                // can't process this packet, ignore it
+                slave->rx_state = RX_STATE_OVERFLOW;
+                goto clear_slave_recv_buf;
+            }
+
             slave->recv_buf[slave->rx_cnt] = byte;
 
             int32_t crc_off = slave->rx_cnt - 2;
@@ -178,13 +486,6 @@ void modbus_slave_recv_handler(modbus_slave_t *slave, uint32_t byte, uint32_t st
                 slave->crc = 0xFFFF;
 
             slave->rx_cnt++;
-
-            if (slave->rx_cnt >= sizeof(slave->recv_buf))
-            {
-                // can't process this packet, ignore it
-                slave->rx_state = RX_STATE_OVERFLOW;
-                goto clear_slave_recv_buf;
-            }
         }
         break;
     case MODBUS_RECV_ERROR:
@@ -210,8 +511,8 @@ void modbus_slave_recv_handler(modbus_slave_t *slave, uint32_t byte, uint32_t st
     return;
 
 clear_slave_recv_buf:
+    // only the first rx_cnt bytes of recv_buf are ever read
     slave->rx_cnt = 0;
-    memset(slave->recv_buf, 0, sizeof(slave->recv_buf));
     slave->crc = 0xFFFF;
     return;
 }
@@ -227,6 +528,11 @@ error_t modbus_slave_init(modbus_slave_t *slave, const modbus_slave_init_t *desc
 
     if (desc->request_pdu_transmit == NULL)
         return E_INVALID_ARGUMENT;
+    if (modbus_reg_sort(desc->holding_regs, desc->holding_reg_cnt) != ALL_OK)
+        return E_INVALID_ARGUMENT;
+    if (modbus_reg_sort(desc->input_regs, desc->input_reg_cnt) != ALL_OK)
+        return E_INVALID_ARGUMENT;
+
     memset(slave, 0, sizeof(modbus_slave_t));
     slave->desc = desc;
     slave->slave_addr = slave_addr;
@@ -9,14 +9,43 @@
  *
  */
 
+#ifndef __MODBUS_H__
+#define __MODBUS_H__
+
 #include <stdint.h>
 #include <libe15-errors.h>
 
+/// largest RTU frame, address + PDU + CRC
+#define MODBUS_ADU_MAX 256
+
+/// registers of one 0x03 / 0x04 read
+#define MODBUS_READ_REGS_MAX 125
+
+/// registers of one 0x10 write
+#define MODBUS_WRITE_REGS_MAX 123
+
+/**
+ * @brief A range of registers served by one pair of handlers.
+ *
+ * @note the handlers return ALL_OK on success. on failure they may set
+ * `*error_code_out` to a MODBUS_ERR_ exception code, it is
+ * MODBUS_ERR_SLAVE_DEVICE_FAILURE otherwise.
+ */
 typedef struct
 {
     uint16_t reg_start_addr;
     uint32_t reg_map_len;
+
+    /**
+     * @brief read `size` registers from `offset` of this range
+     * @param data 2 * size bytes, each register high byte first as sent
+     */
     error_t (*read_handler)(uint32_t offset, uint32_t size, uint8_t *data, uint8_t *error_code_out);
+
+    /**
+     * @brief write one register, `data` is its 16bit value. a 0x10
+     * request calls this once per register, in address order.
+     */
     error_t (*write_handler)(uint32_t offset, uint32_t data, uint8_t *error_code_out);
     void *usr_ptr;
 } modbus_reg_desc_t;
@@ -159,13 +188,19 @@ enum
     MODBUS_FN_ENCAPSULATED_INTERFACE_TRANSPORT = 0x2B,
 };
 
+/**
+ * @note `modbus_slave_init` sorts `input_regs` and `holding_regs` by address
+ * in place, once, and a request finds its range with a binary search. the
+ * ranges of one array must not overlap. a request may span ranges that
+ * follow each other without a gap.
+ */
 typedef struct
 {
     modbus_reg_desc_t *input_regs;
-    uint8_t input_reg_cnt;
+    uint16_t input_reg_cnt;
 
     modbus_reg_desc_t *holding_regs;
-    uint8_t holding_reg_cnt;
+    uint16_t holding_reg_cnt;
 
     /**
      * @brief This is a callback function to setup a Protocal Data Unit (PDU) transmit
@@ -173,14 +208,16 @@ typedef struct
      * @param pdata the pointer to the PDU
      * @return error code 0 for success, < 0 failed, > 0 no more action need.
      * @note User should implement this function to setup the system for transmitting the PDU.
-     * If the user intends to use IRQ to transmit the PDU, the user should call
-     * `modbus_slave_send_get_data` function in the IRQ handler to get the data. in this function
-     * user should only prepare the hardware. In this case, the return value of this function should
-     * be 0 (ALL_OK), ** and this is the intended behavior **.
+     * `pdata` is the whole ADU, address to CRC, and stays valid until the transmit completes.
      *
-     * If the user intends to use DMA to transmit the PDU, after setting up the DMA in this callback,
-     * the user should call `modbus_slave_send_get_data` with flag `MODBUS_SEND_CPLT` to notify
-     * the modbus driver.
+     * If the user intends to use DMA to transmit the PDU, start one transfer of `size` bytes
+     * from `pdata` here, or later from `modbus_slave_send_frame`, and call
+     * `modbus_slave_send_cplt_handler` when it completes. the return value of this function
+     * should be 0 (ALL_OK), ** and this is the intended behavior **.
+     *
+     * If the user intends to use IRQ to transmit the PDU, the user should call
+     * `modbus_slave_send_get_data` function in the IRQ handler to get the data byte by byte,
+     * this function should only prepare the hardware and return 0 (ALL_OK).
      *
      * If the user sent the PDU within this callback, the return value of this function
      * should be greater than 0.
@@ -192,11 +229,11 @@ typedef struct
 {
     const modbus_slave_init_t *desc;
 
-    uint8_t recv_buf[32];
-    uint8_t send_buf[32];
-    uint8_t tx_cnt;
-    uint8_t tx_total;
-    uint8_t rx_cnt;
+    uint8_t recv_buf[MODBUS_ADU_MAX];
+    uint8_t send_buf[MODBUS_ADU_MAX];
+    uint16_t tx_cnt;
+    uint16_t tx_total;
+    uint16_t rx_cnt;
 
     uint8_t slave_addr;
 
@@ -229,8 +266,76 @@ enum
  */
 void modbus_slave_recv_handler(modbus_slave_t *slave, uint32_t byte, uint32_t state);
 
+/**
+ * @brief Initialize a modbus slave.
+ * @param slave the modbus slave instance
+ * @param desc register map and transmit callback, kept by pointer
+ * @param slave_addr the address of this slave
+ * @return E_INVALID_ARGUMENT if a pointer is missing, a range is empty or
+ * beyond address 0xFFFF, or two ranges overlap.
+ * @note the register arrays of `desc` are sorted by address here.
+ */
 error_t modbus_slave_init(modbus_slave_t *slave, const modbus_slave_init_t *desc, uint8_t slave_addr);
 
+/**
+ * @brief Process one whole received frame, e.g. a DMA buffer at the UART
+ * idle line interrupt, instead of calling `modbus_slave_recv_handler` for
+ * every byte.
+ * @param slave the modbus slave instance
+ * @param frame the frame, address to CRC. it is parsed in place and not
+ * kept after the call.
+ * @param size size of the frame in bytes
+ * @return ALL_OK if the frame was answered or is for another slave,
+ * E_INVALID_ARGUMENT if it is too short, too long or fails the CRC.
+ * @note the CRC is checked over the whole frame at once, the response
+ * goes out through `request_pdu_transmit` as with the byte handler.
+ */
+error_t modbus_slave_recv_frame(modbus_slave_t *slave, const uint8_t *frame, uint32_t size);
+
+/**
+ * @brief `modbus_slave_recv_frame` for a frame in a circular DMA buffer.
+ * @param slave the modbus slave instance
+ * @param ring the circular buffer
+ * @param ring_size size of the circular buffer
+ * @param start index of the first byte of the frame
+ * @param size size of the frame in bytes
+ * @return same as `modbus_slave_recv_frame`
+ * @note a frame is parsed in place unless it wraps around the end of the
+ * buffer, then it is copied to `recv_buf` first. do not mix this with
+ * `modbus_slave_recv_handler` on one slave.
+ */
+error_t modbus_slave_recv_ring(modbus_slave_t *slave, const uint8_t *ring, uint32_t ring_size, uint32_t start,
+                               uint32_t size);
+
 error_t modbus_slave_set_addr(modbus_slave_t *slave, uint8_t slave_addr);
 
+/**
+ * @brief Get the next byte of the response, for a transmit interrupt.
+ * @param slave the modbus slave instance
+ * @param data_out the byte to send
+ * @return MODBUS_SEND_NORMAL if `data_out` was written, MODBUS_SEND_CPLT if
+ * the whole response has been handed out.
+ */
 uint32_t modbus_slave_send_get_data(modbus_slave_t *slave, uint8_t *data_out);
+
+/**
+ * @brief Get the whole response for one DMA transfer.
+ * @param slave the modbus slave instance
+ * @param frame_out the response, address to CRC, valid until
+ * `modbus_slave_send_cplt_handler`
+ * @param size_out size of the response in bytes
+ * @return ALL_OK, or E_INVALID_OPERATION if no response is waiting.
+ * @note the same buffer and size are passed to `request_pdu_transmit`,
+ * this is for starting the transfer later, e.g. after the RS485 driver
+ * turnaround.
+ */
+error_t modbus_slave_send_frame(const modbus_slave_t *slave, const uint8_t **frame_out, uint32_t *size_out);
+
+/**
+ * @brief Notify the slave that the response has been sent, call it from
+ * the DMA or UART transmit complete interrupt.
+ * @param slave the modbus slave instance
+ */
+void modbus_slave_send_cplt_handler(modbus_slave_t *slave);
+
+#endif //! #ifndef __MODBUS_H__
@@ -0,0 +1,40 @@
+/**
+ * @file angle.c
+ * @author simakeng (simakeng@outlook.com)
+ * @brief Binary angles and encoder count to electrical angle scaling
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stddef.h>
+
+#include "angle.h"
+
+/******************************************************************************/
+/*                         PUBLIC FUNCTION DEFINITIONS                        */
+/******************************************************************************/
+
+error_t angle_encoder_init(angle_encoder_t *enc, uint32_t counts_per_turn, uint32_t pole_pairs)
+{
+    if (enc == NULL || counts_per_turn == 0 || pole_pairs == 0)
+        return E_INVALID_ARGUMENT;
+
+    // 2^64 = q * counts_per_turn + r
+    uint64_t q = UINT64_MAX / counts_per_turn;
+    uint64_t r = UINT64_MAX % counts_per_turn + 1;
+    if (r == counts_per_turn)
+    {
+        q++;
+        r = 0;
+    }
+
+    // pole_pairs * 2^64 / counts_per_turn rounded to nearest, mod 2^64,
+    // r * pole_pairs < 2^64 as both are below 2^32
+    enc->step = q * pole_pairs + (r * pole_pairs + counts_per_turn / 2) / counts_per_turn;
+    enc->offset = 0;
+    return ALL_OK;
+}
+
@@ -0,0 +1,174 @@
+/**
+ * @file angle.h
+ * @author simakeng (simakeng@outlook.com)
+ * @brief Binary angles and encoder count to electrical angle scaling
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * *****************************************************************************
+ * @copyright Copyright (C) E15 Studio 2024
+ *
+ * This program is FREE software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation.
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 675 Mass Ave, Cambridge, MA 02139, USA. Or you can visit the link below to
+ * read the license online, or you can find a copy of the license in the root
+ * directory of this project named "LICENSE" file.
+ *
+ * https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * *****************************************************************************
+ *
+ *
+ * @example
+ *  // 4096 counts per turn, 50 pole pairs
+ *  angle_encoder_t enc;
+ *  angle_encoder_init(&enc, 4096, 50);
+ *  enc.offset = aligned_angle; // electrical angle read at count 0
+ *
+ *  // current loop interrupt
+ *  angle_t theta = angle_encoder_electrical(&enc, TIM2->CNT);
+ *  fixed_t s, c;
+ *  angle_sincos(theta, &s, &c);
+ *
+ * angles are binary angles (BAM), a uint32_t where 2^32 is one turn. the
+ * integer wrap around is the `mod 2π`, and the top N bits index a table
+ * of 2^N entries per turn with a shift, see angle_index().
+ *
+ * the pole pair count and the encoder resolution are folded into one
+ * Q32.32 step at init, so a count turns into an electrical angle with
+ * one 32 x 64 multiply (UMULL + MLA on Cortex-M) and no division. the
+ * step is rounded to 2^-64 turn, so the error stays below 1 / 4 LSB of
+ * the angle for any int32_t count, also for counts of many turns.
+ */
+
+/******************************************************************************/
+/*                               INCLUDE FILES                                */
+/******************************************************************************/
+
+#include <stdint.h>
+
+#include <libe15-errors.h>
+#include <libe15-fpa.h>
+
+/******************************************************************************/
+/*                              MACRO DEFINITIONS                             */
+/******************************************************************************/
+
+#ifndef __ANGLE_H__
+#define __ANGLE_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// a quarter turn, 90 degrees
+#define ANGLE_QUARTER ((angle_t)0x40000000u)
+
+/// half a turn, 180 degrees
+#define ANGLE_HALF ((angle_t)0x80000000u)
+
+/// angle of a constant in degrees, e.g. ANGLE_DEG(-30)
+#define ANGLE_DEG(d) ((angle_t)(int64_t)((d) * (4294967296.0l / 360.0l) + ((d) < 0 ? -0.5l : 0.5l)))
+
+/******************************************************************************/
+/*                              TYPE DEFINITIONS                              */
+/******************************************************************************/
+
+/// binary angle, 2^32 per turn
+typedef uint32_t angle_t;
+
+/// encoder count to electrical angle scaling
+typedef struct
+{
+    uint64_t step;  ///< electrical angle per count, Q32.32
+    angle_t offset; ///< electrical angle at count 0
+} angle_encoder_t;
+
+/******************************************************************************/
+/*                        PUBLIC FUNCTION DEFINITIONS                         */
+/******************************************************************************/
+
+/**
+ * @brief binary angle of a radian value, wraps to one turn
+ * @param rad angle in radian
+ * @return angle_t
+ */
+static inline angle_t angle_from_fixed(fixed_t rad)
+{
+    return (angle_t)fixed_to_bam(rad);
+}
+
+/**
+ * @brief radian value of a binary angle
+ * @param a angle
+ * @return fixed_t angle in [-π, π)
+ */
+static inline fixed_t angle_to_fixed(angle_t a)
+{
+    return (fixed_t){(fixed_value_t)(((int64_t)(int32_t)a * FIXED_2PI.val) >> 32)};
+}
+
+/**
+ * @brief index of an angle into a table of 2^bits entries per turn
+ * @param a angle
+ * @param bits log2 of the table size, 1 to 32
+ * @return uint32_t the entry at or below the angle
+ */
+static inline uint32_t angle_index(angle_t a, unsigned bits)
+{
+    return a >> (32 - bits);
+}
+
+/**
+ * @brief sin and cos of a binary angle
+ * @note see fixed_sincos_bam()
+ */
+static inline void angle_sincos(angle_t a, fixed_t *sin_out, fixed_t *cos_out)
+{
+    fixed_sincos_bam(a, sin_out, cos_out);
+}
+
+/**
+ * @brief electrical angle of an encoder count
+ * @param enc the scaling from angle_encoder_init()
+ * @param count encoder count, any number of turns, also negative
+ * @return angle_t electrical angle, offset included
+ */
+static inline angle_t angle_encoder_electrical(const angle_encoder_t *enc, int32_t count)
+{
+    // the integer turns fall out of the top of the 64bit product
+    return (angle_t)(((uint64_t)(int64_t)count * enc->step) >> 32) + enc->offset;
+}
+
+/******************************************************************************/
+/*                        PUBLIC FUNCTION DECLARATIONS                        */
+/******************************************************************************/
+
+/**
+ * @brief compute the count to electrical angle step, offset set to 0
+ * @note the only division of the angle path is here.
+ * @param enc the scaling
+ * @param counts_per_turn encoder counts per mechanical turn
+ * @param pole_pairs electrical turns per mechanical turn, 1 for the
+ *        mechanical angle
+ * @return error_t E_INVALID_ARGUMENT if enc is NULL or a count is 0
+ */
+error_t angle_encoder_init(angle_encoder_t *enc, uint32_t counts_per_turn, uint32_t pole_pairs);
+
+#ifdef __cplusplus
+}
+#endif
+
+/******************************************************************************/
+/*                                 END OF FILE                                */
+/******************************************************************************/
+
+#endif //! #ifndef __ANGLE_H__
@@ -0,0 +1,352 @@
+/**
+ * @file fft.c
+ * @author simakeng (simakeng@outlook.com)
+ * @brief Block scaled fixed point FFT
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * iterative decimation in time on bit reversed input. two radix-2 stages
+ * are fused into one radix-4 pass (radix 2^2): the four values of a
+ * group are loaded once, both stages run on 32bit registers and only the
+ * result is rounded back to Q15. a size with an odd log2 starts with one
+ * radix-2 pass.
+ */
+
+#include <stddef.h>
+
+#include "fft.h"
+#include <generated-conf.h>
+#include <fft_twiddle.h>
+
+/**
+ * largest input magnitude (Q15 LSB) each pass takes without overflow.
+ * a radix-2 butterfly grows a component by at most 1 + √2, plus 1 LSB
+ * of rounding, two fused stages by (1 + √2)^2, and the real split
+ * pass adds two values before the butterfly, 2 + 2√2.
+ */
+#define FFT_LIMIT_RADIX2 13570
+#define FFT_LIMIT_RADIX4 5600
+#define FFT_LIMIT_SPLIT 6780
+
+/******************************************************************************/
+/*                        PRIVATE FUNCTION DEFINITIONS                        */
+/******************************************************************************/
+
+static uint32_t fft_log2(uint32_t n)
+{
+    uint32_t bits = 0;
+    while ((1u << bits) < n)
+        bits++;
+    return bits;
+}
+
+static int fft_size_valid(uint32_t n, uint32_t min)
+{
+    return n >= min && n <= FFT_MAX_POINTS && (n & (n - 1)) == 0;
+}
+
+static inline int32_t fft_abs(int32_t v)
+{
+    return v < 0 ? -v : v;
+}
+
+/// round to nearest, s may be 0
+static inline int32_t fft_shift(int32_t v, int32_t s)
+{
+    return (v + ((1 << s) >> 1)) >> s;
+}
+
+/// (a * w) >> 15, rounded, w is a Q15 twiddle, conjugated if `inverse`
+static inline void fft_cmul(int32_t ar, int32_t ai, const int16_t *w, int inverse,
+                            int32_t *pr, int32_t *pi)
+{
+    int32_t wr = w[0];
+    int32_t wi = inverse ? -w[1] : w[1];
+    *pr = (ar * wr - ai * wi + 0x4000) >> 15;
+    *pi = (ar * wi + ai * wr + 0x4000) >> 15;
+}
+
+static inline int32_t fft_store(fft_complex_q15_t *p, int32_t re, int32_t im, int32_t peak)
+{
+    p->re = (int16_t)re;
+    p->im = (int16_t)im;
+    re = fft_abs(re);
+    im = fft_abs(im);
+    peak = re > peak ? re : peak;
+    return im > peak ? im : peak;
+}
+
+static int32_t fft_peak(const fft_complex_q15_t *data, uint32_t n)
+{
+    int32_t peak = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        int32_t re = fft_abs(data[i].re);
+        int32_t im = fft_abs(data[i].im);
+        peak = re > peak ? re : peak;
+        peak = im > peak ? im : peak;
+    }
+    return peak;
+}
+
+/// smallest right shift that takes `peak` below `limit`
+static int32_t fft_shift_for(int32_t peak, int32_t limit)
+{
+    int32_t s = 0;
+    while ((peak >> s) + 1 > limit)
+        s++;
+    return s;
+}
+
+/**
+ * @brief fft_shift_for() of the first pass. data far below `limit` is
+ *        scaled up in place instead, so a small signal gets the full word
+ *        and rounding in the passes costs it no more than a large one.
+ */
+static int32_t fft_normalize(fft_complex_q15_t *data, uint32_t n, int32_t limit, int32_t *exponent)
+{
+    int32_t peak = fft_peak(data, n);
+    int32_t up = 0;
+
+    while (peak > 0 && (peak << (up + 1)) < limit)
+        up++;
+
+    if (up == 0)
+    {
+        int32_t s = fft_shift_for(peak, limit);
+        *exponent += s;
+        return s;
+    }
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        data[i].re = (int16_t)(data[i].re * (1 << up));
+        data[i].im = (int16_t)(data[i].im * (1 << up));
+    }
+    *exponent -= up;
+    return 0;
+}
+
+static void fft_bit_reverse_permute(fft_complex_q15_t *data, uint32_t n, uint32_t bits)
+{
+    uint32_t drop = FFT_MAX_POINTS_LOG2 - bits;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t r = fft_bit_reverse[i] >> drop;
+        if (i < r)
+        {
+            fft_complex_q15_t t = data[i];
+            data[i] = data[r];
+            data[r] = t;
+        }
+    }
+}
+
+/**
+ * radix-2 stage, pairs m apart in groups of 2m
+ * @return int32_t the peak of the output
+ */
+static int32_t fft_pass_radix2(fft_complex_q15_t *data, uint32_t n, uint32_t m, int32_t s, int inverse)
+{
+    uint32_t stride = FFT_MAX_POINTS / (2 * m);
+    int32_t peak = 0;
+
+    for (uint32_t g = 0; g < n; g += 2 * m)
+    {
+        for (uint32_t k = 0; k < m; k++)
+        {
+            fft_complex_q15_t *pa = &data[g + k];
+            fft_complex_q15_t *pb = pa + m;
+            int32_t ar = fft_shift(pa->re, s), ai = fft_shift(pa->im, s);
+            int32_t tr, ti;
+            fft_cmul(fft_shift(pb->re, s), fft_shift(pb->im, s), fft_twiddle_q15[k * stride], inverse, &tr, &ti);
+
+            peak = fft_store(pa, ar + tr, ai + ti, peak);
+            peak = fft_store(pb, ar - tr, ai - ti, peak);
+        }
+    }
+    return peak;
+}
+
+/**
+ * two radix-2 stages, spans m and 2m, in groups of 4m. the second stage
+ * twiddle of the odd pair is W(4m)^(k + m) = W(4m)^k * (-i).
+ * @return int32_t the peak of the output
+ */
+static int32_t fft_pass_radix4(fft_complex_q15_t *data, uint32_t n, uint32_t m, int32_t s, int inverse)
+{
+    uint32_t stride1 = FFT_MAX_POINTS / (2 * m);
+    uint32_t stride2 = FFT_MAX_POINTS / (4 * m);
+    int32_t peak = 0;
+
+    for (uint32_t g = 0; g < n; g += 4 * m)
+    {
+        for (uint32_t k = 0; k < m; k++)
+        {
+            fft_complex_q15_t *pa = &data[g + k];
+            fft_complex_q15_t *pb = pa + m;
+            fft_complex_q15_t *pc = pb + m;
+            fft_complex_q15_t *pd = pc + m;
+            const int16_t *w1 = fft_twiddle_q15[k * stride1];
+            const int16_t *w2 = fft_twiddle_q15[k * stride2];
+            int32_t tr, ti;
+
+            // first stage, (a, b) and (c, d)
+            int32_t ar = fft_shift(pa->re, s), ai = fft_shift(pa->im, s);
+            int32_t cr = fft_shift(pc->re, s), ci = fft_shift(pc->im, s);
+
+            fft_cmul(fft_shift(pb->re, s), fft_shift(pb->im, s), w1, inverse, &tr, &ti);
+            int32_t br = ar - tr, bi = ai - ti;
+            ar += tr;
+            ai += ti;
+
+            fft_cmul(fft_shift(pd->re, s), fft_shift(pd->im, s), w1, inverse, &tr, &ti);
+            int32_t dr = cr - tr, di = ci - ti;
+            cr += tr;
+            ci += ti;
+
+            // second stage, (a, c) and (b, d)
+            fft_cmul(cr, ci, w2, inverse, &tr, &ti);
+            peak = fft_store(pa, ar + tr, ai + ti, peak);
+            peak = fft_store(pc, ar - tr, ai - ti, peak);
+
+            fft_cmul(dr, di, w2, inverse, &tr, &ti);
+            // times -i, or +i for the inverse
+            int32_t rr = inverse ? -ti : ti;
+            int32_t ri = inverse ? tr : -tr;
+            peak = fft_store(pb, br + rr, bi + ri, peak);
+            peak = fft_store(pd, br - rr, bi - ri, peak);
+        }
+    }
+    return peak;
+}
+
+/**
+ * @return int32_t the exponent of the unnormalized transform
+ */
+static int32_t fft_core(fft_complex_q15_t *data, uint32_t n, int inverse)
+{
+    uint32_t bits = fft_log2(n);
+    int32_t exponent = 0;
+    int32_t peak = 0;
+    int32_t s = 0;
+    uint32_t m = 1;
+
+    fft_bit_reverse_permute(data, n, bits);
+
+    if (bits & 1)
+    {
+        s = fft_normalize(data, n, FFT_LIMIT_RADIX2, &exponent);
+        peak = fft_pass_radix2(data, n, 1, s, inverse);
+        m = 2;
+    }
+    else
+    {
+        s = fft_normalize(data, n, FFT_LIMIT_RADIX4, &exponent);
+        peak = fft_pass_radix4(data, n, 1, s, inverse);
+        m = 4;
+    }
+
+    for (; m < n; m *= 4)
+    {
+        s = fft_shift_for(peak, FFT_LIMIT_RADIX4);
+        peak = fft_pass_radix4(data, n, m, s, inverse);
+        exponent += s;
+    }
+
+    return exponent;
+}
+
+/**
+ * forward: 2X[k] = (A + C*) + W^k * -i(A - C*), A = Z[k], C = Z[N/2 - k]
+ * inverse: 2Z[k] = (A + C*) + i * W^-k (A - C*), A = X[k], C = X[N/2 - k]
+ * where Z is the N/2 point transform of the even / odd samples packed as
+ * re / im, and X the N point spectrum. each call writes bins k and
+ * N/2 - k, from the values of both.
+ * @return int32_t the exponent of the scaling
+ */
+static int32_t fft_real_split(fft_complex_q15_t *z, uint32_t n, int inverse)
+{
+    uint32_t half = n / 2;
+    uint32_t stride = FFT_MAX_POINTS / n;
+    int32_t exponent = 0;
+    int32_t s = fft_normalize(z, half, FFT_LIMIT_SPLIT, &exponent);
+
+    // bin 0 and N/2 are real, X[0] = Re Z[0] + Im Z[0], X[N/2] = Re - Im
+    int32_t r0 = fft_shift(z[0].re, s), i0 = fft_shift(z[0].im, s);
+    int32_t scale = inverse ? 1 : 2;
+    fft_store(&z[0], (r0 + i0) * scale, (r0 - i0) * scale, 0);
+
+    for (uint32_t k = 1; k <= half / 2; k++)
+    {
+        uint32_t j = half - k;
+        int32_t a[2] = {fft_shift(z[k].re, s), fft_shift(z[k].im, s)};
+        int32_t c[2] = {fft_shift(z[j].re, s), fft_shift(z[j].im, s)};
+        const int32_t *src[2][2] = {{a, c}, {c, a}};
+        uint32_t idx[2] = {k, j};
+
+        for (int t = 0; t < (k == j ? 1 : 2); t++)
+        {
+            const int32_t *pa = src[t][0], *pc = src[t][1];
+            int32_t er = pa[0] + pc[0], ei = pa[1] - pc[1];
+            int32_t dr = pa[0] - pc[0], di = pa[1] + pc[1];
+            int32_t or_, oi;
+            fft_cmul(dr, di, fft_twiddle_q15[idx[t] * stride], inverse, &or_, &oi);
+
+            if (inverse) // E + i * O
+                fft_store(&z[idx[t]], er - oi, ei + or_, 0);
+            else // E + -i * O
+                fft_store(&z[idx[t]], er + oi, ei - or_, 0);
+        }
+    }
+
+    return exponent;
+}
+
+/******************************************************************************/
+/*                         PUBLIC FUNCTION DEFINITIONS                        */
+/******************************************************************************/
+
+error_t fft_q15(fft_complex_q15_t *data, uint32_t n, int32_t *exponent)
+{
+    if (data == NULL || exponent == NULL || !fft_size_valid(n, FFT_MIN_POINTS))
+        return E_INVALID_ARGUMENT;
+
+    *exponent = fft_core(data, n, 0);
+    return ALL_OK;
+}
+
+error_t ifft_q15(fft_complex_q15_t *data, uint32_t n, int32_t *exponent)
+{
+    if (data == NULL || exponent == NULL || !fft_size_valid(n, FFT_MIN_POINTS))
+        return E_INVALID_ARGUMENT;
+
+    *exponent = fft_core(data, n, 1) - (int32_t)fft_log2(n);
+    return ALL_OK;
+}
+
+error_t fft_rfft_q15(int16_t *data, uint32_t n, int32_t *exponent)
+{
+    fft_complex_q15_t *z = (fft_complex_q15_t *)data;
+
+    if (data == NULL || exponent == NULL || !fft_size_valid(n, 2 * FFT_MIN_POINTS))
+        return E_INVALID_ARGUMENT;
+
+    int32_t e = fft_core(z, n / 2, 0);
+    // the split pass gives 2X
+    *exponent = e + fft_real_split(z, n, 0) - 1;
+    return ALL_OK;
+}
+
+error_t fft_irfft_q15(int16_t *data, uint32_t n, int32_t *exponent)
+{
+    fft_complex_q15_t *z = (fft_complex_q15_t *)data;
+
+    if (data == NULL || exponent == NULL || !fft_size_valid(n, 2 * FFT_MIN_POINTS))
+        return E_INVALID_ARGUMENT;
+
+    // the split pass gives 2Z, the N/2 point inverse is not normalized
+    int32_t e = fft_real_split(z, n, 1) - 1;
+    *exponent = e + fft_core(z, n / 2, 1) - (int32_t)fft_log2(n / 2);
+    return ALL_OK;
+}
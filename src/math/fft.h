@@ -0,0 +1,133 @@
+/**
+ * @file fft.h
+ * @author simakeng (simakeng@outlook.com)
+ * @brief Block scaled fixed point FFT
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * *****************************************************************************
+ * @copyright Copyright (C) E15 Studio 2024
+ *
+ * This program is FREE software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation.
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 675 Mass Ave, Cambridge, MA 02139, USA. Or you can visit the link below to
+ * read the license online, or you can find a copy of the license in the root
+ * directory of this project named "LICENSE" file.
+ *
+ * https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * *****************************************************************************
+ *
+ * @example
+ *  int16_t samples[1024];   // ADC data in Q15
+ *  int32_t exponent;
+ *  fft_rfft_q15(samples, 1024, &exponent);
+ *  // bin k (1 <= k < 512) is ((fft_complex_q15_t *)samples)[k] * 2^exponent
+ *
+ * block floating point: before each pass the data is shifted right just
+ * enough that the pass can not overflow, and the shifts are summed into
+ * one exponent for the whole block. small signals are scaled up before
+ * the first pass so they use the whole word, full scale signals can not
+ * wrap.
+ *
+ * the largest size is set in menuconfig (FFT_MAX_POINTS_LOG2), the twiddle
+ * and bit reversal tables are generated for it by tools/twiddle.
+ */
+
+/******************************************************************************/
+/*                               INCLUDE FILES                                */
+/******************************************************************************/
+
+#include <stdint.h>
+
+#include <libe15-errors.h>
+
+/******************************************************************************/
+/*                              MACRO DEFINITIONS                             */
+/******************************************************************************/
+
+#ifndef __FFT_H__
+#define __FFT_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// smallest transform size
+#define FFT_MIN_POINTS 4
+
+/******************************************************************************/
+/*                              TYPE DEFINITIONS                              */
+/******************************************************************************/
+
+/// complex Q15 value, same layout as an interleaved int16_t array
+typedef struct
+{
+    int16_t re;
+    int16_t im;
+} fft_complex_q15_t;
+
+/******************************************************************************/
+/*                        PUBLIC FUNCTION DECLARATIONS                        */
+/******************************************************************************/
+
+/**
+ * @brief in place complex FFT, X[k] = sum x[n] * exp(-2πikn / N)
+ * @param data N complex values, replaced by the spectrum in natural order
+ * @param n number of points, a power of 2 in [4, FFT_MAX_POINTS]
+ * @param exponent output - the real spectrum is data * 2^exponent
+ * @return error_t E_INVALID_ARGUMENT if n is not supported
+ */
+error_t fft_q15(fft_complex_q15_t *data, uint32_t n, int32_t *exponent);
+
+/**
+ * @brief in place complex inverse FFT, x[n] = 1/N sum X[k] * exp(2πikn / N)
+ * @param data N complex values, replaced by the signal
+ * @param n number of points, a power of 2 in [4, FFT_MAX_POINTS]
+ * @param exponent output - the real signal is data * 2^exponent, the 1/N
+ *        is already in it
+ * @return error_t E_INVALID_ARGUMENT if n is not supported
+ */
+error_t ifft_q15(fft_complex_q15_t *data, uint32_t n, int32_t *exponent);
+
+/**
+ * @brief in place FFT of N real values, computed as a N/2 point complex FFT
+ *        and one split pass.
+ * @note only bins 0 ... N/2 are unique for real input, they are packed
+ *       into N/2 complex values: element 0 holds {X[0], X[N/2]} (both are
+ *       real), element k holds X[k] for 1 <= k < N/2.
+ * @param data N real values, replaced by the packed spectrum
+ * @param n number of real points, a power of 2 in [8, FFT_MAX_POINTS]
+ * @param exponent output - the real spectrum is data * 2^exponent
+ * @return error_t E_INVALID_ARGUMENT if n is not supported
+ */
+error_t fft_rfft_q15(int16_t *data, uint32_t n, int32_t *exponent);
+
+/**
+ * @brief inverse of fft_rfft_q15()
+ * @param data packed spectrum as fft_rfft_q15() writes it, replaced by
+ *        the N real values
+ * @param n number of real points, a power of 2 in [8, FFT_MAX_POINTS]
+ * @param exponent output - the real signal is data * 2^exponent, the 1/N
+ *        is already in it
+ * @return error_t E_INVALID_ARGUMENT if n is not supported
+ */
+error_t fft_irfft_q15(int16_t *data, uint32_t n, int32_t *exponent);
+
+#ifdef __cplusplus
+}
+#endif
+
+/******************************************************************************/
+/*                                 END OF FILE                                */
+/******************************************************************************/
+
+#endif //! #ifndef __FFT_H__
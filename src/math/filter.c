@@ -0,0 +1,267 @@
+/**
+ * @file filter.c
+ * @author simakeng (simakeng@outlook.com)
+ * @brief Block FIR and biquad IIR filters on fixed_t and Q15
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * the biquad loops run one section over the whole block before the
+ * next, so the coefficients and state of a section stay in registers.
+ * the Q15 dot product backend is picked like the fpa_array.c one.
+ */
+
+#include <string.h>
+
+#include "filter.h"
+#include "fpa_array.h"
+#include <generated-conf.h>
+
+#if defined(CONFIG_FPA_ARRAY_GENERIC)
+// portable C only
+#elif defined(__x86_64__) && (defined(__AVX2__) || defined(__SSE4_1__))
+#include <immintrin.h>
+#define FILTER_Q15_X86
+#elif defined(__ARM_FEATURE_DSP)
+#define FILTER_Q15_ARM_DSP
+#endif
+
+/******************************************************************************/
+/*                        PRIVATE FUNCTION DEFINITIONS                        */
+/******************************************************************************/
+
+/// round a sum with `frac` fraction bits to nearest, clamp to fixed_t
+static inline fixed_value_t filter_round(int64_t acc, int frac)
+{
+    return __fixed_clamp64((acc + ((int64_t)1 << (frac - 1))) >> frac);
+}
+
+static inline int16_t filter_round_q15(int64_t acc)
+{
+    int64_t v = (acc + (1 << 14)) >> 15;
+    if (v > INT16_MAX)
+        return INT16_MAX;
+    if (v < INT16_MIN)
+        return INT16_MIN;
+    return (int16_t)v;
+}
+
+/**
+ * @brief sum of a[i] * b[i], Q30
+ *
+ * PMADDWD adds two 16 x 16 products in a 32bit lane, that only wraps for
+ * (-32768)^2 * 2 = 2^31. a lane never holds -2^31 otherwise, so the
+ * lanes are taken as (-2^31, 2^31]: sign extended after subtracting 1,
+ * and the 1s are added back at the end.
+ */
+static int64_t filter_dot_q15(const int16_t *a, const int16_t *b, size_t n)
+{
+    int64_t sum = 0;
+    size_t i = 0;
+#if defined(FILTER_Q15_X86) && defined(__AVX2__)
+    __m256i acc = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i m = _mm256_madd_epi16(_mm256_loadu_si256((const __m256i *)(a + i)),
+                                      _mm256_loadu_si256((const __m256i *)(b + i)));
+        m = _mm256_sub_epi32(m, one);
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(m)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(m, 1)));
+    }
+    __m128i s = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_cvtsi128_si64(s) + _mm_extract_epi64(s, 1) + (int64_t)(i / 2);
+#elif defined(FILTER_Q15_X86)
+    __m128i acc = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1);
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i m = _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(a + i)),
+                                   _mm_loadu_si128((const __m128i *)(b + i)));
+        m = _mm_sub_epi32(m, one);
+        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(m));
+        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(_mm_srli_si128(m, 8)));
+    }
+    sum = _mm_cvtsi128_si64(acc) + _mm_extract_epi64(acc, 1) + (int64_t)(i / 2);
+#elif defined(FILTER_Q15_ARM_DSP)
+    // SMLALD, two products into a 64bit register pair, unaligned LDR is fine on v7E-M
+    uint32_t lo = 0, hi = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        uint32_t a0, a1, b0, b1;
+        memcpy(&a0, a + i, 4);
+        memcpy(&a1, a + i + 2, 4);
+        memcpy(&b0, b + i, 4);
+        memcpy(&b1, b + i + 2, 4);
+        __asm__("smlald %0, %1, %2, %3" : "+r"(lo), "+r"(hi) : "r"(a0), "r"(b0));
+        __asm__("smlald %0, %1, %2, %3" : "+r"(lo), "+r"(hi) : "r"(a1), "r"(b1));
+    }
+    sum = (int64_t)(((uint64_t)hi << 32) | lo);
+#endif
+    for (; i < n; i++)
+        sum += (int32_t)a[i] * b[i];
+    return sum;
+}
+
+/******************************************************************************/
+/*                         PUBLIC FUNCTION DEFINITIONS                        */
+/******************************************************************************/
+
+void filter_fir_init(filter_fir_t *fir, const fixed_t *coeffs, fixed_t *state, uint32_t taps)
+{
+    fir->coeffs = coeffs;
+    fir->state = state;
+    fir->taps = taps;
+    fir->pos = 0;
+    memset(state, 0, 2 * taps * sizeof(fixed_t));
+}
+
+fixed_t filter_fir_sample(filter_fir_t *fir, fixed_t x)
+{
+    // newest first, so h[k] meets x[-k]
+    fir->pos = (fir->pos == 0 ? fir->taps : fir->pos) - 1;
+    fir->state[fir->pos] = x;
+    fir->state[fir->pos + fir->taps] = x;
+    return (fixed_t){filter_round(fixed_dot_wide(fir->coeffs, fir->state + fir->pos, fir->taps), FIXED_WIDTH)};
+}
+
+void filter_fir_block(filter_fir_t *fir, const fixed_t *in, fixed_t *out, size_t n)
+{
+    uint32_t taps = fir->taps;
+    fixed_t *state = fir->state;
+
+    // the last taps samples, newest first, go to the upper half
+    memmove(state + taps, state + fir->pos, taps * sizeof(fixed_t));
+
+    while (n > 0)
+    {
+        uint32_t r = n < taps ? (uint32_t)n : taps;
+        // the chunk goes below them, newest first, so output j reads
+        // state[taps - 1 - j ...]. storing the chunk before the first dot
+        // product keeps the wide loads clear of the narrow stores.
+        for (uint32_t j = 0; j < r; j++)
+            state[taps - 1 - j] = in[j];
+        for (uint32_t j = 0; j < r; j++)
+            out[j].val = filter_round(fixed_dot_wide(fir->coeffs, state + taps - 1 - j, taps), FIXED_WIDTH);
+        memmove(state + taps, state + taps - r, taps * sizeof(fixed_t));
+        in += r;
+        out += r;
+        n -= r;
+    }
+
+    // back to the filter_fir_sample() layout, newest at pos 0
+    memcpy(state, state + taps, taps * sizeof(fixed_t));
+    fir->pos = 0;
+}
+
+void filter_fir_q15_init(filter_fir_q15_t *fir, const int16_t *coeffs, int16_t *state, uint32_t taps)
+{
+    fir->coeffs = coeffs;
+    fir->state = state;
+    fir->taps = taps;
+    fir->pos = 0;
+    memset(state, 0, 2 * taps * sizeof(int16_t));
+}
+
+int16_t filter_fir_q15_sample(filter_fir_q15_t *fir, int16_t x)
+{
+    fir->pos = (fir->pos == 0 ? fir->taps : fir->pos) - 1;
+    fir->state[fir->pos] = x;
+    fir->state[fir->pos + fir->taps] = x;
+    return filter_round_q15(filter_dot_q15(fir->coeffs, fir->state + fir->pos, fir->taps));
+}
+
+void filter_fir_q15_block(filter_fir_q15_t *fir, const int16_t *in, int16_t *out, size_t n)
+{
+    uint32_t taps = fir->taps;
+    int16_t *state = fir->state;
+
+    // same layout as filter_fir_block()
+    memmove(state + taps, state + fir->pos, taps * sizeof(int16_t));
+
+    while (n > 0)
+    {
+        uint32_t r = n < taps ? (uint32_t)n : taps;
+        for (uint32_t j = 0; j < r; j++)
+            state[taps - 1 - j] = in[j];
+        for (uint32_t j = 0; j < r; j++)
+            out[j] = filter_round_q15(filter_dot_q15(fir->coeffs, state + taps - 1 - j, taps));
+        memmove(state + taps, state + taps - r, taps * sizeof(int16_t));
+        in += r;
+        out += r;
+        n -= r;
+    }
+
+    memcpy(state, state + taps, taps * sizeof(int16_t));
+    fir->pos = 0;
+}
+
+void filter_biquad_df1_init(filter_biquad_df1_t *iir, const filter_biquad_coeffs_t *coeffs,
+                            filter_biquad_df1_state_t *state, uint32_t sections)
+{
+    iir->coeffs = coeffs;
+    iir->state = state;
+    iir->sections = sections;
+    memset(state, 0, sections * sizeof(filter_biquad_df1_state_t));
+}
+
+void filter_biquad_df1_block(filter_biquad_df1_t *iir, const fixed_t *in, fixed_t *out, size_t n)
+{
+    const fixed_t *src = in;
+
+    for (uint32_t s = 0; s < iir->sections; s++)
+    {
+        filter_biquad_coeffs_t c = iir->coeffs[s];
+        fixed_value_t x1 = iir->state[s].x1.val, x2 = iir->state[s].x2.val;
+        fixed_value_t y1 = iir->state[s].y1.val, y2 = iir->state[s].y2.val;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            fixed_value_t x = src[i].val;
+            int64_t acc = (int64_t)c.b0 * x + (int64_t)c.b1 * x1 + (int64_t)c.b2 * x2 -
+                          (int64_t)c.a1 * y1 - (int64_t)c.a2 * y2;
+            fixed_value_t y = filter_round(acc, FILTER_BIQUAD_FRAC);
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            out[i].val = y;
+        }
+
+        iir->state[s] = (filter_biquad_df1_state_t){{x1}, {x2}, {y1}, {y2}};
+        // the next section works in place on the output
+        src = out;
+    }
+}
+
+void filter_biquad_df2t_init(filter_biquad_df2t_t *iir, const filter_biquad_coeffs_t *coeffs,
+                             filter_biquad_df2t_state_t *state, uint32_t sections)
+{
+    iir->coeffs = coeffs;
+    iir->state = state;
+    iir->sections = sections;
+    memset(state, 0, sections * sizeof(filter_biquad_df2t_state_t));
+}
+
+void filter_biquad_df2t_block(filter_biquad_df2t_t *iir, const fixed_t *in, fixed_t *out, size_t n)
+{
+    const fixed_t *src = in;
+
+    for (uint32_t s = 0; s < iir->sections; s++)
+    {
+        filter_biquad_coeffs_t c = iir->coeffs[s];
+        int64_t s1 = iir->state[s].s1, s2 = iir->state[s].s2;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            fixed_value_t x = src[i].val;
+            fixed_value_t y = filter_round((int64_t)c.b0 * x + s1, FILTER_BIQUAD_FRAC);
+            s1 = (int64_t)c.b1 * x - (int64_t)c.a1 * y + s2;
+            s2 = (int64_t)c.b2 * x - (int64_t)c.a2 * y;
+            out[i].val = y;
+        }
+
+        iir->state[s].s1 = s1;
+        iir->state[s].s2 = s2;
+        src = out;
+    }
+}
@@ -0,0 +1,214 @@
+/**
+ * @file filter.h
+ * @author simakeng (simakeng@outlook.com)
+ * @brief Block FIR and biquad IIR filters on fixed_t and Q15
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * *****************************************************************************
+ * @copyright Copyright (C) E15 Studio 2024
+ *
+ * This program is FREE software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation.
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 675 Mass Ave, Cambridge, MA 02139, USA. Or you can visit the link below to
+ * read the license online, or you can find a copy of the license in the root
+ * directory of this project named "LICENSE" file.
+ *
+ * https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * *****************************************************************************
+ *
+ * @example
+ *  // coefficients from `filter_design lowpass 20000 1000 -o 4`
+ *  static const filter_biquad_coeffs_t lp_coeffs[2] = { ... };
+ *  static filter_biquad_df2t_state_t lp_state[2];
+ *  filter_biquad_df2t_t lp;
+ *  filter_biquad_df2t_init(&lp, lp_coeffs, lp_state, 2);
+ *
+ *  // in the DMA complete interrupt
+ *  filter_biquad_df2t_block(&lp, adc_block, current_block, 64);
+ *
+ * every output is summed in a 64bit accumulator and rounded to nearest
+ * once, then clamped to the output type. the FIR dot products use the
+ * fpa_array.h backends for fixed_t, and SSE4.1 / AVX2 or SMLALD (ARM DSP
+ * extension) for Q15. the results are bit exact on every backend.
+ *
+ * tools/filter_design prints the coefficient arrays for these types.
+ */
+
+/******************************************************************************/
+/*                               INCLUDE FILES                                */
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <libe15-fpa.h>
+
+/******************************************************************************/
+/*                              MACRO DEFINITIONS                             */
+/******************************************************************************/
+
+#ifndef __FILTER_H__
+#define __FILTER_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// fraction bits of biquad coefficients, Q2.30 holds [-2, 2)
+#define FILTER_BIQUAD_FRAC 30
+
+/******************************************************************************/
+/*                              TYPE DEFINITIONS                              */
+/******************************************************************************/
+
+/**
+ * FIR filter on fixed_t. the state holds 2 * taps samples, a circular
+ * buffer with each sample written twice, `taps` apart, so the last
+ * `taps` samples are always contiguous for one dot product.
+ * filter_fir_sample() pushes one sample into it. filter_fir_block()
+ * stores up to `taps` input samples at once before the dot products of
+ * them, and leaves the same layout, so both can be used on one filter.
+ */
+typedef struct
+{
+    const fixed_t *coeffs; ///< taps coefficients, h[0] applies to the newest sample
+    fixed_t *state;        ///< 2 * taps samples
+    uint32_t taps;
+    uint32_t pos; ///< index of the newest sample in state
+} filter_fir_t;
+
+/// FIR filter on Q15 samples and Q15 coefficients, see filter_fir_t
+typedef struct
+{
+    const int16_t *coeffs; ///< taps coefficients, h[0] applies to the newest sample
+    int16_t *state;        ///< 2 * taps samples
+    uint32_t taps;
+    uint32_t pos; ///< index of the newest sample in state
+} filter_fir_q15_t;
+
+/**
+ * one second order section, Q2.30,
+ * y = b0 x + b1 x[-1] + b2 x[-2] - a1 y[-1] - a2 y[-2]
+ */
+typedef struct
+{
+    int32_t b0, b1, b2, a1, a2;
+} filter_biquad_coeffs_t;
+
+/// direct form I state of one section, the last two inputs and outputs
+typedef struct
+{
+    fixed_t x1, x2, y1, y2;
+} filter_biquad_df1_state_t;
+
+/**
+ * transposed direct form II state of one section. kept at the full
+ * precision of the products, so a section rounds only its output.
+ */
+typedef struct
+{
+    int64_t s1, s2;
+} filter_biquad_df2t_state_t;
+
+/// cascade of direct form I sections
+typedef struct
+{
+    const filter_biquad_coeffs_t *coeffs;
+    filter_biquad_df1_state_t *state;
+    uint32_t sections;
+} filter_biquad_df1_t;
+
+/**
+ * cascade of transposed direct form II sections. half the state of
+ * direct form I and one rounding per section, the state needs headroom
+ * for the internal gain of high Q sections.
+ */
+typedef struct
+{
+    const filter_biquad_coeffs_t *coeffs;
+    filter_biquad_df2t_state_t *state;
+    uint32_t sections;
+} filter_biquad_df2t_t;
+
+/******************************************************************************/
+/*                        PUBLIC FUNCTION DECLARATIONS                        */
+/******************************************************************************/
+
+/**
+ * @brief set up a FIR filter with all past samples 0
+ * @param fir the filter
+ * @param coeffs taps coefficients, not copied
+ * @param state buffer of 2 * taps samples
+ * @param taps number of coefficients, at least 1
+ */
+void filter_fir_init(filter_fir_t *fir, const fixed_t *coeffs, fixed_t *state, uint32_t taps);
+
+/**
+ * @brief push one sample through the filter
+ * @return fixed_t the output for this sample
+ */
+fixed_t filter_fir_sample(filter_fir_t *fir, fixed_t x);
+
+/**
+ * @brief filter a block, e.g. a DMA buffer
+ * @param fir the filter
+ * @param in n input samples
+ * @param out n output samples, may be the same array as `in`
+ * @param n number of samples
+ */
+void filter_fir_block(filter_fir_t *fir, const fixed_t *in, fixed_t *out, size_t n);
+
+/// filter_fir_init() for Q15
+void filter_fir_q15_init(filter_fir_q15_t *fir, const int16_t *coeffs, int16_t *state, uint32_t taps);
+
+/// filter_fir_sample() for Q15, the output saturates to [-1, 1)
+int16_t filter_fir_q15_sample(filter_fir_q15_t *fir, int16_t x);
+
+/// filter_fir_block() for Q15, the output saturates to [-1, 1)
+void filter_fir_q15_block(filter_fir_q15_t *fir, const int16_t *in, int16_t *out, size_t n);
+
+/**
+ * @brief set up a direct form I cascade with all past values 0
+ * @param iir the filter
+ * @param coeffs one coefficient set per section, not copied
+ * @param state one state per section
+ * @param sections number of sections
+ */
+void filter_biquad_df1_init(filter_biquad_df1_t *iir, const filter_biquad_coeffs_t *coeffs,
+                            filter_biquad_df1_state_t *state, uint32_t sections);
+
+/**
+ * @brief filter a block through every section
+ * @param iir the filter
+ * @param in n input samples
+ * @param out n output samples, may be the same array as `in`
+ * @param n number of samples
+ */
+void filter_biquad_df1_block(filter_biquad_df1_t *iir, const fixed_t *in, fixed_t *out, size_t n);
+
+/// filter_biquad_df1_init() for transposed direct form II
+void filter_biquad_df2t_init(filter_biquad_df2t_t *iir, const filter_biquad_coeffs_t *coeffs,
+                             filter_biquad_df2t_state_t *state, uint32_t sections);
+
+/// filter_biquad_df1_block() for transposed direct form II
+void filter_biquad_df2t_block(filter_biquad_df2t_t *iir, const fixed_t *in, fixed_t *out, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+/******************************************************************************/
+/*                                 END OF FILE                                */
+/******************************************************************************/
+
+#endif //! #ifndef __FILTER_H__
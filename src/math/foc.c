@@ -0,0 +1,46 @@
+/**
+ * @file foc.c
+ * @author simakeng (simakeng@outlook.com)
+ * @brief Field oriented control transforms and space vector PWM
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "foc.h"
+
+/******************************************************************************/
+/*                        PRIVATE FUNCTION DEFINITIONS                        */
+/******************************************************************************/
+
+static inline fixed_value_t foc_duty_clamp(fixed_value_t v)
+{
+    if (v < 0)
+        return 0;
+    if (v > FIXED_ONE.val)
+        return FIXED_ONE.val;
+    return v;
+}
+
+/******************************************************************************/
+/*                         PUBLIC FUNCTION DEFINITIONS                        */
+/******************************************************************************/
+
+foc_abc_t foc_svpwm(foc_ab_t v)
+{
+    foc_abc_t p = foc_inverse_clarke(v);
+
+    fixed_value_t max = p.a.val > p.b.val ? p.a.val : p.b.val;
+    fixed_value_t min = p.a.val < p.b.val ? p.a.val : p.b.val;
+    max = p.c.val > max ? p.c.val : max;
+    min = p.c.val < min ? p.c.val : min;
+
+    // center the phases in the period, 0.5 - (max + min) / 2
+    fixed_value_t offset = (FIXED_ONE.val - max - min) >> 1;
+
+    return (foc_abc_t){{foc_duty_clamp(p.a.val + offset)},
+                       {foc_duty_clamp(p.b.val + offset)},
+                       {foc_duty_clamp(p.c.val + offset)}};
+}
@@ -0,0 +1,211 @@
+/**
+ * @file foc.h
+ * @author simakeng (simakeng@outlook.com)
+ * @brief Field oriented control transforms and space vector PWM
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * *****************************************************************************
+ * @copyright Copyright (C) E15 Studio 2024
+ *
+ * This program is FREE software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation.
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 675 Mass Ave, Cambridge, MA 02139, USA. Or you can visit the link below to
+ * read the license online, or you can find a copy of the license in the root
+ * directory of this project named "LICENSE" file.
+ *
+ * https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * *****************************************************************************
+ *
+ * @example
+ *  // current loop interrupt
+ *  foc_sincos_t sc = foc_sincos_angle(angle_encoder_electrical(&enc, count));
+ *  foc_dq_t i = foc_park(foc_clarke(ia, ib), sc);
+ *  foc_dq_t v = {pid_d(i.d), pid_q(i.q)};       // in units of Vbus
+ *  foc_abc_t duty = foc_svpwm(foc_inverse_park(v, sc));
+ *
+ * the angle is turned into a sin / cos pair once per cycle, and both
+ * Park transforms take that pair. the transforms are inline, each output
+ * is two 32 x 32 -> 64 multiplies (SMULL / SMLAL on Cortex-M) with one
+ * rounding. Clarke is the amplitude invariant form, |αβ| = phase peak.
+ */
+
+/******************************************************************************/
+/*                               INCLUDE FILES                                */
+/******************************************************************************/
+
+#include <stdint.h>
+
+#include <libe15-fpa.h>
+#include <angle.h>
+
+/******************************************************************************/
+/*                              MACRO DEFINITIONS                             */
+/******************************************************************************/
+
+#ifndef __FOC_H__
+#define __FOC_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// 1 / √3
+#define FOC_INV_SQRT3 ((fixed_t){(fixed_value_t)(0.57735026918962576451l * (1 << FIXED_WIDTH) + 0.5l)})
+
+/// 2 / √3
+#define FOC_2_INV_SQRT3 ((fixed_t){(fixed_value_t)(1.15470053837925152902l * (1 << FIXED_WIDTH) + 0.5l)})
+
+/// √3 / 2
+#define FOC_SQRT3_DIV2 ((fixed_t){(fixed_value_t)(0.86602540378443864676l * (1 << FIXED_WIDTH) + 0.5l)})
+
+/******************************************************************************/
+/*                              TYPE DEFINITIONS                              */
+/******************************************************************************/
+
+/// sin and cos of the electrical angle
+typedef struct
+{
+    fixed_t sin;
+    fixed_t cos;
+} foc_sincos_t;
+
+/// three phase values
+typedef struct
+{
+    fixed_t a, b, c;
+} foc_abc_t;
+
+/// stationary frame
+typedef struct
+{
+    fixed_t alpha, beta;
+} foc_ab_t;
+
+/// rotating frame
+typedef struct
+{
+    fixed_t d, q;
+} foc_dq_t;
+
+/******************************************************************************/
+/*                        PUBLIC FUNCTION DEFINITIONS                         */
+/******************************************************************************/
+
+/**
+ * @brief a * b + c * d, summed at 64bit and rounded once
+ */
+static inline fixed_t __foc_mac2(fixed_t a, fixed_t b, fixed_t c, fixed_t d)
+{
+    int64_t acc = (int64_t)a.val * b.val + (int64_t)c.val * d.val + (1 << (FIXED_WIDTH - 1));
+#if defined(CONFIG_FPA_SATURATE)
+    return (fixed_t){__fixed_clamp64(acc >> FIXED_WIDTH)};
+#else
+    return (fixed_t){(fixed_value_t)(acc >> FIXED_WIDTH)};
+#endif
+}
+
+/**
+ * @brief sin and cos of the electrical angle, from one fixed_sincos()
+ * @param theta electrical angle, in radians
+ * @return foc_sincos_t
+ */
+static inline foc_sincos_t foc_sincos(fixed_t theta)
+{
+    foc_sincos_t sc;
+    fixed_sincos(theta, &sc.sin, &sc.cos);
+    return sc;
+}
+
+/**
+ * @brief sin and cos of a binary electrical angle, see angle.h
+ * @param theta electrical angle, 2^32 per turn
+ * @return foc_sincos_t
+ */
+static inline foc_sincos_t foc_sincos_angle(angle_t theta)
+{
+    foc_sincos_t sc;
+    fixed_sincos_bam(theta, &sc.sin, &sc.cos);
+    return sc;
+}
+
+/**
+ * @brief Clarke transform from two phase currents, ia + ib + ic = 0
+ * @param a phase a
+ * @param b phase b
+ * @return foc_ab_t α = a, β = (a + 2b) / √3
+ */
+static inline foc_ab_t foc_clarke(fixed_t a, fixed_t b)
+{
+    return (foc_ab_t){a, __foc_mac2(a, FOC_INV_SQRT3, b, FOC_2_INV_SQRT3)};
+}
+
+/**
+ * @brief inverse Clarke transform
+ * @param v stationary frame vector
+ * @return foc_abc_t the three phases, summing to 0
+ */
+static inline foc_abc_t foc_inverse_clarke(foc_ab_t v)
+{
+    // b = -α / 2 + √3 / 2 β, c = -a - b
+    fixed_t b = __foc_mac2(v.alpha, (fixed_t){-(1 << (FIXED_WIDTH - 1))}, v.beta, FOC_SQRT3_DIV2);
+    return (foc_abc_t){v.alpha, b, (fixed_t){-v.alpha.val - b.val}};
+}
+
+/**
+ * @brief Park transform, stationary to rotating frame
+ * @param v stationary frame vector
+ * @param sc sin and cos of the electrical angle
+ * @return foc_dq_t d = α cos + β sin, q = β cos - α sin
+ */
+static inline foc_dq_t foc_park(foc_ab_t v, foc_sincos_t sc)
+{
+    return (foc_dq_t){__foc_mac2(v.alpha, sc.cos, v.beta, sc.sin),
+                      __foc_mac2(v.beta, sc.cos, v.alpha, (fixed_t){-sc.sin.val})};
+}
+
+/**
+ * @brief inverse Park transform, rotating to stationary frame
+ * @param v rotating frame vector
+ * @param sc sin and cos of the electrical angle
+ * @return foc_ab_t α = d cos - q sin, β = d sin + q cos
+ */
+static inline foc_ab_t foc_inverse_park(foc_dq_t v, foc_sincos_t sc)
+{
+    return (foc_ab_t){__foc_mac2(v.d, sc.cos, v.q, (fixed_t){-sc.sin.val}),
+                      __foc_mac2(v.d, sc.sin, v.q, sc.cos)};
+}
+
+/******************************************************************************/
+/*                        PUBLIC FUNCTION DECLARATIONS                        */
+/******************************************************************************/
+
+/**
+ * @brief space vector PWM duties of a voltage vector
+ * @note the phase voltages get the common mode offset
+ *       -(max + min) / 2, which gives the same duties as the sector
+ *       based SVPWM without the sector search. the linear range is
+ *       |v| <= 1 / √3, beyond it each duty is clamped to [0, 1].
+ * @param v voltage vector in units of the bus voltage
+ * @return foc_abc_t duty of each phase, in [0, 1]
+ */
+foc_abc_t foc_svpwm(foc_ab_t v);
+
+#ifdef __cplusplus
+}
+#endif
+
+/******************************************************************************/
+/*                                 END OF FILE                                */
+/******************************************************************************/
+
+#endif //! #ifndef __FOC_H__
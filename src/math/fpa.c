@@ -12,21 +12,269 @@
 */
 
 #include "libe15-fpa.h"
+#include <string.h>
+#include <generated-conf.h>
 #include <cordic.h>
+#include <fpa_sin_lut.h>
 
+/**
+ * digit-by-digit (shift and subtract) square root of a * 2^16, one
+ * result bit per step. the steps are branch free and there is always
+ * 24 of them, so it runs in constant time.
+ */
 fixed_t fixed_sqrt(fixed_t a)
 {
+    if (a.val <= 0)
+        return FIXED_ZERO;
+
+    uint64_t num = (uint64_t)a.val << FIXED_WIDTH;
+    uint64_t res = 0;
+    // the largest power of 4 not above 2^47
+    uint64_t bit = (uint64_t)1 << 46;
+    int i = 0;
+    for (i = 0; i < 24; i++)
+    {
+        uint64_t trial = res + bit;
+        uint64_t mask = 0 - (uint64_t)(num >= trial);
+        num -= trial & mask;
+        res = (res >> 1) + (bit & mask);
+        bit >>= 2;
+    }
+
+    // round to nearest, the remainder is above res iff sqrt > res + 0.5
+    res += num > res;
+
+    return (fixed_t){(fixed_value_t)res};
+}
+
+/**
+ * a.val = m * 2^(32 - s) with m in [0.25, 1) and s even, so
+ * 1 / sqrt(a) = (1 / sqrt(m)) * 2^(s / 2 - 8), and 1 / sqrt(m) comes
+ * from a seed table and Newton-Raphson y = y * (3 - m * y^2) / 2.
+ */
+fixed_t fixed_rsqrt(fixed_t a)
+{
+    if (a.val <= 0)
+        return FIXED_MAX_INF;
+
+    uint32_t s = __u32_clz((uint32_t)a.val) & ~1u;
+    uint32_t m = (uint32_t)a.val << s;
+
+    // 1 / sqrt(m) in Q30
+    uint32_t y = (uint32_t)fpa_rsqrt_seed[(m >> (32 - FPA_RSQRT_SEED_BITS)) - (1u << (FPA_RSQRT_SEED_BITS - 2))] << 15;
+    int i = 0;
+    for (i = 0; i < 3; i++)
+    {
+        // y^2 and m * y^2 in Q28
+        uint32_t y2 = (uint32_t)(((uint64_t)y * y) >> 32);
+        uint32_t my2 = (uint32_t)(((uint64_t)m * y2) >> 32);
+        y = (uint32_t)(((uint64_t)y * ((3u << 28) - my2)) >> 29);
+    }
+
+    // Q30 -> Q16 and apply 2^(s / 2 - 8), s <= 30 so the shift is >= 7
+    uint32_t shift = 22 - s / 2;
+    return (fixed_t){(fixed_value_t)((y + (1u << (shift - 1))) >> shift)};
+}
+
+/**
+ * @brief 1 / d for a normalized d, Newton-Raphson x = x * (2 - d * x)
+ *
+ * @param d d / 2^32 in [0.5, 1), the MSB must be set
+ * @return uint32_t 1 / d in Q30, in (1, 2]
+ */
+static inline uint32_t fixed_recip_normalized(uint32_t d)
+{
+    uint32_t x = (uint32_t)fpa_recip_seed[(d >> (31 - FPA_RECIP_SEED_BITS)) & ((1u << FPA_RECIP_SEED_BITS) - 1)] << 15;
     int i = 0;
-    // 0.5
-    const fixed_t div_2 = (fixed_t){1 << (FIXED_WIDTH - 1)};
-    fixed_t t = (fixed_t){a.val >> 1};
-    for (i = 0; i < 5; i++)
+    for (i = 0; i < 3; i++)
     {
-        t = fixed_add(t, fixed_div(a, t));
-        t = fixed_mul(t, div_2);
+        // d * x in Q30, close to 1.0
+        uint32_t e = (uint32_t)(((uint64_t)d * x) >> 32);
+        x = (uint32_t)(((uint64_t)x * ((1u << 31) - e)) >> 30);
     }
-    return t;
+    return x;
 }
+
+/// forwards to fixed_div_fast() with a dividend of 1
+fixed_t fixed_reciprocal(fixed_t b)
+{
+    return fixed_div_fast(FIXED_ONE, b);
+}
+
+fixed_t fixed_div_fast(fixed_t a, fixed_t b)
+{
+    fixed_value_t sign = (a.val ^ b.val) >> (sizeof(fixed_value_t) * 8 - 1);
+    uint32_t ua = a.val < 0 ? 0u - (uint32_t)a.val : (uint32_t)a.val;
+    uint32_t ub = b.val < 0 ? 0u - (uint32_t)b.val : (uint32_t)b.val;
+
+    if (ub == 0)
+        return sign ? FIXED_MIN_NINF : FIXED_MAX_INF;
+
+    uint32_t n = __u32_clz(ub);
+    uint32_t x = fixed_recip_normalized(ub << n);
+
+    // a * 2^16 / b = a * (1 / d) * 2^(n - 16), 1 / d is Q30
+    uint64_t q = ((uint64_t)ua * x) >> (46 - n);
+
+    if (q > (uint64_t)FIXED_MAX_INF.val)
+        return sign ? FIXED_MIN_NINF : FIXED_MAX_INF;
+
+    return (fixed_t){sign ? -(fixed_value_t)q : (fixed_value_t)q};
+}
+
+/// 17 fraction digits are enough to tell any two Q16 values and the
+/// half way points between them (k / 2^17) apart
+#define FIXED_ATOF_DIGITS 17
+
+/// 10^17 / 2^16 = 2 * 5^17
+#define FIXED_ATOF_DIVISOR 1525878906250ull
+
+/**
+ * the fraction digits are padded to exactly 17, so
+ * fraction * 2^16 = digits * 2^16 / 10^17 = digits / (2 * 5^17) is a
+ * single 64bit division, and the remainder rounds it. any digit after
+ * the 17th can only break an exact tie.
+ */
+fixed_t fixed_atof(const char *str)
+{
+    uint32_t integer = 0;
+    uint64_t digits = 0;
+    uint32_t digit_cnt = 0;
+    int negative = 0;
+    int sticky = 0;
+
+    while (isspace((unsigned char)*str))
+        str++;
+
+    if (*str == '-' || *str == '+')
+        negative = *str++ == '-';
+
+    while (isdigit((unsigned char)*str))
+    {
+        // stop growing once out of range, it is clamped below
+        if (integer < 0x10000u)
+            integer = integer * 10 + (uint32_t)(*str - '0');
+        str++;
+    }
+
+    if (*str == '.')
+    {
+        str++;
+        while (isdigit((unsigned char)*str))
+        {
+            if (digit_cnt < FIXED_ATOF_DIGITS)
+            {
+                digits = digits * 10 + (uint64_t)(*str - '0');
+                digit_cnt++;
+            }
+            else
+                sticky |= *str != '0';
+            str++;
+        }
+    }
+
+    for (; digit_cnt < FIXED_ATOF_DIGITS; digit_cnt++)
+        digits *= 10;
+
+    uint64_t frac = digits / FIXED_ATOF_DIVISOR;
+    uint64_t rem2 = (digits % FIXED_ATOF_DIVISOR) * 2;
+
+    // nearest, ties to even
+    if (rem2 > FIXED_ATOF_DIVISOR || (rem2 == FIXED_ATOF_DIVISOR && (sticky || (frac & 1))))
+        frac++;
+
+    uint64_t mag = ((uint64_t)integer << FIXED_WIDTH) + frac;
+    uint64_t limit = negative ? (uint64_t)1 << 31 : (uint64_t)FIXED_MAX_INF.val;
+    if (mag > limit)
+        mag = limit;
+
+    return (fixed_t){(fixed_value_t)(negative ? 0u - (uint32_t)mag : (uint32_t)mag)};
+}
+
+/**
+ * writes val and a '\0', returns the length without the '\0'.
+ * the division by constant 10 compiles to a multiply, no libc call.
+ */
+static int fixed_format_one(fixed_t val, char *str)
+{
+    char *p = str;
+    char int_digits[5];
+    int int_cnt = 0;
+    int i = 0;
+
+    uint32_t mag = val.val < 0 ? 0u - (uint32_t)val.val : (uint32_t)val.val;
+    uint32_t integer = mag >> FIXED_WIDTH;
+
+    // fraction * 10^6 / 2^16 = fraction * 15625 / 2^10, fits 32bit
+    uint32_t scaled = (mag & ((1u << FIXED_WIDTH) - 1)) * 15625u;
+    uint32_t fraction = scaled >> 10;
+    uint32_t rem = scaled & 1023;
+
+    // ties to even like printf, at most 999985, so it never carries
+    fraction += rem > 512 || (rem == 512 && (fraction & 1));
+
+    if (val.val < 0)
+        *p++ = '-';
+
+    do
+    {
+        int_digits[int_cnt++] = (char)('0' + integer % 10);
+        integer /= 10;
+    } while (integer != 0);
+
+    while (int_cnt != 0)
+        *p++ = int_digits[--int_cnt];
+
+    *p++ = '.';
+
+    for (i = 5; i >= 0; i--)
+    {
+        p[i] = (char)('0' + fraction % 10);
+        fraction /= 10;
+    }
+    p += 6;
+    *p = '\0';
+
+    return (int)(p - str);
+}
+
+int fixed_ftoa(fixed_t val, char *str)
+{
+    if (str == NULL)
+        return -1;
+
+    fixed_format_one(val, str);
+    return 0;
+}
+
+int fixed_format_array(char *buf, size_t buf_len, const fixed_t *vals, size_t n, char sep)
+{
+    char tmp[FIXED_FTOA_MAX_LEN + 1];
+    size_t len = 0;
+    size_t i = 0;
+
+    if (buf == NULL || buf_len == 0)
+        return -1;
+
+    buf[0] = '\0';
+    for (i = 0; i < n; i++)
+    {
+        int val_len = fixed_format_one(vals[i], tmp);
+        size_t need = (size_t)val_len + (i != 0);
+
+        // room for the value and the '\0'
+        if (len + need >= buf_len)
+            return -1;
+
+        if (i != 0)
+            buf[len++] = sep;
+        memcpy(buf + len, tmp, (size_t)val_len + 1);
+        len += (size_t)val_len;
+    }
+
+    return (int)len;
+}
+
 /**
  * @brief do CORDIC rotation to solve cos() ans sin()
  *
@@ -71,9 +319,13 @@ void cordic_rotate(fixed_t deg, fixed_t *sin_out, fixed_t *cos_out)
     }
 cordic_output:
     // fprintf(stderr, "using cordic gain at step %d\n",i);
-    i--;
-    y = fixed_mul(y, cordic_gain[i]);
-    x = fixed_mul(x, cordic_gain[i]);
+    // deg == 0 exits before any rotation, there is no gain to remove
+    if (i != 0)
+    {
+        i--;
+        y = fixed_mul(y, cordic_gain[i]);
+        x = fixed_mul(x, cordic_gain[i]);
+    }
     // fprintf(stderr, "output x: 0x%08X : %f\n", x.val, x.val / 65536.0);
     // fprintf(stderr, "output y: 0x%08X : %f\n", y.val, y.val / 65536.0);
     // fprintf(stderr, "length: %f\n", (x.val / 65536.) * (x.val / 65536.) + (y.val / 65536.) * (y.val / 65536.));
@@ -81,37 +333,314 @@ cordic_output:
     *cos_out = x;
 }
 
+/// ln(2) in Q29
+#define FIXED_LN2_Q29 372130559
+
+/// 1 / ln(2) in Q32
+#define FIXED_INV_LN2_Q32 0x171547653ll
+
+/// fixed_exp() input above this overflows, ln(32768) in Q16
+#define FIXED_EXP_INPUT_MAX 681391
+
+/// fixed_exp() input below this rounds to 0, ln(2^-17) in Q16
+#define FIXED_EXP_INPUT_MIN (-772243)
+
 /**
- * this function will use sine's periodicity to warp the value to
- * 0 <= v < pi / 2, and use CORDIC to calculate the sine value.
+ * @brief CORDIC vectoring mode, rotate (x, y) onto the positive x axis.
+ * @note x must be positive and |x|, |y| < 2^60. x and y are 64bit so the
+ *       magnitude keeps every bit of a full range fixed_t, the angle is Q29.
+ *
+ * @param px in: x, out: sqrt(x^2 + y^2) / cordic_vector_gain_q32
+ * @param py in: y, out: residual, close to 0
+ * @param pz out: atan(y / x)
  */
-fixed_t fixed_sin(fixed_t v)
+static void cordic_vector(int64_t *px, int64_t *py, int32_t *pz)
 {
-    fixed_value_t val = v.val;
-    fixed_value_t sign_bit = val >> (sizeof(fixed_value_t) * 8 - 1);
+    int64_t x = *px;
+    int64_t y = *py;
+    int32_t z = 0;
+    int i = 0;
+    for (i = 0; i < CORDIC_VECTOR_DEPTH; i++)
+    {
+        int64_t x_temp;
+        if (y > 0)
+        {
+            x_temp = x + (y >> i);
+            y = y - (x >> i);
+            z += cordic_atan_q29[i];
+        }
+        else
+        {
+            x_temp = x - (y >> i);
+            y = y + (x >> i);
+            z -= cordic_atan_q29[i];
+        }
+        x = x_temp;
+    }
+    *px = x;
+    *py = y;
+    *pz = z;
+}
 
-    fixed_value_t abs_val = (val + sign_bit) ^ sign_bit;
+/**
+ * @brief hyperbolic CORDIC, rotation mode if `vectoring` is 0,
+ *        otherwise vectoring mode. all values are Q29.
+ * @note rotation mode:  z -> 0, (x, y) -> K * (x cosh z + y sinh z, y cosh z + x sinh z)
+ *       vectoring mode: y -> 0, x -> K * sqrt(x^2 - y^2), z -> z + atanh(y / x)
+ *       |z| (or |atanh(y / x)|) must be less than 1.118.
+ */
+static void cordic_hyperbolic(int32_t *px, int32_t *py, int32_t *pz, int vectoring)
+{
+    int32_t x = *px;
+    int32_t y = *py;
+    int32_t z = *pz;
+    int i = 0;
+    for (i = 1; i <= CORDIC_HYPER_DEPTH; i++)
+    {
+        // some steps must run twice, or the iteration does not converge
+        int times = CORDIC_HYPER_REPEAT(i) ? 2 : 1;
+        for (; times != 0; times--)
+        {
+            int32_t x_temp;
+            int forward = vectoring ? (y < 0) : (z >= 0);
+            if (forward)
+            {
+                x_temp = x + (y >> i);
+                y = y + (x >> i);
+                z -= cordic_atanh_q29[i - 1];
+            }
+            else
+            {
+                x_temp = x - (y >> i);
+                y = y - (x >> i);
+                z += cordic_atanh_q29[i - 1];
+            }
+            x = x_temp;
+        }
+    }
+    *px = x;
+    *py = y;
+    *pz = z;
+}
 
-    fixed_value_t warp_val = abs_val % FIXED_2PI.val;
-    // fprintf(stderr, "warp to 0x%08X : %f\n", warp_val, warp_val / 65536.0);
-    // fprintf(stderr, "sign bit: %d\n",sign_bit);
-    if (warp_val > FIXED_PI.val)
+/**
+ * the vector is mirrored into the right half plane and scaled so the
+ * larger component has its MSB at bit 59, then one vectoring pass gives
+ * both the angle and the magnitude.
+ */
+void fixed_atan2_hypot(fixed_t y, fixed_t x, fixed_t *angle_out, fixed_t *mag_out)
+{
+    int64_t vx = x.val;
+    int64_t vy = y.val;
+    fixed_value_t half_turn = 0;
+
+    // atan2(y, x) = atan2(-y, -x) ± π
+    if (vx < 0)
     {
-        sign_bit = !sign_bit;
-        warp_val = warp_val - FIXED_PI.val;
+        vx = -vx;
+        vy = -vy;
+        half_turn = y.val >= 0 ? FIXED_PI.val : -FIXED_PI.val;
     }
 
-    if (warp_val > FIXED_PI_DIV2.val)
-        warp_val = FIXED_PI.val - warp_val;
+    uint32_t largest = (uint32_t)(vx > (vy < 0 ? -vy : vy) ? vx : (vy < 0 ? -vy : vy));
+    if (largest == 0)
+    {
+        *angle_out = FIXED_ZERO;
+        *mag_out = FIXED_ZERO;
+        return;
+    }
 
+    // at least 28, the inputs are never truncated
+    int32_t shift = 60 - (int32_t)__u32_bit_width(largest);
+    int64_t cx = vx << shift;
+    int64_t cy = (int64_t)((uint64_t)vy << shift);
+    int32_t cz;
 
-    // fprintf(stderr, "warp to 0x%08X : %f\n", warp_val, warp_val / 65536.0);
-    // fprintf(stderr, "sign bit: %d\n",sign_bit);
-    fixed_t sin_v, cos_v;
-    cordic_rotate((fixed_t){warp_val}, &sin_v, &cos_v);
+    cordic_vector(&cx, &cy, &cz);
+
+    // Q29 -> Q16
+    angle_out->val = ((cz + (1 << 12)) >> 13) + half_turn;
+
+    // cx * gain / 2^32 in two halves, cx < 2^61
+    uint64_t hi = (uint64_t)cx >> 32;
+    uint64_t lo = (uint64_t)cx & 0xFFFFFFFFu;
+    uint64_t mag = hi * cordic_vector_gain_q32 + ((lo * cordic_vector_gain_q32) >> 32);
+    mag = (mag + ((uint64_t)1 << (shift - 1))) >> shift;
+
+    if (mag > (uint64_t)FIXED_MAX_INF.val)
+        mag = FIXED_MAX_INF.val;
+
+    mag_out->val = (fixed_value_t)mag;
+}
+
+fixed_t fixed_atan2(fixed_t y, fixed_t x)
+{
+    fixed_t angle, mag;
+    fixed_atan2_hypot(y, x, &angle, &mag);
+    return angle;
+}
+
+fixed_t fixed_hypot(fixed_t x, fixed_t y)
+{
+    fixed_t angle, mag;
+    fixed_atan2_hypot(y, x, &angle, &mag);
+    return mag;
+}
+
+/**
+ * v = k * ln(2) + r, 0 <= r < ln(2), so e^v = 2^k * (cosh(r) + sinh(r)),
+ * and the hyperbolic rotation gives cosh(r) and sinh(r) at once.
+ */
+fixed_t fixed_exp(fixed_t v)
+{
+    if (v.val > FIXED_EXP_INPUT_MAX)
+        return FIXED_MAX_INF;
+
+    if (v.val < FIXED_EXP_INPUT_MIN)
+        return FIXED_ZERO;
+
+    int32_t k = (int32_t)(((int64_t)v.val * FIXED_INV_LN2_Q32) >> 48);
+    int32_t r = (int32_t)(((int64_t)v.val << (29 - FIXED_WIDTH)) - (int64_t)k * FIXED_LN2_Q29);
+
+    int32_t x = cordic_hyper_gain_q29;
+    int32_t y = 0;
+    cordic_hyperbolic(&x, &y, &r, 0);
+
+    // e^r in Q29, 1 <= e^r < 2
+    uint32_t exp_r = (uint32_t)x + (uint32_t)y;
+
+    // Q29 * 2^k -> Q16
+    int32_t shift = (29 - FIXED_WIDTH) - k;
+    if (shift > 0)
+        exp_r = (exp_r + (1u << (shift - 1))) >> shift;
+    else
+        exp_r <<= -shift;
+
+    return (fixed_t){(fixed_value_t)exp_r};
+}
+
+/**
+ * v = m * 2^e, 1 <= m < 2, so ln(v) = e * ln(2) + ln(m), and
+ * ln(m) = 2 * atanh((m - 1) / (m + 1)) comes from hyperbolic vectoring.
+ */
+fixed_t fixed_log(fixed_t v)
+{
+    if (v.val <= 0)
+        return FIXED_MIN_NINF;
+
+    int32_t msb = (int32_t)__u32_bit_width(v.val) - 1;
+    int32_t m;
+    if (msb <= 29)
+        m = v.val << (29 - msb);
+    else
+        m = v.val >> (msb - 29);
 
-    if (sign_bit)
-        sin_v.val = -sin_v.val;
+    int32_t x = m + (1 << 29);
+    int32_t y = m - (1 << 29);
+    int32_t z = 0;
+    cordic_hyperbolic(&x, &y, &z, 1);
+
+    int64_t ln = (int64_t)(msb - FIXED_WIDTH) * FIXED_LN2_Q29 + 2 * (int64_t)z;
+
+    // Q29 -> Q16
+    return (fixed_t){(fixed_value_t)((ln + (1 << 12)) >> 13)};
+}
+
+#if defined(CONFIG_FPA_TRIG_LUT)
+
+/**
+ * @brief look up the quarter-wave sine table generated by tools/cordic,
+ *        the table layout is constant so the lookup folds to one path.
+ */
+static inline fixed_t fixed_lut_sin(uint32_t phase)
+{
+#if defined(CONFIG_FPA_TRIG_LUT_QUADRATIC)
+    const int quadratic = 1;
+#else
+    const int quadratic = 0;
+#endif
+    return (fixed_t){fpa_sin_lut_lookup(fpa_sin_lut, FPA_SIN_LUT_BITS, FPA_SIN_LUT_Q, quadratic, phase)};
+}
 
+void fixed_sincos_bam(uint32_t bam, fixed_t *sin_out, fixed_t *cos_out)
+{
+    // cos(v) = sin(v + π/2)
+    *sin_out = fixed_lut_sin(bam);
+    *cos_out = fixed_lut_sin(bam + 0x40000000u);
+}
+
+void fixed_sincos(fixed_t v, fixed_t *sin_out, fixed_t *cos_out)
+{
+    fixed_sincos_bam(fixed_to_bam(v), sin_out, cos_out);
+}
+
+fixed_t fixed_sin(fixed_t v)
+{
+    return fixed_lut_sin(fixed_to_bam(v));
+}
+
+fixed_t fixed_cos(fixed_t v)
+{
+    return fixed_lut_sin(fixed_to_bam(v) + 0x40000000u);
+}
+
+#else // CORDIC backend
+
+/**
+ * the binary angle does the `mod 2π` with the integer wrap around, so
+ * there is no division and no special case for FIXED_MIN_NINF, and the
+ * quadrant folding is the one of fixed_sincos_bam().
+ */
+void fixed_sincos(fixed_t v, fixed_t *sin_out, fixed_t *cos_out)
+{
+    fixed_sincos_bam(fixed_to_bam(v), sin_out, cos_out);
+}
+
+fixed_t fixed_sin(fixed_t v)
+{
+    fixed_t sin_v, cos_v;
+    fixed_sincos(v, &sin_v, &cos_v);
     return sin_v;
-}
\ No newline at end of file
+}
+
+fixed_t fixed_cos(fixed_t v)
+{
+    fixed_t sin_v, cos_v;
+    fixed_sincos(v, &sin_v, &cos_v);
+    return cos_v;
+}
+
+/**
+ * the top 2 bits are the quadrant, the other 30 bits scale to [0, π/2)
+ * with one multiply, each quadrant is a quarter turn of the CORDIC result.
+ */
+void fixed_sincos_bam(uint32_t bam, fixed_t *sin_out, fixed_t *cos_out)
+{
+    // π/2 in Q28, FIXED_PI_DIV2 is truncated and would be 0.7 LSB short at the top
+    int64_t p = bam & 0x3FFFFFFFu;
+    fixed_t rad = {(fixed_value_t)((p * 421657428 + ((int64_t)1 << 41)) >> 42)};
+    fixed_t s, c;
+    cordic_rotate(rad, &s, &c);
+
+    switch (bam >> 30)
+    {
+    case 0:
+        *sin_out = s;
+        *cos_out = c;
+        break;
+    case 1:
+        *sin_out = c;
+        *cos_out = (fixed_t){-s.val};
+        break;
+    case 2:
+        *sin_out = (fixed_t){-s.val};
+        *cos_out = (fixed_t){-c.val};
+        break;
+    default:
+        *sin_out = (fixed_t){-c.val};
+        *cos_out = s;
+        break;
+    }
+}
+
+#endif // ! #if defined(CONFIG_FPA_TRIG_LUT)
@@ -17,12 +17,24 @@
 */
 #include <stdio.h>
 #include <stdint.h>
+#include <stddef.h>
 #include <ctype.h>
+#include <generated-conf.h>
+
+#if defined(__ARM_FEATURE_DSP)
+#include <arm_acle.h>
+#endif
 
 /******************************************
  *                Configs                 *
  ******************************************/
 
+/**
+ * CONFIG_FPA_SATURATE (menuconfig) makes fixed_add, fixed_sub and
+ * fixed_mul clamp to FIXED_MIN_NINF / FIXED_MAX_INF like the *_sat
+ * functions, instead of wrapping around.
+ */
+
 #define FIEXD_VALUE_WIDTH 32
 
 /**
@@ -35,6 +47,11 @@
  */
 #define FIXED_WIDTH 16
 
+#ifdef __cplusplus
+extern "C"
+{
+#endif //! #ifdef __cplusplus
+
 /// fixed point value type
 typedef struct __tag_fixed_t
 {
@@ -64,6 +81,96 @@ typedef struct __tag_fixed_t
 
 /// epsilon = 0.000015
 #define FIXED_EPS ((fixed_t){(fixed_value_t)0x00000001})
+
+/// binary angle per radian, 2^32 / 2π rounded. a plain integer, the Q16 of
+/// the radian is shifted out after the multiply, see fixed_to_bam()
+#define FIXED_BAM_PER_RAD 683565276
+
+/**
+ * @brief clamp a 64bit value to the fixed_value_t range, without branch
+ * @param v value to clamp
+ * @return fixed_value_t v, FIXED_MAX_INF or FIXED_MIN_NINF
+ */
+static inline fixed_value_t __fixed_clamp64(int64_t v)
+{
+    // v fits iff v + 2^31 is in [0, 2^32)
+    fixed_uvalue_t fits = (fixed_uvalue_t)(((uint64_t)v + 0x80000000u) >> 32 == 0);
+    fixed_uvalue_t mask = 0 - fits;
+    // 0x7FFFFFFF when v >= 0, 0x80000000 when v < 0
+    fixed_uvalue_t limit = (fixed_uvalue_t)(v >> 63) ^ 0x7FFFFFFFu;
+    return (fixed_value_t)(((fixed_uvalue_t)v & mask) | (limit & ~mask));
+}
+
+/**
+ * @brief add two fixed point value, clamp to FIXED_MIN_NINF / FIXED_MAX_INF
+ *        instead of wrapping
+ * @note a single QADD with the ARM DSP extension.
+ * @param a operand a
+ * @param b operand b
+ * @return fixed_t, a + b
+ */
+static inline fixed_t fixed_add_sat(fixed_t a, fixed_t b)
+{
+#if defined(__ARM_FEATURE_DSP)
+    return (fixed_t){__qadd(a.val, b.val)};
+#else
+    fixed_uvalue_t ua = (fixed_uvalue_t)a.val, ub = (fixed_uvalue_t)b.val;
+    fixed_uvalue_t res = ua + ub;
+    // overflow iff both operands have the same sign and res the other one
+    fixed_uvalue_t mask = 0 - (((ua ^ res) & (ub ^ res)) >> 31);
+    fixed_uvalue_t limit = (ua >> 31) + 0x7FFFFFFFu;
+    return (fixed_t){(fixed_value_t)((res & ~mask) | (limit & mask))};
+#endif
+}
+
+/**
+ * @brief sub two fixed point value, clamp to FIXED_MIN_NINF / FIXED_MAX_INF
+ *        instead of wrapping
+ * @note a single QSUB with the ARM DSP extension.
+ * @param a operand a
+ * @param b operand b
+ * @return fixed_t a - b
+ */
+static inline fixed_t fixed_sub_sat(fixed_t a, fixed_t b)
+{
+#if defined(__ARM_FEATURE_DSP)
+    return (fixed_t){__qsub(a.val, b.val)};
+#else
+    fixed_uvalue_t ua = (fixed_uvalue_t)a.val, ub = (fixed_uvalue_t)b.val;
+    fixed_uvalue_t res = ua - ub;
+    // overflow iff the operands have different signs and res has b's sign
+    fixed_uvalue_t mask = 0 - (((ua ^ ub) & (ua ^ res)) >> 31);
+    fixed_uvalue_t limit = (ua >> 31) + 0x7FFFFFFFu;
+    return (fixed_t){(fixed_value_t)((res & ~mask) | (limit & mask))};
+#endif
+}
+
+/**
+ * @brief multiply two fixed point value, clamp to FIXED_MIN_NINF /
+ *        FIXED_MAX_INF instead of wrapping
+ * @note rounds toward -inf like fixed_mul.
+ * @param a operand a
+ * @param b operand b
+ * @return fixed_t a * b
+ */
+static inline fixed_t fixed_mul_sat(fixed_t a, fixed_t b)
+{
+    return (fixed_t){__fixed_clamp64(((int64_t)a.val * b.val) >> FIXED_WIDTH)};
+}
+
+/**
+ * @brief acc + a * b, clamped once at the end, so an intermediate product
+ *        out of range is still added correctly.
+ * @param acc accumulator
+ * @param a operand a
+ * @param b operand b
+ * @return fixed_t acc + a * b
+ */
+static inline fixed_t fixed_mac_sat(fixed_t acc, fixed_t a, fixed_t b)
+{
+    return (fixed_t){__fixed_clamp64(acc.val + (((int64_t)a.val * b.val) >> FIXED_WIDTH))};
+}
+
 /**
  * @brief add two fixed point value
  *
@@ -73,7 +180,11 @@ typedef struct __tag_fixed_t
  */
 static inline fixed_t fixed_add(fixed_t a, fixed_t b)
 {
+#if defined(CONFIG_FPA_SATURATE)
+    return fixed_add_sat(a, b);
+#else
     return (fixed_t){a.val + b.val};
+#endif
 }
 /**
  * @brief sub two fixed point value
@@ -84,7 +195,11 @@ static inline fixed_t fixed_add(fixed_t a, fixed_t b)
  */
 static inline fixed_t fixed_sub(fixed_t a, fixed_t b)
 {
+#if defined(CONFIG_FPA_SATURATE)
+    return fixed_sub_sat(a, b);
+#else
     return (fixed_t){a.val - b.val};
+#endif
 }
 /**
  * @brief multiply two fixed point value
@@ -95,6 +210,9 @@ static inline fixed_t fixed_sub(fixed_t a, fixed_t b)
  */
 static inline fixed_t fixed_mul(fixed_t a, fixed_t b)
 {
+#if defined(CONFIG_FPA_SATURATE)
+    return fixed_mul_sat(a, b);
+#else
     fixed_value_t a_hi, a_lo, b_hi, b_lo;
     a_hi = a.val >> FIXED_WIDTH;
     a_lo = a.val & ((1 << FIXED_WIDTH) - 1);
@@ -105,7 +223,8 @@ static inline fixed_t fixed_mul(fixed_t a, fixed_t b)
     fixed_uvalue_t res_mid = a_hi * b_lo + a_lo * b_hi;
     res_hi <<= FIXED_WIDTH;
     res_lo >>= FIXED_WIDTH;
-    return (fixed_t){res_hi + res_lo + res_mid};
+    return (fixed_t){(fixed_value_t)(res_hi + res_lo + res_mid)};
+#endif
 }
 
 /**
@@ -119,9 +238,30 @@ static inline fixed_t fixed_div(fixed_t a, fixed_t b)
 {
     int64_t la = a.val;
     la = la << FIXED_WIDTH;
-    return (fixed_t){la / b.val};
+    return (fixed_t){(fixed_value_t)(la / b.val)};
 }
 
+/**
+ * @brief get the reciprocal of a fixed point value without division
+ * @note uses a normalized 32 entry seed table and 3 Newton-Raphson
+ *       iterations, 1 / 0 saturates to FIXED_MAX_INF.
+ * @param b operand b
+ * @return fixed_t 1 / b
+ */
+fixed_t fixed_reciprocal(fixed_t b);
+
+/**
+ * @brief divide two fixed point value without division
+ * @note multiplies a by the Newton-Raphson reciprocal of b, so it does
+ *       not call the 64bit division of the C runtime. the result is
+ *       within 1 LSB of `fixed_div` while |a / b| < 16384, and within
+ *       2 LSB above that. saturates when the quotient does not fit.
+ * @param a operand a
+ * @param b operand b
+ * @return fixed_t a / b
+ */
+fixed_t fixed_div_fast(fixed_t a, fixed_t b);
+
 /**
  * @brief get absolute value of a fixed point value
  *
@@ -239,10 +379,10 @@ static inline fixed_t fixed_from_float(const float val)
     }
     else
     {
-        // move to right
+        // move to right, a 24bit mantissa still fits after 7 moves
         move_off = -move_off;
-        if (move_off >= 7)
-            fixed_val = 0x7FFFFFFF;
+        if (move_off > 7)
+            fixed_val = sign_bit ? FIXED_MIN_NINF.val : FIXED_MAX_INF.val;
         else
             fixed_val <<= move_off;
     }
@@ -260,155 +400,68 @@ static inline fixed_t fixed_from_int(int32_t val)
     return (fixed_t){val << FIXED_WIDTH};
 }
 
-static inline uint32_t __u32_bit_width(uint32_t v)
+/**
+ * @brief count leading zero bits of a 32bit value
+ * @note maps to a single CLZ instruction on ARMv7-M and most other cpus.
+ * @param v operand v
+ * @return uint32_t leading zero count, 32 if v is 0
+ */
+static inline uint32_t __u32_clz(uint32_t v)
 {
-    uint32_t bit_width = 32;
-    while (bit_width != 0)
+#if defined(__GNUC__)
+    return v == 0 ? 32 : (uint32_t)__builtin_clz(v);
+#else
+    uint32_t clz = 0;
+    if (v == 0)
+        return 32;
+    while (!(v & 0x80000000u))
     {
-        if ((1 << (bit_width - 1)) & v)
-            return bit_width;
-        bit_width--;
+        v <<= 1;
+        clz++;
     }
-    return bit_width;
+    return clz;
+#endif
+}
+
+static inline uint32_t __u32_bit_width(uint32_t v)
+{
+    return 32 - __u32_clz(v);
 }
+/// longest fixed_ftoa() output, "-32768.000000", without the '\0'
+#define FIXED_FTOA_MAX_LEN 13
 
 /**
  * @brief parse string to get fixed point value
+ * @note leading white space and one sign are skipped, the result is
+ *       rounded to the nearest value (ties to even), and clamps to
+ *       FIXED_MIN_NINF / FIXED_MAX_INF when out of range.
  * @param str string contains data
  * @return fixed_t
  */
-static inline fixed_t fixed_atof(const char *str)
-{
-    int32_t i_val = 0;
-    int32_t sign = 0;
-    uint32_t frac_val = 0;
-    uint32_t frac_depth = 0;
-    int32_t fixed_value;
-
-    while (isspace(*str))
-        *str++;
-
-    if (*str == '-')
-    {
-        sign = -1;
-        str++;
-    }
-
-    if (*str == '+')
-        str++;
-
-    while (isdigit(*str))
-    {
-        i_val *= 10;
-        i_val += *str - '0';
-        if (i_val > 0x7FFFu)
-            if (sign == -1)
-                return FIXED_MIN_NINF;
-            else
-                return FIXED_MAX_INF;
-        str++;
-    }
-
-    if (*str == '.')
-    {
-        str++;
-
-        while (isdigit(*str))
-        {
-            frac_val *= 10;
-            frac_val += *str - '0';
-            frac_depth++;
-
-            str++;
-            if (frac_depth > 6)
-            {
-                if (isdigit(*str))
-                    if (*str > '4')
-                        frac_val += 1;
-                break;
-            }
-        }
-    }
-
-    fixed_value = i_val << FIXED_WIDTH;
-
-    uint32_t move_left = FIXED_WIDTH - frac_depth;
-    while (frac_depth || move_left)
-    {
-        if (move_left != 0)
-        {
-            uint32_t can_move = 32 - __u32_bit_width(frac_val);
-            if (can_move > move_left)
-            {
-                frac_val <<= move_left;
-                move_left = 0;
-            }
-            else
-            {
-                frac_val <<= can_move;
-                move_left -= can_move;
-            }
-
-            if (frac_depth != 0)
-            {
-                frac_val /= 5;
-                frac_depth--;
-            }
-        }
-        else if (frac_depth != 0)
-        {
-            frac_val /= 5;
-            frac_depth--;
-        }
-    }
-
-    fixed_value += frac_val;
-    if (sign)
-        return (fixed_t){-fixed_value};
-    else
-        return (fixed_t){fixed_value};
-}
+fixed_t fixed_atof(const char *str);
 
 /**
  * @brief convert fixed point value to 10-based string into buffer
+ * @note always 6 fraction digits, rounded like printf("%.6f"), no printf
+ *       is used. the buffer needs FIXED_FTOA_MAX_LEN + 1 bytes.
  * @param val fixed point value
  * @param str buffer to store string
  * @return int 0 if success, -1 if failed
  */
-static inline int fixed_ftoa(fixed_t val, char *str)
-{
-    fixed_t abs_val = fixed_abs(val);
-    fixed_value_t interger = abs_val.val >> FIXED_WIDTH;
-    if (val.val < 0)
-        *str++ = '-';
-    int char_cnt = sprintf(str, "%d", interger);
-    str += char_cnt;
-    *str++ = '.';
-    fixed_value_t fraction = abs_val.val & ((1 << FIXED_WIDTH) - 1);
-
-    /*
-     * equivalent to
-     *  `reminder = reminder * 1000000 % 65536`,
-     * but the qeuation below will not overflow 32bit interger.
-     */
-    fixed_value_t reminder = (fraction * 1000) % 65536;
-    reminder = (reminder * 1000) % 65536;
-
-    /*
-     * equivalent to
-     *  `fraction = fraction * 1000000 / 65536`,
-     * but the qeuation below will not overflow 32bit interger.
-     */
-    fraction = fraction * 15625 / 1024;
-
-    // * use reminder to round up
-    if (reminder >= 32768)
-        fraction += 1;
-
-    char_cnt = sprintf(str, "%06d", fraction);
-
-    return 0;
-}
+int fixed_ftoa(fixed_t val, char *str);
+
+/**
+ * @brief format `n` values into `buf`, separated by `sep`, '\0' terminated
+ * @note a value is only written if it fits completely, so the buffer
+ *       never holds a cut off number.
+ * @param buf output buffer
+ * @param buf_len size of buf in bytes
+ * @param vals values to format
+ * @param n number of values
+ * @param sep separator between two values, like ',' or ' '
+ * @return int length of the string in buf, -1 if not all values fit
+ */
+int fixed_format_array(char *buf, size_t buf_len, const fixed_t *vals, size_t n, char sep);
 
 /**
  * @brief move fixed point value to left
@@ -436,15 +489,27 @@ static inline fixed_t fixed_move_right(fixed_t value, fixed_uvalue_t bits)
 
 /**
  * @brief get the square root of a fixed point value
- *
+ * @note bit exact, the result is sqrt(a) rounded to the nearest LSB.
+ *       runs in constant time without division.
  * @param a operand a
- * @return fixed_t sqrt(a)
+ * @return fixed_t sqrt(a), 0 when a <= 0
  */
 fixed_t fixed_sqrt(fixed_t a);
 
+/**
+ * @brief get the reciprocal square root of a fixed point value
+ * @note uses a seed table and 3 Newton-Raphson iterations, runs in
+ *       constant time without division, within 1 LSB of 1 / sqrt(a).
+ *       handy to normalize a vector with multiplies only.
+ * @param a operand a
+ * @return fixed_t 1 / sqrt(a), FIXED_MAX_INF when a <= 0
+ */
+fixed_t fixed_rsqrt(fixed_t a);
+
 /**
  * @brief get the sine of a fixed point value
- * @note this implmentation use CORDIC algorithm
+ * @note this implmentation use CORDIC algorithm, or a interpolated
+ *       lookup table if `CONFIG_FPA_TRIG_LUT` is selected.
  * @param v operand v
  * @return fixed_t sin(v)
  */
@@ -452,10 +517,99 @@ fixed_t fixed_sin(fixed_t v);
 
 /**
  * @brief get the cosine of a fixed point value
- * @note this implmentation use CORDIC algorithm
+ * @note this implmentation use CORDIC algorithm, or a interpolated
+ *       lookup table if `CONFIG_FPA_TRIG_LUT` is selected.
  * @param v operand v
  * @return fixed_t cos(v)
  */
 fixed_t fixed_cos(fixed_t v);
 
+/**
+ * @brief get the sine and cosine of a fixed point value at once
+ * @note this implmentation use CORDIC algorithm, both outputs come
+ *       from the same rotation, so it costs the same as one
+ *       `fixed_sin` or `fixed_cos` call. With `CONFIG_FPA_TRIG_LUT`
+ *       it does two table lookups instead.
+ * @param v operand v
+ * @param sin_out output - sin(v)
+ * @param cos_out output - cos(v)
+ */
+void fixed_sincos(fixed_t v, fixed_t *sin_out, fixed_t *cos_out);
+
+/**
+ * @brief convert radian to a 32bit binary angle (full turn = 2^32)
+ * @note the integer wrap around is the `mod 2π`, so any value maps to one
+ *       turn with a single multiply.
+ * @param rad angle in radian
+ * @return uint32_t binary angle
+ */
+static inline uint32_t fixed_to_bam(fixed_t rad)
+{
+    return (uint32_t)(((int64_t)rad.val * FIXED_BAM_PER_RAD) >> FIXED_WIDTH);
+}
+
+/**
+ * @brief get the sine and cosine of a binary angle at once
+ * @note a full turn is 2^32, so the angle wraps with the integer and
+ *       needs no range reduction. With `CONFIG_FPA_TRIG_LUT` the top bits
+ *       index the table directly, the CORDIC backend folds the quadrant
+ *       from the top 2 bits.
+ * @param bam angle, 2^32 per turn
+ * @param sin_out output - sin(bam)
+ * @param cos_out output - cos(bam)
+ */
+void fixed_sincos_bam(uint32_t bam, fixed_t *sin_out, fixed_t *cos_out);
+
+/**
+ * @brief get the angle and the length of vector (x, y) at once
+ * @note this implmentation use CORDIC algorithm in vectoring mode, with
+ *       64bit x and y so both results are within 1 LSB over the whole
+ *       input range
+ * @param y operand y
+ * @param x operand x
+ * @param angle_out output - atan2(y, x), in (-π, π]
+ * @param mag_out output - sqrt(x^2 + y^2), saturate to FIXED_MAX_INF
+ */
+void fixed_atan2_hypot(fixed_t y, fixed_t x, fixed_t *angle_out, fixed_t *mag_out);
+
+/**
+ * @brief get the angle of vector (x, y)
+ * @note this implmentation use CORDIC algorithm in vectoring mode,
+ *       within 1 LSB
+ * @param y operand y
+ * @param x operand x
+ * @return fixed_t atan2(y, x), in (-π, π]
+ */
+fixed_t fixed_atan2(fixed_t y, fixed_t x);
+
+/**
+ * @brief get the length of vector (x, y)
+ * @note this implmentation use CORDIC algorithm in vectoring mode,
+ *       within 1 LSB
+ * @param x operand x
+ * @param y operand y
+ * @return fixed_t sqrt(x^2 + y^2), saturate to FIXED_MAX_INF
+ */
+fixed_t fixed_hypot(fixed_t x, fixed_t y);
+
+/**
+ * @brief get the natural exponential of a fixed point value
+ * @note this implmentation use hyperbolic CORDIC algorithm
+ * @param v operand v
+ * @return fixed_t e^v, saturate to FIXED_MAX_INF when v > ln(32768)
+ */
+fixed_t fixed_exp(fixed_t v);
+
+/**
+ * @brief get the natural logarithm of a fixed point value
+ * @note this implmentation use hyperbolic CORDIC algorithm
+ * @param v operand v
+ * @return fixed_t ln(v), FIXED_MIN_NINF when v <= 0
+ */
+fixed_t fixed_log(fixed_t v);
+
+#ifdef __cplusplus
+}
+#endif //! #ifdef __cplusplus
+
 #endif // ! LIBE15_FPA_H
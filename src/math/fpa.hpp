@@ -0,0 +1,244 @@
+/**
+ * @file fpa.hpp
+ * @author simakeng (simakeng@outlook.com)
+ * @brief C++ wrapper of libe15 Fixed Point Arithmetic Library
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * *****************************************************************************
+ * @copyright Copyright (C) E15 Studio 2024
+ *
+ * This program is FREE software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation.
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 675 Mass Ave, Cambridge, MA 02139, USA. Or you can visit the link below to
+ * read the license online, or you can find a copy of the license in the root
+ * directory of this project named "LICENSE" file.
+ *
+ * https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * *****************************************************************************
+ *
+ * @example
+ *  using namespace libe15::literals;
+ *  constexpr libe15::fixed kp = 0.35_fx;   // folded at compile time
+ *  libe15::fixed out = kp * err + ki * err_i;
+ *
+ * needs C++14.
+ */
+
+/******************************************************************************/
+/*                               INCLUDE FILES                                */
+/******************************************************************************/
+
+#include <stdint.h>
+
+#include <libe15-fpa.h>
+
+/******************************************************************************/
+/*                              MACRO DEFINITIONS                             */
+/******************************************************************************/
+
+#ifndef __LIBE15_FPA_HPP__
+#define __LIBE15_FPA_HPP__
+
+/******************************************************************************/
+/*                              TYPE DEFINITIONS                              */
+/******************************************************************************/
+
+namespace libe15
+{
+    /**
+     * @brief `fixed_t` with operators, same size and layout as `fixed_t`.
+     * @note the arithmetic gives the same bits as the matching C function
+     *       (fixed_add, fixed_mul, fixed_div ...), but is written as
+     *       constexpr, so constant operands fold at compile time.
+     *       shifts of negative values are written as multiplies, which
+     *       compile to the same instructions.
+     */
+    class fixed
+    {
+    public:
+        fixed_t value;
+
+        constexpr fixed() : value{0} {}
+
+        constexpr fixed(fixed_t v) : value(v) {}
+
+        constexpr operator fixed_t() const { return value; }
+
+        /// __fixed_clamp64, CONFIG_FPA_SATURATE builds clamp +, - and *
+        static constexpr fixed_value_t saturate(int64_t v)
+        {
+            return v > INT32_MAX ? INT32_MAX : v < INT32_MIN ? INT32_MIN : (fixed_value_t)v;
+        }
+
+        static constexpr fixed from_raw(fixed_value_t raw)
+        {
+            return fixed(fixed_t{raw});
+        }
+
+        static constexpr fixed from_int(int32_t v)
+        {
+            return from_raw(v * (fixed_value_t)(1 << FIXED_WIDTH));
+        }
+
+        /**
+         * @brief round to the nearest fixed point value, use it in a
+         *        constexpr context so no float code reaches the target.
+         */
+        static constexpr fixed from_double(long double v)
+        {
+            return from_raw((fixed_value_t)(v * (1 << FIXED_WIDTH) + (v < 0 ? -0.5L : 0.5L)));
+        }
+
+        constexpr fixed_value_t raw() const { return value.val; }
+
+        /// round toward -inf, like `value.val >> FIXED_WIDTH`
+        constexpr int32_t to_int() const { return value.val >> FIXED_WIDTH; }
+
+        constexpr float to_float() const { return (float)value.val / (1 << FIXED_WIDTH); }
+
+        constexpr fixed operator-() const
+        {
+            return from_raw((fixed_value_t)(0u - (fixed_uvalue_t)value.val));
+        }
+
+        constexpr fixed operator+() const { return *this; }
+
+        /// fixed_add
+        friend constexpr fixed operator+(fixed a, fixed b)
+        {
+#if defined(CONFIG_FPA_SATURATE)
+            return from_raw(saturate((int64_t)a.value.val + b.value.val));
+#else
+            return from_raw((fixed_value_t)((fixed_uvalue_t)a.value.val + (fixed_uvalue_t)b.value.val));
+#endif
+        }
+
+        /// fixed_sub
+        friend constexpr fixed operator-(fixed a, fixed b)
+        {
+#if defined(CONFIG_FPA_SATURATE)
+            return from_raw(saturate((int64_t)a.value.val - b.value.val));
+#else
+            return from_raw((fixed_value_t)((fixed_uvalue_t)a.value.val - (fixed_uvalue_t)b.value.val));
+#endif
+        }
+
+        /// fixed_mul
+        friend constexpr fixed operator*(fixed a, fixed b)
+        {
+#if defined(CONFIG_FPA_SATURATE)
+            return from_raw(saturate(((int64_t)a.value.val * b.value.val) >> FIXED_WIDTH));
+#else
+            return from_raw((fixed_value_t)(((int64_t)a.value.val * b.value.val) >> FIXED_WIDTH));
+#endif
+        }
+
+        /// fixed_div
+        friend constexpr fixed operator/(fixed a, fixed b)
+        {
+            return from_raw((fixed_value_t)((int64_t)a.value.val * ((int64_t)1 << FIXED_WIDTH) / b.value.val));
+        }
+
+        /// fixed_move_left
+        friend constexpr fixed operator<<(fixed a, uint32_t bits)
+        {
+            return from_raw((fixed_value_t)((fixed_uvalue_t)a.value.val << bits));
+        }
+
+        /// fixed_move_right
+        friend constexpr fixed operator>>(fixed a, uint32_t bits)
+        {
+            return from_raw(a.value.val >> bits);
+        }
+
+        constexpr fixed &operator+=(fixed b) { return *this = *this + b; }
+        constexpr fixed &operator-=(fixed b) { return *this = *this - b; }
+        constexpr fixed &operator*=(fixed b) { return *this = *this * b; }
+        constexpr fixed &operator/=(fixed b) { return *this = *this / b; }
+        constexpr fixed &operator<<=(uint32_t bits) { return *this = *this << bits; }
+        constexpr fixed &operator>>=(uint32_t bits) { return *this = *this >> bits; }
+
+        friend constexpr bool operator==(fixed a, fixed b) { return a.value.val == b.value.val; }
+        friend constexpr bool operator!=(fixed a, fixed b) { return a.value.val != b.value.val; }
+        friend constexpr bool operator<(fixed a, fixed b) { return a.value.val < b.value.val; }
+        friend constexpr bool operator>(fixed a, fixed b) { return a.value.val > b.value.val; }
+        friend constexpr bool operator<=(fixed a, fixed b) { return a.value.val <= b.value.val; }
+        friend constexpr bool operator>=(fixed a, fixed b) { return a.value.val >= b.value.val; }
+    };
+
+    static_assert(sizeof(fixed) == sizeof(fixed_t), "fixed must be layout compatible with fixed_t");
+
+/******************************************************************************/
+/*                            CONSTANT DEFINITIONS                            */
+/******************************************************************************/
+
+    constexpr fixed fixed_zero = fixed::from_raw(0);
+    constexpr fixed fixed_one = fixed::from_int(1);
+    // truncated like FIXED_PI, FIXED_PI_DIV2 and FIXED_2PI, not rounded
+    constexpr fixed fixed_pi = fixed::from_raw((fixed_value_t)(3.1415926535897932384626433832795L * (1 << FIXED_WIDTH)));
+    constexpr fixed fixed_pi_div2 =
+        fixed::from_raw((fixed_value_t)(3.1415926535897932384626433832795L * (1 << (FIXED_WIDTH - 1))));
+    constexpr fixed fixed_2pi = fixed::from_raw((fixed_value_t)(3.1415926535897932384626433832795L * (2 << FIXED_WIDTH)));
+    constexpr fixed fixed_max_inf = fixed::from_raw(0x7FFFFFFF);
+    constexpr fixed fixed_min_ninf = fixed::from_raw((fixed_value_t)0x80000000u);
+    constexpr fixed fixed_eps = fixed::from_raw(1);
+
+    namespace literals
+    {
+        /// 1.25_fx
+        constexpr fixed operator""_fx(long double v)
+        {
+            return fixed::from_double(v);
+        }
+
+        /// 3_fx
+        constexpr fixed operator""_fx(unsigned long long v)
+        {
+            return fixed::from_int((int32_t)v);
+        }
+    } // namespace literals
+
+/******************************************************************************/
+/*                         PUBLIC FUNCTION DEFINITIONS                        */
+/******************************************************************************/
+
+    /// fixed_abs
+    constexpr fixed abs(fixed a) { return a < fixed_zero ? -a : a; }
+
+    /// fixed_min
+    constexpr fixed min(fixed a, fixed b) { return b < a ? b : a; }
+
+    /// fixed_max
+    constexpr fixed max(fixed a, fixed b) { return a < b ? b : a; }
+
+    inline fixed sqrt(fixed a) { return fixed_sqrt(a); }
+    inline fixed rsqrt(fixed a) { return fixed_rsqrt(a); }
+    inline fixed reciprocal(fixed a) { return fixed_reciprocal(a); }
+    inline fixed sin(fixed v) { return fixed_sin(v); }
+    inline fixed cos(fixed v) { return fixed_cos(v); }
+    inline fixed exp(fixed v) { return fixed_exp(v); }
+    inline fixed log(fixed v) { return fixed_log(v); }
+    inline fixed atan2(fixed y, fixed x) { return fixed_atan2(y, x); }
+    inline fixed hypot(fixed x, fixed y) { return fixed_hypot(x, y); }
+
+    inline void sincos(fixed v, fixed &sin_out, fixed &cos_out)
+    {
+        fixed_sincos(v, &sin_out.value, &cos_out.value);
+    }
+
+} // namespace libe15
+
+/******************************************************************************/
+/*                                 END OF FILE                                */
+/******************************************************************************/
+
+#endif //! #ifndef __LIBE15_FPA_HPP__
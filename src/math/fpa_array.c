@@ -0,0 +1,294 @@
+/**
+ * @file fpa_array.c
+ * @author simakeng (simakeng@outlook.com)
+ * @brief Array kernels of libe15 Fixed Point Arithmetic Library
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * the backend is picked at compile time from what the compiler targets:
+ * AVX2 (-mavx2), SSE4.1 (-msse4.1) on x86-64, ARMv7E-M DSP extension
+ * (-mcpu=cortex-m4 / m7), otherwise portable C. CONFIG_FPA_ARRAY_GENERIC
+ * forces portable C, so does CONFIG_FPA_SATURATE, the vector loops wrap.
+ */
+
+#include "fpa_array.h"
+#include <generated-conf.h>
+
+#if defined(CONFIG_FPA_ARRAY_GENERIC) || defined(CONFIG_FPA_SATURATE)
+// portable C only
+#elif defined(__x86_64__) && (defined(__AVX2__) || defined(__SSE4_1__))
+#include <immintrin.h>
+#define FPA_ARRAY_X86
+#elif defined(__ARM_FEATURE_DSP)
+#define FPA_ARRAY_ARM_DSP
+#endif
+
+/******************************************************************************/
+/*                            X86 VECTOR PRIMITIVES                           */
+/******************************************************************************/
+
+#if defined(FPA_ARRAY_X86)
+
+/**
+ * there is no 32 x 32 -> 64 multiply of all lanes, MUL_EPI32 only takes
+ * the even lanes. the odd lanes are shifted down and multiplied too, then
+ * bit 16..47 of each product (the fixed_mul result) are blended back.
+ * a logical 64bit shift is enough as only the low 32 bits are kept.
+ */
+#if defined(__AVX2__)
+
+typedef __m256i fixed_vec_t;
+
+#define FIXED_VEC_LANES 8
+#define fixed_vec_load(p) _mm256_loadu_si256((const __m256i *)(p))
+#define fixed_vec_store(p, v) _mm256_storeu_si256((__m256i *)(p), v)
+#define fixed_vec_set1(v) _mm256_set1_epi32(v)
+#define fixed_vec_add(a, b) _mm256_add_epi32(a, b)
+#define fixed_vec_add64(a, b) _mm256_add_epi64(a, b)
+#define fixed_vec_zero() _mm256_setzero_si256()
+#define fixed_vec_mul_even(a, b) _mm256_mul_epi32(a, b)
+#define fixed_vec_odd(a) _mm256_srli_epi64(a, 32)
+#define fixed_vec_blend_odd(even, odd)                                   \
+    _mm256_blend_epi32(_mm256_srli_epi64(even, FIXED_WIDTH),             \
+                       _mm256_slli_epi64(odd, 32 - FIXED_WIDTH), 0xAA)
+
+static const char fixed_array_backend_name[] = "avx2";
+
+static inline int64_t fixed_vec_hsum64(fixed_vec_t v)
+{
+    __m128i s = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return _mm_cvtsi128_si64(s) + _mm_extract_epi64(s, 1);
+}
+
+#else // SSE4.1
+
+typedef __m128i fixed_vec_t;
+
+#define FIXED_VEC_LANES 4
+#define fixed_vec_load(p) _mm_loadu_si128((const __m128i *)(p))
+#define fixed_vec_store(p, v) _mm_storeu_si128((__m128i *)(p), v)
+#define fixed_vec_set1(v) _mm_set1_epi32(v)
+#define fixed_vec_add(a, b) _mm_add_epi32(a, b)
+#define fixed_vec_add64(a, b) _mm_add_epi64(a, b)
+#define fixed_vec_zero() _mm_setzero_si128()
+#define fixed_vec_mul_even(a, b) _mm_mul_epi32(a, b)
+#define fixed_vec_odd(a) _mm_srli_epi64(a, 32)
+#define fixed_vec_blend_odd(even, odd)                                   \
+    _mm_blend_epi16(_mm_srli_epi64(even, FIXED_WIDTH),                   \
+                    _mm_slli_epi64(odd, 32 - FIXED_WIDTH), 0xCC)
+
+static const char fixed_array_backend_name[] = "sse4.1";
+
+static inline int64_t fixed_vec_hsum64(fixed_vec_t v)
+{
+    return _mm_cvtsi128_si64(v) + _mm_extract_epi64(v, 1);
+}
+
+#endif // ! #if defined(__AVX2__)
+
+static inline fixed_vec_t fixed_vec_mul(fixed_vec_t a, fixed_vec_t b)
+{
+    fixed_vec_t even = fixed_vec_mul_even(a, b);
+    fixed_vec_t odd = fixed_vec_mul_even(fixed_vec_odd(a), fixed_vec_odd(b));
+    return fixed_vec_blend_odd(even, odd);
+}
+
+/// both 64bit products of the lane pairs, added to acc
+static inline fixed_vec_t fixed_vec_mla64(fixed_vec_t acc, fixed_vec_t a, fixed_vec_t b)
+{
+    acc = fixed_vec_add64(acc, fixed_vec_mul_even(a, b));
+    return fixed_vec_add64(acc, fixed_vec_mul_even(fixed_vec_odd(a), fixed_vec_odd(b)));
+}
+
+#endif // ! #if defined(FPA_ARRAY_X86)
+
+/******************************************************************************/
+/*                            ARM DSP PRIMITIVES                              */
+/******************************************************************************/
+
+#if defined(FPA_ARRAY_ARM_DSP)
+
+static const char fixed_array_backend_name[] = "arm-dsp";
+
+/**
+ * SMULL, bit 16..47 of the 64bit product is the fixed_mul result.
+ * SMUAD and the other dual 16bit instructions only fit Q15 data, so the
+ * Q16.16 kernels are built on SMULL / SMLAL and unrolled by 4.
+ */
+static inline fixed_t fixed_smull(fixed_t a, fixed_t b)
+{
+    uint32_t lo, hi;
+    __asm__("smull %0, %1, %2, %3" : "=&r"(lo), "=&r"(hi) : "r"(a.val), "r"(b.val));
+    return (fixed_t){(fixed_value_t)((lo >> FIXED_WIDTH) | (hi << (32 - FIXED_WIDTH)))};
+}
+
+/// SMLAL, 64bit accumulate in a register pair
+static inline int64_t fixed_smlal(int64_t acc, fixed_value_t a, fixed_value_t b)
+{
+    uint32_t lo = (uint32_t)acc, hi = (uint32_t)((uint64_t)acc >> 32);
+    __asm__("smlal %0, %1, %2, %3" : "+r"(lo), "+r"(hi) : "r"(a), "r"(b));
+    return (int64_t)(((uint64_t)hi << 32) | lo);
+}
+
+#endif // ! #if defined(FPA_ARRAY_ARM_DSP)
+
+#if !defined(FPA_ARRAY_X86) && !defined(FPA_ARRAY_ARM_DSP)
+static const char fixed_array_backend_name[] = "generic";
+#endif
+
+/**
+ * same bits as fixed_mul(), with one 64bit product instead of the split
+ * multiply, so the compiler can vectorize the generic loops itself.
+ */
+static inline fixed_t fixed_mul_wide(fixed_t a, fixed_t b)
+{
+#if defined(CONFIG_FPA_SATURATE)
+    return fixed_mul_sat(a, b);
+#else
+    return (fixed_t){(fixed_value_t)(((int64_t)a.val * b.val) >> FIXED_WIDTH)};
+#endif
+}
+
+/******************************************************************************/
+/*                         PUBLIC FUNCTION DEFINITIONS                        */
+/******************************************************************************/
+
+const char *fixed_array_backend(void)
+{
+    return fixed_array_backend_name;
+}
+
+/**
+ * each kernel runs the vector (or unrolled) loop first, then finishes
+ * the last n % lanes elements, or all of them in the generic build,
+ * with the scalar functions.
+ */
+void fixed_add_array(fixed_t *dst, const fixed_t *a, const fixed_t *b, size_t n)
+{
+    size_t i = 0;
+#if defined(FPA_ARRAY_X86)
+    for (; i + FIXED_VEC_LANES <= n; i += FIXED_VEC_LANES)
+        fixed_vec_store(dst + i, fixed_vec_add(fixed_vec_load(a + i), fixed_vec_load(b + i)));
+#endif
+    for (; i < n; i++)
+        dst[i] = fixed_add(a[i], b[i]);
+}
+
+void fixed_mul_array(fixed_t *dst, const fixed_t *a, const fixed_t *b, size_t n)
+{
+    size_t i = 0;
+#if defined(FPA_ARRAY_X86)
+    for (; i + FIXED_VEC_LANES <= n; i += FIXED_VEC_LANES)
+        fixed_vec_store(dst + i, fixed_vec_mul(fixed_vec_load(a + i), fixed_vec_load(b + i)));
+#elif defined(FPA_ARRAY_ARM_DSP)
+    for (; i + 4 <= n; i += 4)
+    {
+        dst[i + 0] = fixed_smull(a[i + 0], b[i + 0]);
+        dst[i + 1] = fixed_smull(a[i + 1], b[i + 1]);
+        dst[i + 2] = fixed_smull(a[i + 2], b[i + 2]);
+        dst[i + 3] = fixed_smull(a[i + 3], b[i + 3]);
+    }
+#endif
+    for (; i < n; i++)
+        dst[i] = fixed_mul_wide(a[i], b[i]);
+}
+
+void fixed_scale_array(fixed_t *dst, const fixed_t *a, fixed_t k, size_t n)
+{
+    size_t i = 0;
+#if defined(FPA_ARRAY_X86)
+    fixed_vec_t vk = fixed_vec_set1(k.val);
+    for (; i + FIXED_VEC_LANES <= n; i += FIXED_VEC_LANES)
+        fixed_vec_store(dst + i, fixed_vec_mul(fixed_vec_load(a + i), vk));
+#elif defined(FPA_ARRAY_ARM_DSP)
+    for (; i + 4 <= n; i += 4)
+    {
+        dst[i + 0] = fixed_smull(a[i + 0], k);
+        dst[i + 1] = fixed_smull(a[i + 1], k);
+        dst[i + 2] = fixed_smull(a[i + 2], k);
+        dst[i + 3] = fixed_smull(a[i + 3], k);
+    }
+#endif
+    for (; i < n; i++)
+        dst[i] = fixed_mul_wide(a[i], k);
+}
+
+/**
+ * the sum is kept in uint64_t, so overflow wraps the same way in every
+ * backend and the order of the additions does not change the result.
+ */
+int64_t fixed_dot_wide(const fixed_t *a, const fixed_t *b, size_t n)
+{
+    uint64_t sum = 0;
+    size_t i = 0;
+#if defined(FPA_ARRAY_X86)
+    fixed_vec_t acc = fixed_vec_zero();
+    for (; i + FIXED_VEC_LANES <= n; i += FIXED_VEC_LANES)
+        acc = fixed_vec_mla64(acc, fixed_vec_load(a + i), fixed_vec_load(b + i));
+    sum = (uint64_t)fixed_vec_hsum64(acc);
+#elif defined(FPA_ARRAY_ARM_DSP)
+    int64_t acc0 = 0, acc1 = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        acc0 = fixed_smlal(acc0, a[i + 0].val, b[i + 0].val);
+        acc1 = fixed_smlal(acc1, a[i + 1].val, b[i + 1].val);
+        acc0 = fixed_smlal(acc0, a[i + 2].val, b[i + 2].val);
+        acc1 = fixed_smlal(acc1, a[i + 3].val, b[i + 3].val);
+    }
+    sum = (uint64_t)acc0 + (uint64_t)acc1;
+#endif
+    for (; i < n; i++)
+        sum += (uint64_t)((int64_t)a[i].val * b[i].val);
+    return (int64_t)sum;
+}
+
+fixed_t fixed_dot(const fixed_t *a, const fixed_t *b, size_t n)
+{
+    int64_t sum = fixed_dot_wide(a, b, n);
+#if defined(CONFIG_FPA_SATURATE)
+    return (fixed_t){__fixed_clamp64(sum >> FIXED_WIDTH)};
+#else
+    return (fixed_t){(fixed_value_t)(uint32_t)((uint64_t)sum >> FIXED_WIDTH)};
+#endif
+}
+
+void fixed_axpy(fixed_t *y, fixed_t a, const fixed_t *x, size_t n)
+{
+    size_t i = 0;
+#if defined(FPA_ARRAY_X86)
+    fixed_vec_t va = fixed_vec_set1(a.val);
+    for (; i + FIXED_VEC_LANES <= n; i += FIXED_VEC_LANES)
+        fixed_vec_store(y + i, fixed_vec_add(fixed_vec_load(y + i),
+                                             fixed_vec_mul(fixed_vec_load(x + i), va)));
+#elif defined(FPA_ARRAY_ARM_DSP)
+    for (; i + 4 <= n; i += 4)
+    {
+        y[i + 0] = fixed_add(y[i + 0], fixed_smull(a, x[i + 0]));
+        y[i + 1] = fixed_add(y[i + 1], fixed_smull(a, x[i + 1]));
+        y[i + 2] = fixed_add(y[i + 2], fixed_smull(a, x[i + 2]));
+        y[i + 3] = fixed_add(y[i + 3], fixed_smull(a, x[i + 3]));
+    }
+#endif
+    for (; i < n; i++)
+        y[i] = fixed_add(y[i], fixed_mul_wide(a, x[i]));
+}
+
+void fixed_mac(fixed_t *acc, const fixed_t *a, const fixed_t *b, size_t n)
+{
+    size_t i = 0;
+#if defined(FPA_ARRAY_X86)
+    for (; i + FIXED_VEC_LANES <= n; i += FIXED_VEC_LANES)
+        fixed_vec_store(acc + i, fixed_vec_add(fixed_vec_load(acc + i),
+                                               fixed_vec_mul(fixed_vec_load(a + i), fixed_vec_load(b + i))));
+#elif defined(FPA_ARRAY_ARM_DSP)
+    for (; i + 4 <= n; i += 4)
+    {
+        acc[i + 0] = fixed_add(acc[i + 0], fixed_smull(a[i + 0], b[i + 0]));
+        acc[i + 1] = fixed_add(acc[i + 1], fixed_smull(a[i + 1], b[i + 1]));
+        acc[i + 2] = fixed_add(acc[i + 2], fixed_smull(a[i + 2], b[i + 2]));
+        acc[i + 3] = fixed_add(acc[i + 3], fixed_smull(a[i + 3], b[i + 3]));
+    }
+#endif
+    for (; i < n; i++)
+        acc[i] = fixed_add(acc[i], fixed_mul_wide(a[i], b[i]));
+}
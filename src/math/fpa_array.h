@@ -0,0 +1,147 @@
+/**
+ * @file fpa_array.h
+ * @author simakeng (simakeng@outlook.com)
+ * @brief Array kernels of libe15 Fixed Point Arithmetic Library
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * *****************************************************************************
+ * @copyright Copyright (C) E15 Studio 2024
+ *
+ * This program is FREE software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation.
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 675 Mass Ave, Cambridge, MA 02139, USA. Or you can visit the link below to
+ * read the license online, or you can find a copy of the license in the root
+ * directory of this project named "LICENSE" file.
+ *
+ * https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * *****************************************************************************
+ *
+ * @example
+ *  fixed_t samples[64], window[64];
+ *  fixed_mul_array(samples, samples, window, 64);
+ *  fixed_t energy = fixed_dot(samples, samples, 64);
+ *
+ * every kernel gives the same bits as the scalar functions in fpa.h
+ * (fixed_add, fixed_mul) applied one element at a time, whichever
+ * backend is compiled in. `dst` may be the same array as an input.
+ */
+
+/******************************************************************************/
+/*                               INCLUDE FILES                                */
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <libe15-fpa.h>
+
+/******************************************************************************/
+/*                              MACRO DEFINITIONS                             */
+/******************************************************************************/
+
+#ifndef __FPA_ARRAY_H__
+#define __FPA_ARRAY_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/******************************************************************************/
+/*                        PUBLIC FUNCTION DECLARATIONS                        */
+/******************************************************************************/
+
+/**
+ * @brief name of the compiled in backend, "avx2", "sse4.1", "arm-dsp"
+ *        or "generic"
+ * @return const char* backend name
+ */
+const char *fixed_array_backend(void);
+
+/**
+ * @brief dst[i] = a[i] + b[i]
+ * @param dst output array, n elements
+ * @param a operand array a
+ * @param b operand array b
+ * @param n number of elements
+ */
+void fixed_add_array(fixed_t *dst, const fixed_t *a, const fixed_t *b, size_t n);
+
+/**
+ * @brief dst[i] = a[i] * b[i]
+ * @param dst output array, n elements
+ * @param a operand array a
+ * @param b operand array b
+ * @param n number of elements
+ */
+void fixed_mul_array(fixed_t *dst, const fixed_t *a, const fixed_t *b, size_t n);
+
+/**
+ * @brief dst[i] = a[i] * k
+ * @param dst output array, n elements
+ * @param a operand array a
+ * @param k scale factor
+ * @param n number of elements
+ */
+void fixed_scale_array(fixed_t *dst, const fixed_t *a, fixed_t k, size_t n);
+
+/**
+ * @brief sum of a[i] * b[i]
+ * @note the products are summed at full 64bit precision and shifted
+ *       once at the end, so the result is more accurate than adding
+ *       fixed_mul() results, and does not depend on the backend.
+ *       it wraps like fixed_add() if the sum does not fit fixed_t.
+ * @param a operand array a
+ * @param b operand array b
+ * @param n number of elements
+ * @return fixed_t the dot product
+ */
+fixed_t fixed_dot(const fixed_t *a, const fixed_t *b, size_t n);
+
+/**
+ * @brief sum of a[i] * b[i] before the final shift of fixed_dot()
+ * @note for callers that round or scale the sum themselves, e.g. FIR
+ *       filters. it wraps modulo 2^64.
+ * @param a operand array a
+ * @param b operand array b
+ * @param n number of elements
+ * @return int64_t the sum, with 2 * FIXED_WIDTH fraction bits
+ */
+int64_t fixed_dot_wide(const fixed_t *a, const fixed_t *b, size_t n);
+
+/**
+ * @brief y[i] = y[i] + a * x[i]
+ * @param y input and output array, n elements
+ * @param a scale factor
+ * @param x operand array x
+ * @param n number of elements
+ */
+void fixed_axpy(fixed_t *y, fixed_t a, const fixed_t *x, size_t n);
+
+/**
+ * @brief acc[i] = acc[i] + a[i] * b[i]
+ * @param acc input and output array, n elements
+ * @param a operand array a
+ * @param b operand array b
+ * @param n number of elements
+ */
+void fixed_mac(fixed_t *acc, const fixed_t *a, const fixed_t *b, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+/******************************************************************************/
+/*                                 END OF FILE                                */
+/******************************************************************************/
+
+#endif //! #ifndef __FPA_ARRAY_H__
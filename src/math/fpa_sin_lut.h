@@ -0,0 +1,129 @@
+/**
+ * @file fpa_sin_lut.h
+ * @author simakeng (simakeng@outlook.com)
+ * @brief Lookup of the quarter-wave sine table, shared by the table backend
+ *        of fpa.c and the table report of tools/cordic
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * *****************************************************************************
+ * @copyright Copyright (C) E15 Studio 2024
+ *
+ * This program is FREE software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation.
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 675 Mass Ave, Cambridge, MA 02139, USA. Or you can visit the link below to
+ * read the license online, or you can find a copy of the license in the root
+ * directory of this project named "LICENSE" file.
+ *
+ * https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * *****************************************************************************
+ *
+ * the table layout is a parameter here, fpa.c passes the constants of the
+ * generated table so the compiler folds them, the report of tools/cordic
+ * passes every layout at runtime. both measure the same code this way.
+ *
+ * this header only needs <stdint.h>, so the generator builds without a
+ * configured tree.
+ */
+
+/******************************************************************************/
+/*                               INCLUDE FILES                                */
+/******************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************/
+/*                              MACRO DEFINITIONS                             */
+/******************************************************************************/
+
+#ifndef __FPA_SIN_LUT_H__
+#define __FPA_SIN_LUT_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// fraction bits of the lookup result, the same as fixed_t
+#define FPA_SIN_LUT_OUT_Q 16
+
+/******************************************************************************/
+/*                        PUBLIC FUNCTION DEFINITIONS                         */
+/******************************************************************************/
+
+/**
+ * @brief table entry `k` in Q30
+ * @note a multiply instead of a left shift, the first guard entry is
+ *       negative.
+ * @param lut int16_t table if q is 15, int32_t table otherwise
+ * @param q fraction bits of the table entries
+ * @param k entry index
+ * @return int64_t entry k in Q30
+ */
+static inline int64_t __fpa_sin_lut_entry(const void *lut, int q, uint32_t k)
+{
+    int32_t v = q == 15 ? ((const int16_t *)lut)[k] : ((const int32_t *)lut)[k];
+    return (int64_t)v * ((int64_t)1 << (30 - q));
+}
+
+/**
+ * @brief sine of a 32bit binary angle from a quarter-wave table
+ * @note table entry `k` holds sin((k - 1) * (π/2) / 2^bits), the first and
+ *       the last entry are guard points so the neighbours used by the
+ *       interpolation are always in the table. the interpolation runs in
+ *       Q30 whatever the table format is and rounds once at the end.
+ * @param lut int16_t table if q is 15, int32_t table otherwise
+ * @param bits log2 of the intervals per quarter wave
+ * @param q fraction bits of the table entries, 15 or 30
+ * @param quadratic 0 for linear, otherwise quadratic interpolation
+ * @param phase angle, 2^32 per turn
+ * @return int32_t sin(phase) in Q16
+ */
+static inline int32_t fpa_sin_lut_lookup(const void *lut, int bits, int q, int quadratic, uint32_t phase)
+{
+    int fb = 30 - bits;
+    uint32_t quadrant = phase >> 30;
+    uint32_t p = phase & 0x3FFFFFFFu;
+
+    // sin(π - v) = sin(v)
+    if (quadrant & 1)
+        p = 0x40000000u - p;
+
+    uint32_t idx = (p >> fb) + 1;
+    int64_t frac = p & ((1u << fb) - 1);
+    int64_t y0 = __fpa_sin_lut_entry(lut, q, idx);
+    int64_t y1 = __fpa_sin_lut_entry(lut, q, idx + 1);
+    int64_t y;
+
+    if (quadratic)
+    {
+        int64_t ym1 = __fpa_sin_lut_entry(lut, q, idx - 1);
+        y = y0 + (((y1 - ym1) * frac) >> (fb + 1));
+        y += ((((y1 - 2 * y0 + ym1) * frac) >> fb) * frac) >> (fb + 1);
+    }
+    else
+        y = y0 + (((y1 - y0) * frac) >> fb);
+
+    int32_t val = (int32_t)((y + (1 << (29 - FPA_SIN_LUT_OUT_Q))) >> (30 - FPA_SIN_LUT_OUT_Q));
+
+    // sin(v + π) = -sin(v)
+    return quadrant & 2 ? -val : val;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/******************************************************************************/
+/*                                 END OF FILE                                */
+/******************************************************************************/
+
+#endif //! #ifndef __FPA_SIN_LUT_H__
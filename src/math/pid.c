@@ -1,4 +1,13 @@
+#include <stdlib.h>
+#include <string.h>
+
 #include "libe15-pid.h"
+#include <generated-conf.h>
+
+#if !defined(CONFIG_FPA_ARRAY_GENERIC) && defined(__x86_64__) && defined(__AVX2__)
+#include <immintrin.h>
+#define PID_BANK_AVX2
+#endif
 
 void pid_init_controller(fixed_t kp, fixed_t ki, fixed_t kd, pid_state_t *pstate)
 {
@@ -26,7 +35,8 @@ void pid_reset_controller(pid_state_t *pstate)
 void pid_update_controller(pid_state_t *pstate, fixed_t error_observation)
 {
     // pstate->error_i += error_observation;
-    pstate->error_i = fixed_add(pstate->error_i, error_observation);
+    // clamped, a wrapped integrator flips the sign of the output
+    pstate->error_i = fixed_add_sat(pstate->error_i, error_observation);
 
     // pstate->error_d = error_observation - pstate->error;
     pstate->error_d = fixed_sub(error_observation, pstate->error);
@@ -34,9 +44,9 @@ void pid_update_controller(pid_state_t *pstate, fixed_t error_observation)
     pstate->error = error_observation;
 
     fixed_t t = fixed_from_int(0);
-    t = fixed_add(fixed_mul(pstate->kp, pstate->error), t);
-    t = fixed_add(fixed_mul(pstate->ki, pstate->error_i), t);
-    t = fixed_add(fixed_mul(pstate->kd, pstate->error_d), t);
+    t = fixed_mac_sat(t, pstate->kp, pstate->error);
+    t = fixed_mac_sat(t, pstate->ki, pstate->error_i);
+    t = fixed_mac_sat(t, pstate->kd, pstate->error_d);
 
     pstate->output = t;
 
@@ -45,4 +55,311 @@ void pid_update_controller(pid_state_t *pstate, fixed_t error_observation)
         pstate->callback(pstate, t);
 
     return;
-}
\ No newline at end of file
+}
+
+void pid_bank_init(pid_bank_t *bank, fixed_t *storage, uint32_t count)
+{
+    bank->kp = storage;
+    bank->ki = storage + count;
+    bank->kd = storage + 2 * count;
+    bank->error = storage + 3 * count;
+    bank->error_i = storage + 4 * count;
+    bank->output = storage + 5 * count;
+    bank->count = count;
+
+    bank->callback = NULL;
+
+    memset(storage, 0, PID_BANK_STORAGE_WORDS(count) * sizeof(fixed_t));
+}
+
+void pid_bank_set_gains(pid_bank_t *bank, uint32_t index, fixed_t kp, fixed_t ki, fixed_t kd)
+{
+    bank->kp[index] = kp;
+    bank->ki[index] = ki;
+    bank->kd[index] = kd;
+}
+
+void pid_bank_reset(pid_bank_t *bank)
+{
+    // error, error_i and output are one block
+    memset(bank->error, 0, 3 * bank->count * sizeof(fixed_t));
+
+    // call callback;
+    if (bank->callback != NULL)
+        bank->callback(bank, bank->output, bank->count);
+}
+
+void pid_bank_set_callback(pid_bank_t *bank, pid_bank_callback_t callback)
+{
+    bank->callback = callback;
+}
+
+#if defined(PID_BANK_AVX2)
+
+/// select the int32_t lanes of b where the sign bit of mask is set
+static inline __m256i pid_bank_select(__m256i a, __m256i b, __m256i mask)
+{
+    return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b),
+                                                _mm256_castsi256_ps(mask)));
+}
+
+/// fixed_add_sat() on 8 lanes
+static inline __m256i pid_bank_add_sat(__m256i a, __m256i b)
+{
+    __m256i res = _mm256_add_epi32(a, b);
+    __m256i overflow = _mm256_and_si256(_mm256_xor_si256(a, res), _mm256_xor_si256(b, res));
+    __m256i limit = _mm256_xor_si256(_mm256_srai_epi32(a, 31), _mm256_set1_epi32(INT32_MAX));
+    return pid_bank_select(res, limit, overflow);
+}
+
+/// fixed_sub() on 8 lanes
+static inline __m256i pid_bank_sub(__m256i a, __m256i b)
+{
+    __m256i res = _mm256_sub_epi32(a, b);
+#if defined(CONFIG_FPA_SATURATE)
+    __m256i overflow = _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(a, res));
+    __m256i limit = _mm256_xor_si256(_mm256_srai_epi32(a, 31), _mm256_set1_epi32(INT32_MAX));
+    res = pid_bank_select(res, limit, overflow);
+#endif
+    return res;
+}
+
+/**
+ * @brief __fixed_clamp64(acc >> FIXED_WIDTH) of 4 int64_t lanes, the
+ *        result is in the low half of each lane. there is no 64bit
+ *        arithmetic shift, the logical one gives the same low half.
+ */
+static inline __m256i pid_bank_narrow(__m256i acc)
+{
+    const __m256i hi = _mm256_set1_epi64x(((int64_t)1 << (FIXED_WIDTH + 31)) - 1);
+    const __m256i lo = _mm256_set1_epi64x(-((int64_t)1 << (FIXED_WIDTH + 31)));
+    __m256i v = _mm256_srli_epi64(acc, FIXED_WIDTH);
+    v = _mm256_blendv_epi8(v, _mm256_set1_epi64x(INT32_MAX), _mm256_cmpgt_epi64(acc, hi));
+    return _mm256_blendv_epi8(v, _mm256_set1_epi64x(0x80000000u), _mm256_cmpgt_epi64(lo, acc));
+}
+
+/// kp * e + ki * error_i + kd * error_d + 0.5 of the even int32_t lanes
+static inline __m256i pid_bank_sum(__m256i kp, __m256i e, __m256i ki, __m256i error_i, __m256i kd,
+                                   __m256i error_d)
+{
+    __m256i acc = _mm256_add_epi64(_mm256_mul_epi32(kp, e), _mm256_mul_epi32(ki, error_i));
+    acc = _mm256_add_epi64(acc, _mm256_mul_epi32(kd, error_d));
+    return _mm256_add_epi64(acc, _mm256_set1_epi64x(1 << (FIXED_WIDTH - 1)));
+}
+
+#endif
+
+void pid_bank_update(pid_bank_t *bank, const fixed_t *error_observation)
+{
+    uint32_t i = 0;
+
+#if defined(PID_BANK_AVX2)
+    for (; i + 8 <= bank->count; i += 8)
+    {
+        __m256i e = _mm256_loadu_si256((const __m256i *)(error_observation + i));
+        __m256i error_i = pid_bank_add_sat(_mm256_loadu_si256((const __m256i *)(bank->error_i + i)), e);
+        __m256i error_d = pid_bank_sub(e, _mm256_loadu_si256((const __m256i *)(bank->error + i)));
+        __m256i kp = _mm256_loadu_si256((const __m256i *)(bank->kp + i));
+        __m256i ki = _mm256_loadu_si256((const __m256i *)(bank->ki + i));
+        __m256i kd = _mm256_loadu_si256((const __m256i *)(bank->kd + i));
+
+        // VPMULDQ multiplies the even lanes, the odd ones are shifted down
+        __m256i even = pid_bank_sum(kp, e, ki, error_i, kd, error_d);
+        __m256i odd = pid_bank_sum(_mm256_srli_epi64(kp, 32), _mm256_srli_epi64(e, 32),
+                                   _mm256_srli_epi64(ki, 32), _mm256_srli_epi64(error_i, 32),
+                                   _mm256_srli_epi64(kd, 32), _mm256_srli_epi64(error_d, 32));
+        __m256i out = _mm256_blend_epi32(pid_bank_narrow(even), _mm256_slli_epi64(pid_bank_narrow(odd), 32), 0xAA);
+
+        _mm256_storeu_si256((__m256i *)(bank->error + i), e);
+        _mm256_storeu_si256((__m256i *)(bank->error_i + i), error_i);
+        _mm256_storeu_si256((__m256i *)(bank->output + i), out);
+    }
+#endif
+
+    for (; i < bank->count; i++)
+    {
+        fixed_t e = error_observation[i];
+        fixed_t error_i = fixed_add_sat(bank->error_i[i], e);
+        fixed_t error_d = fixed_sub(e, bank->error[i]);
+
+        int64_t acc = (int64_t)bank->kp[i].val * e.val + (int64_t)bank->ki[i].val * error_i.val +
+                      (int64_t)bank->kd[i].val * error_d.val + (1 << (FIXED_WIDTH - 1));
+
+        bank->error[i] = e;
+        bank->error_i[i] = error_i;
+        bank->output[i].val = __fixed_clamp64(acc >> FIXED_WIDTH);
+    }
+
+    // call callback;
+    if (bank->callback != NULL)
+        bank->callback(bank, bank->output, bank->count);
+}
+
+/// coefficients of pid_incr_t stay below this, the sums keep 2 bits of headroom
+#define PID_INCR_COEFF_MAX ((int64_t)1 << 29)
+
+/// upper limit of pid_incr_t::frac, so the output state fits 64bit with headroom
+#define PID_INCR_FRAC_MAX 28
+
+/// num / den in Q30, for num <= den
+static int32_t pid_ratio_q30(uint64_t num, uint64_t den)
+{
+    // keep num << 30 inside 64bit
+    while (num >= ((uint64_t)1 << 33))
+    {
+        num >>= 1;
+        den >>= 1;
+    }
+    return (int32_t)((num << 30) / den);
+}
+
+/// a Q32 value to Q(frac), rounded to nearest
+static int32_t pid_incr_coeff(int64_t q32, int32_t frac)
+{
+    int shift = 32 - frac;
+    return (int32_t)((q32 + ((int64_t)1 << (shift - 1))) >> shift);
+}
+
+error_t pid_incr_init(pid_incr_t *pid, fixed_t kp, fixed_t ki, fixed_t kd, uint32_t rate_hz,
+                      uint32_t d_cutoff_hz, fixed_t out_min, fixed_t out_max)
+{
+    if (pid == NULL || rate_hz == 0)
+        return E_INVALID_ARGUMENT;
+
+    // gains in Q32, Ts = 1 / rate_hz
+    int64_t kp_q32 = (int64_t)kp.val << 16;
+    int64_t ki_ts_q32 = ((int64_t)ki.val << 16) / (int64_t)rate_hz;
+    int64_t kd_fs = (int64_t)kd.val * rate_hz;
+    int64_t limit = (int64_t)1 << 46;
+    int64_t kd_fs_q32 = (kd_fs > limit ? limit : kd_fs < -limit ? -limit : kd_fs) << 16;
+
+    // g = Ts / (Tf + Ts) = w / (w + 1 / Ts), w = 2π d_cutoff_hz
+    uint64_t w_q16 = (uint64_t)FIXED_2PI.val * d_cutoff_hz;
+    int32_t g_q30 = d_cutoff_hz == 0 ? (1 << 30) : pid_ratio_q30(w_q16, w_q16 + ((uint64_t)rate_hz << 16));
+
+    // kd / (Tf + Ts) = kd / Ts * g
+    int64_t beta_q32 = (kd_fs_q32 >> 30) * g_q30 + (((kd_fs_q32 & ((1 << 30) - 1)) * g_q30) >> 30);
+    int64_t b0_q32 = kp_q32 + ki_ts_q32;
+
+    // the most fraction bits the largest coefficient allows
+    int64_t max = llabs(b0_q32);
+    max = llabs(kp_q32) > max ? llabs(kp_q32) : max;
+    max = llabs(beta_q32) > max ? llabs(beta_q32) : max;
+    int32_t frac = PID_INCR_FRAC_MAX;
+    while (frac > 0 && (max >> (32 - frac)) >= PID_INCR_COEFF_MAX)
+        frac--;
+
+    pid->b0 = pid_incr_coeff(b0_q32, frac);
+    pid->b1 = pid_incr_coeff(-kp_q32, frac);
+    pid->beta = pid_incr_coeff(beta_q32, frac);
+    pid->alpha = (1 << 30) - g_q30;
+    pid->frac = frac;
+    pid->u_min = (int64_t)out_min.val * ((int64_t)1 << frac);
+    pid->u_max = (int64_t)out_max.val * ((int64_t)1 << frac);
+
+    pid_incr_reset(pid, FIXED_ZERO);
+    return ALL_OK;
+}
+
+void pid_incr_reset(pid_incr_t *pid, fixed_t output)
+{
+    int64_t u = (int64_t)output.val * ((int64_t)1 << pid->frac);
+    pid->u = u < pid->u_min ? pid->u_min : u > pid->u_max ? pid->u_max : u;
+    pid->error = FIXED_ZERO;
+    pid->deriv = FIXED_ZERO;
+    pid->output.val = (fixed_value_t)(pid->u >> pid->frac);
+}
+
+fixed_t pid_incr_update(pid_incr_t *pid, fixed_t error_observation)
+{
+    fixed_value_t e = error_observation.val;
+    fixed_value_t de = fixed_sub_sat(error_observation, pid->error).val;
+    int64_t half = ((int64_t)1 << pid->frac) >> 1;
+
+    // first order low pass on kd (e - e[-1]) / Ts
+    fixed_value_t deriv = __fixed_clamp64((((int64_t)pid->alpha * pid->deriv.val + (1 << 29)) >> 30) +
+                                          (((int64_t)pid->beta * de + half) >> pid->frac));
+
+    int64_t u = pid->u + (int64_t)pid->b0 * e + (int64_t)pid->b1 * pid->error.val +
+                ((int64_t)deriv - pid->deriv.val) * ((int64_t)1 << pid->frac);
+
+    // clamping the output state is the anti windup, the integral part
+    // stops growing at the limit and leaves it on the first step back
+    u = u > pid->u_max ? pid->u_max : u;
+    u = u < pid->u_min ? pid->u_min : u;
+
+    pid->u = u;
+    pid->error = error_observation;
+    pid->deriv.val = deriv;
+    pid->output.val = (fixed_value_t)((u + half) >> pid->frac);
+    return pid->output;
+}
+
+void pid_cascade_stage_init(pid_cascade_stage_t *stage, pid_state_t *pid, pid_cascade_measure_t measure,
+                            uint32_t divider, uint32_t phase)
+{
+    memset(stage, 0, sizeof(pid_cascade_stage_t));
+    stage->pid = pid;
+    stage->measure = measure;
+    stage->divider = divider == 0 ? 1 : divider;
+    stage->countdown = phase % stage->divider + 1;
+}
+
+void pid_cascade_init(pid_cascade_t *cascade, pid_cascade_stage_t *stages, uint32_t count,
+                      pid_cascade_clock_t clock)
+{
+    cascade->stages = stages;
+    cascade->count = count;
+    cascade->clock = clock;
+}
+
+void pid_cascade_set_setpoint(pid_cascade_t *cascade, fixed_t setpoint)
+{
+    cascade->stages[0].setpoint = setpoint;
+}
+
+fixed_t pid_cascade_tick(pid_cascade_t *cascade)
+{
+    if (cascade->count == 0)
+        return FIXED_ZERO;
+
+    pid_cascade_stage_t *stage = cascade->stages;
+    pid_cascade_stage_t *last = stage + cascade->count - 1;
+
+    for (; stage <= last; stage++)
+    {
+        if (--stage->countdown != 0)
+            continue;
+        stage->countdown = stage->divider;
+
+        uint32_t start = cascade->clock != NULL ? cascade->clock() : 0;
+
+        fixed_t feedback = stage->measure(stage);
+        pid_update_controller(stage->pid, fixed_sub(stage->setpoint, feedback));
+        if (stage != last)
+            stage[1].setpoint = stage->pid->output;
+
+        if (cascade->clock != NULL)
+        {
+            uint32_t cycles = cascade->clock() - start;
+            stage->cycles_last = cycles;
+            stage->cycles_max = cycles > stage->cycles_max ? cycles : stage->cycles_max;
+            stage->cycles_total += cycles;
+        }
+        stage->runs++;
+    }
+
+    return last->pid->output;
+}
+
+void pid_cascade_clear_stats(pid_cascade_t *cascade)
+{
+    for (uint32_t i = 0; i < cascade->count; i++)
+    {
+        pid_cascade_stage_t *stage = &cascade->stages[i];
+        stage->runs = 0;
+        stage->cycles_last = 0;
+        stage->cycles_max = 0;
+        stage->cycles_total = 0;
+    }
+}
@@ -8,9 +8,13 @@
  *
  */
 
+#include <stdint.h>
+
+#include <libe15-errors.h>
 #include <libe15-fpa.h>
 
 struct __tag_pid_state_t;
+struct __tag_pid_bank_t;
 
 typedef void (*pid_update_callback_t)(struct __tag_pid_state_t *, fixed_t);
 
@@ -27,6 +31,99 @@ typedef struct __tag_pid_state_t
     pid_update_callback_t callback;
 } pid_state_t;
 
+/**
+ * incremental (velocity form) controller, each update adds
+ * kp (e - e[-1]) + ki Ts e + the change of a filtered derivative term
+ * to the output. the output is kept with `frac` extra fraction bits,
+ * so increments below 1 LSB of fixed_t still add up at high loop
+ * rates, and it is clamped to the output limits after each update,
+ * which also stops the windup.
+ */
+typedef struct
+{
+    int32_t b0;    ///< kp + ki Ts, Q(frac)
+    int32_t b1;    ///< -kp, Q(frac)
+    int32_t beta;  ///< kd / (Tf + Ts), Q(frac)
+    int32_t alpha; ///< Tf / (Tf + Ts), Q30
+    int32_t frac;  ///< fraction bits of b0, b1, beta and u
+    fixed_t error; ///< last error observation
+    fixed_t deriv; ///< filtered derivative term
+    fixed_t output;
+    int64_t u;     ///< output, Q(16 + frac)
+    int64_t u_min;
+    int64_t u_max;
+} pid_incr_t;
+
+struct __tag_pid_cascade_stage_t;
+
+/**
+ * @brief read the feedback of a cascade stage, only called when
+ *        the stage is due
+ */
+typedef fixed_t (*pid_cascade_measure_t)(struct __tag_pid_cascade_stage_t *);
+
+/**
+ * @brief a free running cycle counter for the timing of the stages,
+ *        e.g. DWT->CYCCNT on Cortex-M
+ */
+typedef uint32_t (*pid_cascade_clock_t)(void);
+
+/**
+ * one loop of a cascade. it runs every `divider` ticks of the cascade,
+ * the output becomes the setpoint of the next, inner, stage.
+ */
+typedef struct __tag_pid_cascade_stage_t
+{
+    pid_state_t *pid;
+    pid_cascade_measure_t measure;
+    void *user; ///< free for the measure callback
+
+    fixed_t setpoint;
+    uint32_t divider;
+    uint32_t countdown; ///< ticks until the next run
+
+    // execution time, in ticks of the clock
+    uint32_t runs;
+    uint32_t cycles_last;
+    uint32_t cycles_max;
+    uint64_t cycles_total;
+} pid_cascade_stage_t;
+
+/// a chain of stages, outermost first
+typedef struct
+{
+    pid_cascade_stage_t *stages;
+    uint32_t count;
+    pid_cascade_clock_t clock; ///< NULL for no timing
+} pid_cascade_t;
+
+/**
+ * @brief called once per pid_bank_update() with every output of the bank
+ */
+typedef void (*pid_bank_callback_t)(struct __tag_pid_bank_t *, const fixed_t *output, uint32_t count);
+
+/// fixed_t words of storage a bank of n controllers needs
+#define PID_BANK_STORAGE_WORDS(n) (6 * (n))
+
+/**
+ * a bank of controllers in struct of arrays layout, each field is an
+ * array with one entry per controller. pid_bank_update() runs all of
+ * them at once, 8 per step with AVX2. on Cortex-M each product is a
+ * SMULL / SMLAL and the integrator a QADD.
+ */
+typedef struct __tag_pid_bank_t
+{
+    fixed_t *kp;
+    fixed_t *ki;
+    fixed_t *kd;
+    fixed_t *error;   ///< last error observation
+    fixed_t *error_i; ///< integrated error, saturating
+    fixed_t *output;
+    uint32_t count;
+
+    pid_bank_callback_t callback;
+} pid_bank_t;
+
 
 /**
  * @brief Initialize a PID controler with following
@@ -126,3 +223,145 @@ void pid_clear_controller_callback(pid_state_t *pstate);
  * @param error_observation error observation value
  */
 void pid_update_controller(pid_state_t *pstate, fixed_t error_observation);
+
+/**
+ * @brief Initialize a bank of controllers, gains and
+ *        internal state set to 0.
+ *
+ * @param bank handler of the bank;
+ * @param storage PID_BANK_STORAGE_WORDS(count) words, the arrays of bank;
+ * @param count number of controllers
+ */
+void pid_bank_init(pid_bank_t *bank, fixed_t *storage, uint32_t count);
+
+/**
+ * @brief set the gains of one controller of a bank
+ *
+ * @param bank handler of the bank;
+ * @param index controller in the bank
+ * @param kp p-value of PID
+ * @param ki i-value of PID
+ * @param kd d-value of PID
+ */
+void pid_bank_set_gains(pid_bank_t *bank, uint32_t index, fixed_t kp, fixed_t ki, fixed_t kd);
+
+/**
+ * @brief reset every controller of a bank to zero state, gains
+ *        are kept. this function will generate a function call
+ *        to previous registed callback function.
+ * @param bank handler of the bank;
+ */
+void pid_bank_reset(pid_bank_t *bank);
+
+/**
+ * @brief register a callback to the bank, which will be called
+ *        once with all outputs when the bank get updated.
+ *
+ * @param bank handler of the bank;
+ * @param callback new callback, NULL to remove it
+ */
+void pid_bank_set_callback(pid_bank_t *bank, pid_bank_callback_t callback);
+
+/**
+ * @brief update every controller of a bank with its error observation
+ * @note the three products are summed at 64bit and rounded to nearest
+ *       once, then clamped, where pid_update_controller() truncates and
+ *       clamps after each product. without saturation the outputs of
+ *       the two are within 3 LSB, the results of the bank are the same
+ *       on every backend. the sum of the products has to stay below
+ *       2^31 in magnitude, far beyond the clamp at 32768.
+ * @param bank handler of the bank;
+ * @param error_observation count error observation values
+ */
+void pid_bank_update(pid_bank_t *bank, const fixed_t *error_observation);
+
+/**
+ * @brief Initialize an incremental controller, the division of
+ *        the coefficients is done here, internal state set to 0.
+ * @note Tf = 1 / (2π d_cutoff_hz) is the time constant of the first
+ *       order filter on the derivative term.
+ *
+ * @param pid handler of the controller;
+ * @param kp p-value of PID
+ * @param ki i-value of PID, per second
+ * @param kd d-value of PID, in seconds
+ * @param rate_hz update rate, 1 / Ts
+ * @param d_cutoff_hz cutoff of the derivative filter, 0 for no filter
+ * @param out_min lower output limit
+ * @param out_max upper output limit
+ * @return error_t E_INVALID_ARGUMENT if pid is NULL or rate_hz is 0
+ */
+error_t pid_incr_init(pid_incr_t *pid, fixed_t kp, fixed_t ki, fixed_t kd, uint32_t rate_hz,
+                      uint32_t d_cutoff_hz, fixed_t out_min, fixed_t out_max);
+
+/**
+ * @brief restart an incremental controller from a given output,
+ *        e.g. the one of the manual mode, so the switch is bumpless.
+ *
+ * @param pid handler of the controller;
+ * @param output output to continue from, clamped to the limits
+ */
+void pid_incr_reset(pid_incr_t *pid, fixed_t output);
+
+/**
+ * @brief using given error observation value to generate new
+ *        output of an incremental controller.
+ * @note two 32 x 32 -> 64 products for the output and two for the
+ *       derivative filter (SMLAL on Cortex-M), no division.
+ *
+ * @param pid handler of the controller;
+ * @param error_observation error observation value
+ * @return fixed_t the new output, within the limits
+ */
+fixed_t pid_incr_update(pid_incr_t *pid, fixed_t error_observation);
+
+/**
+ * @brief set up one stage of a cascade, execution time counters
+ *        set to 0.
+ *
+ * @param stage the stage;
+ * @param pid controller of the stage, updated with setpoint - feedback
+ * @param measure reads the feedback of the stage
+ * @param divider the stage runs every `divider` ticks, at least 1
+ * @param phase tick of the first run, below divider. stages with the
+ *        same divider and different phases never run in the same tick.
+ */
+void pid_cascade_stage_init(pid_cascade_stage_t *stage, pid_state_t *pid, pid_cascade_measure_t measure,
+                            uint32_t divider, uint32_t phase);
+
+/**
+ * @brief set up a cascade over stages set up by pid_cascade_stage_init()
+ *
+ * @param cascade the cascade;
+ * @param stages count stages, outermost first
+ * @param count number of stages, a cascade of 0 stages does nothing
+ * @param clock cycle counter for the execution time, NULL for none
+ */
+void pid_cascade_init(pid_cascade_t *cascade, pid_cascade_stage_t *stages, uint32_t count,
+                      pid_cascade_clock_t clock);
+
+/**
+ * @brief set the setpoint of the outermost stage
+ *
+ * @param cascade the cascade;
+ * @param setpoint new setpoint
+ */
+void pid_cascade_set_setpoint(pid_cascade_t *cascade, fixed_t setpoint);
+
+/**
+ * @brief run one tick of the cascade, e.g. in the timer interrupt of
+ *        the fastest loop. only the stages due in this tick are run,
+ *        outermost first, so a new output of an outer stage is used by
+ *        the inner stages in the same tick.
+ *
+ * @param cascade the cascade;
+ * @return fixed_t the output of the innermost stage, 0 without stages
+ */
+fixed_t pid_cascade_tick(pid_cascade_t *cascade);
+
+/**
+ * @brief clear the execution time counters of every stage
+ *
+ * @param cascade the cascade;
+ */
+void pid_cascade_clear_stats(pid_cascade_t *cascade);
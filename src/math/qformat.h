@@ -0,0 +1,278 @@
+/**
+ * @file qformat.h
+ * @author simakeng (simakeng@outlook.com)
+ * @brief Fixed point types in several Q formats, generated from one macro
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * *****************************************************************************
+ * @copyright Copyright (C) E15 Studio 2024
+ *
+ * This program is FREE software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation.
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 675 Mass Ave, Cambridge, MA 02139, USA. Or you can visit the link below to
+ * read the license online, or you can find a copy of the license in the root
+ * directory of this project named "LICENSE" file.
+ *
+ * https://www.gnu.org/licenses/gpl-3.0.html
+ *
+ * *****************************************************************************
+ *
+ */
+
+/******************************************************************************/
+/*                               INCLUDE FILES                                */
+/******************************************************************************/
+
+#include <stdint.h>
+
+#include <libe15-fpa.h>
+
+/******************************************************************************/
+/*                              MACRO DEFINITIONS                             */
+/******************************************************************************/
+
+#ifndef __QFORMAT_H__
+#define __QFORMAT_H__
+
+/**
+ * @brief define a fixed point type `name##_t` and its arithmetic.
+ *
+ * @param name prefix of the type and functions, like `q15`
+ * @param value_t storage type, int16_t, int32_t or int64_t
+ * @param width bit width of value_t, selects the multiply and divide
+ *        kernel of that width, so every format multiplies at its native
+ *        width instead of the split multiply `fixed_mul` uses.
+ * @param frac number of fraction bits
+ *
+ * like `fixed_t`, add, sub, mul and the integer conversions wrap on
+ * overflow, from_float clamps to the range like `fixed_from_float`.
+ * mul rounds toward -inf and div rounds toward 0.
+ */
+#define QFORMAT_DEFINE(name, value_t, width, frac)                           \
+    typedef struct                                                           \
+    {                                                                        \
+        value_t val;                                                         \
+    } name##_t;                                                              \
+                                                                             \
+    static inline name##_t name##_add(name##_t a, name##_t b)                \
+    {                                                                        \
+        return (name##_t){(value_t)(a.val + b.val)};                         \
+    }                                                                        \
+                                                                             \
+    static inline name##_t name##_sub(name##_t a, name##_t b)                \
+    {                                                                        \
+        return (name##_t){(value_t)(a.val - b.val)};                         \
+    }                                                                        \
+                                                                             \
+    static inline name##_t name##_mul(name##_t a, name##_t b)                \
+    {                                                                        \
+        return (name##_t){(value_t)__qformat_mul_##width(a.val, b.val, frac)}; \
+    }                                                                        \
+                                                                             \
+    static inline name##_t name##_div(name##_t a, name##_t b)                \
+    {                                                                        \
+        return (name##_t){(value_t)__qformat_div_##width(a.val, b.val, frac)}; \
+    }                                                                        \
+                                                                             \
+    static inline name##_t name##_from_int(int32_t v)                        \
+    {                                                                        \
+        return (name##_t){(value_t)((int64_t)v * ((int64_t)1 << (frac)))};   \
+    }                                                                        \
+                                                                             \
+    static inline int32_t name##_to_int(name##_t a)                          \
+    {                                                                        \
+        return (int32_t)(a.val >> (frac));                                   \
+    }                                                                        \
+                                                                             \
+    static inline name##_t name##_from_float(float v)                        \
+    {                                                                        \
+        const value_t max = (value_t)(((uint64_t)1 << ((width) - 1)) - 1);   \
+        float lim = (float)((uint64_t)1 << ((width) - 1));                   \
+        float s = v * (float)((int64_t)1 << (frac));                         \
+        if (s >= lim)                                                        \
+            return (name##_t){max};                                          \
+        if (s < -lim)                                                        \
+            return (name##_t){(value_t)(-max - 1)};                          \
+        return (name##_t){(value_t)s};                                       \
+    }                                                                        \
+                                                                             \
+    static inline float name##_to_float(name##_t a)                          \
+    {                                                                        \
+        return (float)a.val / (float)((int64_t)1 << (frac));                 \
+    }
+
+/**
+ * @brief define `dst##_from_##src`, converts between two formats with
+ *        one shift, 64bit wide in the middle so no bits are lost before
+ *        the final narrowing.
+ */
+#define QFORMAT_DEFINE_CONVERSION(dst, dst_value_t, dst_frac, src, src_frac) \
+    static inline dst##_t dst##_from_##src(src##_t v)                        \
+    {                                                                        \
+        int64_t val = v.val;                                                 \
+        if ((dst_frac) >= (src_frac))                                        \
+            val *= (int64_t)1 << ((dst_frac) >= (src_frac) ? (dst_frac) - (src_frac) : 0); \
+        else                                                                 \
+            val >>= ((src_frac) > (dst_frac) ? (src_frac) - (dst_frac) : 0); \
+        return (dst##_t){(dst_value_t)val};                                  \
+    }
+
+/******************************************************************************/
+/*                           NATIVE WIDTH KERNELS                             */
+/******************************************************************************/
+
+/// 16 x 16 -> 32, a single MUL (or SMULBB) on Cortex-M
+static inline int32_t __qformat_mul_16(int16_t a, int16_t b, uint32_t frac)
+{
+    return ((int32_t)a * b) >> frac;
+}
+
+static inline int32_t __qformat_div_16(int16_t a, int16_t b, uint32_t frac)
+{
+    return ((int32_t)a * (1 << frac)) / b;
+}
+
+/// 32 x 32 -> 64, a single SMULL on Cortex-M3 and above
+static inline int64_t __qformat_mul_32(int32_t a, int32_t b, uint32_t frac)
+{
+    return ((int64_t)a * b) >> frac;
+}
+
+static inline int64_t __qformat_div_32(int32_t a, int32_t b, uint32_t frac)
+{
+    return ((int64_t)a * ((int64_t)1 << frac)) / b;
+}
+
+#if defined(__SIZEOF_INT128__)
+
+/// 64 x 64 -> 128, 64bit hosts have it in hardware
+static inline int64_t __qformat_mul_64(int64_t a, int64_t b, uint32_t frac)
+{
+    return (int64_t)(((__int128)a * b) >> frac);
+}
+
+static inline int64_t __qformat_div_64(int64_t a, int64_t b, uint32_t frac)
+{
+    return (int64_t)(((__int128)a * ((__int128)1 << frac)) / b);
+}
+
+#else // 32bit cpus
+
+/**
+ * 64 x 64 -> 128 from four 32 x 32 -> 64 products, then the
+ * two's complement correction of the high half for signed operands.
+ * @note 0 < frac < 64
+ */
+static inline int64_t __qformat_mul_64(int64_t a, int64_t b, uint32_t frac)
+{
+    uint64_t ua = (uint64_t)a, ub = (uint64_t)b;
+    uint64_t a_lo = (uint32_t)ua, a_hi = ua >> 32;
+    uint64_t b_lo = (uint32_t)ub, b_hi = ub >> 32;
+
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t hi_hi = a_hi * b_hi;
+
+    uint64_t mid = (lo_lo >> 32) + (uint32_t)hi_lo + (uint32_t)lo_hi;
+    uint64_t lo = (mid << 32) | (uint32_t)lo_lo;
+    uint64_t hi = hi_hi + (hi_lo >> 32) + (lo_hi >> 32) + (mid >> 32);
+
+    if (a < 0)
+        hi -= ub;
+    if (b < 0)
+        hi -= ua;
+
+    return (int64_t)((lo >> frac) | (hi << (64 - frac)));
+}
+
+/**
+ * restoring division of the 128bit (|a| << frac) by |b|, one quotient
+ * bit per step. slow, but there is no 128bit divide to call.
+ * @note 0 < frac < 64
+ */
+static inline int64_t __qformat_div_64(int64_t a, int64_t b, uint32_t frac)
+{
+    uint64_t ua = a < 0 ? 0 - (uint64_t)a : (uint64_t)a;
+    uint64_t ub = b < 0 ? 0 - (uint64_t)b : (uint64_t)b;
+    uint64_t num_hi = ua >> (64 - frac);
+    uint64_t num_lo = ua << frac;
+    uint64_t rem = 0, quot = 0;
+    int i = 0;
+
+    for (i = 127; i >= 0; i--)
+    {
+        uint64_t carry = rem >> 63;
+        uint64_t bit = i >= 64 ? (num_hi >> (i - 64)) & 1 : (num_lo >> i) & 1;
+        rem = (rem << 1) | bit;
+        if (carry || rem >= ub)
+        {
+            rem -= ub;
+            if (i < 64)
+                quot |= (uint64_t)1 << i;
+        }
+    }
+
+    return (a < 0) != (b < 0) ? (int64_t)(0 - quot) : (int64_t)quot;
+}
+
+#endif // ! #if defined(__SIZEOF_INT128__)
+
+/******************************************************************************/
+/*                              TYPE DEFINITIONS                              */
+/******************************************************************************/
+
+/// Q15, [-1, 1), for audio rate filters
+QFORMAT_DEFINE(q15, int16_t, 16, 15)
+
+/// Q31, [-1, 1)
+QFORMAT_DEFINE(q31, int32_t, 32, 31)
+
+/// Q16.16, same layout as fixed_t
+QFORMAT_DEFINE(q16_16, int32_t, 32, 16)
+
+/// Q32.32, [-2^31, 2^31)
+QFORMAT_DEFINE(q32_32, int64_t, 64, 32)
+
+/******************************************************************************/
+/*                             FORMAT CONVERSIONS                             */
+/******************************************************************************/
+
+QFORMAT_DEFINE_CONVERSION(q15, int16_t, 15, q31, 31)
+QFORMAT_DEFINE_CONVERSION(q15, int16_t, 15, q16_16, 16)
+QFORMAT_DEFINE_CONVERSION(q15, int16_t, 15, q32_32, 32)
+QFORMAT_DEFINE_CONVERSION(q15, int16_t, 15, fixed, FIXED_WIDTH)
+
+QFORMAT_DEFINE_CONVERSION(q31, int32_t, 31, q15, 15)
+QFORMAT_DEFINE_CONVERSION(q31, int32_t, 31, q16_16, 16)
+QFORMAT_DEFINE_CONVERSION(q31, int32_t, 31, q32_32, 32)
+QFORMAT_DEFINE_CONVERSION(q31, int32_t, 31, fixed, FIXED_WIDTH)
+
+QFORMAT_DEFINE_CONVERSION(q16_16, int32_t, 16, q15, 15)
+QFORMAT_DEFINE_CONVERSION(q16_16, int32_t, 16, q31, 31)
+QFORMAT_DEFINE_CONVERSION(q16_16, int32_t, 16, q32_32, 32)
+QFORMAT_DEFINE_CONVERSION(q16_16, int32_t, 16, fixed, FIXED_WIDTH)
+
+QFORMAT_DEFINE_CONVERSION(q32_32, int64_t, 32, q15, 15)
+QFORMAT_DEFINE_CONVERSION(q32_32, int64_t, 32, q31, 31)
+QFORMAT_DEFINE_CONVERSION(q32_32, int64_t, 32, q16_16, 16)
+QFORMAT_DEFINE_CONVERSION(q32_32, int64_t, 32, fixed, FIXED_WIDTH)
+
+QFORMAT_DEFINE_CONVERSION(fixed, fixed_value_t, FIXED_WIDTH, q15, 15)
+QFORMAT_DEFINE_CONVERSION(fixed, fixed_value_t, FIXED_WIDTH, q31, 31)
+QFORMAT_DEFINE_CONVERSION(fixed, fixed_value_t, FIXED_WIDTH, q16_16, 16)
+QFORMAT_DEFINE_CONVERSION(fixed, fixed_value_t, FIXED_WIDTH, q32_32, 32)
+
+/******************************************************************************/
+/*                                 END OF FILE                                */
+/******************************************************************************/
+
+#endif //! #ifndef __QFORMAT_H__
@@ -31,7 +31,20 @@
 /*                               INCLUDE FILES                                */
 /******************************************************************************/
 
+#include <string.h>
+
 #include "random.h"
+#include <generated-conf.h>
+#include <ziggurat_table.h>
+
+#if !defined(CONFIG_FPA_ARRAY_GENERIC) && defined(__x86_64__)
+#include <immintrin.h>
+#if defined(__AVX2__)
+#define RAND_FILL_AVX2
+#else
+#define RAND_FILL_SSE2
+#endif
+#endif
 
 /******************************************************************************/
 /*                            CONSTANT DEFINITIONS                            */
@@ -41,6 +54,13 @@
 /*                              MACRO DEFINITIONS                             */
 /******************************************************************************/
 
+/// numbers of one step of all lanes in rand_fill_t
+#define RAND_FILL_BATCH (2 * RAND_FILL_LANES)
+
+/// rotate the 64bit lanes of x left by k, k a constant
+#define RAND_FILL_ROTL_AVX2(x, k) _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - (k)))
+#define RAND_FILL_ROTL_SSE2(x, k) _mm_or_si128(_mm_slli_epi64(x, k), _mm_srli_epi64(x, 64 - (k)))
+
 /******************************************************************************/
 /*                              TYPE DEFINITIONS                              */
 /******************************************************************************/
@@ -61,16 +81,413 @@
 /*                        PRIVATE FUNCTION DEFINITIONS                        */
 /******************************************************************************/
 
+/**
+ * @brief x mod the modulus of the LCG. 2^31 - 1 folds the bits above 31
+ *        back onto the low ones, 2^31 = 1 mod 2^31 - 1, twice for any
+ *        64bit x, and subtracts the modulus once at most.
+ */
+static inline uint32_t rand_lcg_reduce(const rand_lcg_t *lcg, uint64_t x)
+{
+    if (lcg->modulus != RAND_MINSTD_MODULUS)
+        return x % lcg->modulus;
+
+    x = (x & RAND_MINSTD_MODULUS) + (x >> 31);
+    x = (x & RAND_MINSTD_MODULUS) + (x >> 31);
+    return (uint32_t)(x >= RAND_MINSTD_MODULUS ? x - RAND_MINSTD_MODULUS : x);
+}
+
+static inline uint64_t rand_rotl64(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+/// a + u / 2^32 * (b - a), rounded down
+static inline fixed_t rand_uniform_scale(uint32_t u, fixed_t a, uint32_t range)
+{
+    return (fixed_t){(fixed_value_t)((uint32_t)a.val + (uint32_t)(((uint64_t)u * range) >> 32))};
+}
+
+/// (u1 - u2) / 2^32 * lsb, rounded toward 0 so both ends stay open
+static inline fixed_t rand_triangular_scale(uint64_t r, fixed_t lsb)
+{
+    int64_t t = (int64_t)(uint32_t)r - (int64_t)(r >> 32);
+    return (fixed_t){(fixed_value_t)(t * lsb.val / ((int64_t)1 << 32))};
+}
+
+/**
+ * @brief one Ziggurat draw from the 64bit number r. the low 7 bits pick
+ *        the layer, bit 7 is the sign and the top 32 bits the position
+ *        in the layer.
+ *
+ * @param x out: u / 2^32 * x_layer in Q16, without the sign
+ * @return 1 if x is inside the rectangle of the layer
+ */
+static inline int rand_normal_draw(uint64_t r, int32_t *x)
+{
+    uint32_t layer = (uint32_t)r & (RAND_ZIGGURAT_LAYERS - 1);
+    uint32_t u = (uint32_t)(r >> 32);
+    // Q29 -> Q16
+    *x = (int32_t)(((uint64_t)u * rand_ziggurat_w[layer] + ((uint64_t)1 << 44)) >> 45);
+    return u < rand_ziggurat_k[layer];
+}
+
+static inline int32_t rand_normal_sign(uint64_t r, int32_t x)
+{
+    return r & RAND_ZIGGURAT_LAYERS ? -x : x;
+}
+
+/**
+ * @brief the Ziggurat slow path, for the 2.7% of the draws outside the
+ *        rectangle of their layer: the tail beyond r for layer 0, the
+ *        wedge under f(x) otherwise, and new draws until one is accepted.
+ *
+ * @param r the draw
+ * @param x its value from rand_normal_draw()
+ * @return int32_t N(0, 1) in Q16
+ */
+static int32_t rand_normal_slow(rand_xoshiro256ss_t *rng, uint64_t r, int32_t x)
+{
+    for (;;)
+    {
+        uint32_t layer = (uint32_t)r & (RAND_ZIGGURAT_LAYERS - 1);
+        if (layer == 0)
+        {
+            // x = -ln(u1) / r until -2 ln(u2) > x^2
+            int32_t tail, y;
+            do
+            {
+                uint64_t t = rand_xoshiro256ss_next(rng);
+                fixed_t u1 = {(fixed_value_t)((t >> 48) + 1)};
+                fixed_t u2 = {(fixed_value_t)(((t >> 16) & 0xffff) + 1)};
+                tail = (int32_t)(((int64_t)-fixed_log(u1).val * RAND_ZIGGURAT_INV_R_Q32) >> 32);
+                y = -fixed_log(u2).val;
+            } while (2 * (int64_t)y < ((int64_t)tail * tail) >> FIXED_WIDTH);
+
+            return rand_normal_sign(r, RAND_ZIGGURAT_R_Q16 + tail);
+        }
+
+        // a uniform height between f(x_layer) and f(x_layer - 1)
+        uint32_t u = (uint32_t)(rand_xoshiro256ss_next(rng) >> 32);
+        uint32_t f_lo = rand_ziggurat_f[layer];
+        uint64_t y = (uint64_t)f_lo + (((uint64_t)u * (rand_ziggurat_f[layer - 1] - f_lo)) >> 32);
+        fixed_t density = fixed_exp((fixed_t){(fixed_value_t)-(((int64_t)x * x) >> (FIXED_WIDTH + 1))});
+        if (y < (uint64_t)(uint32_t)density.val << (31 - FIXED_WIDTH))
+            return rand_normal_sign(r, x);
+
+        r = rand_xoshiro256ss_next(rng);
+        if (rand_normal_draw(r, &x))
+            return rand_normal_sign(r, x);
+    }
+}
+
+/// N(0, 1) in Q16, the fast path is inline
+static inline int32_t rand_normal_q16(rand_xoshiro256ss_t *rng)
+{
+    int32_t x;
+    uint64_t r = rand_xoshiro256ss_next(rng);
+    if (rand_normal_draw(r, &x))
+        return rand_normal_sign(r, x);
+    return rand_normal_slow(rng, r, x);
+}
+
+/// mean + sigma * z, saturated
+static inline fixed_t rand_normal_scale(int32_t z, fixed_t mean, fixed_t sigma)
+{
+    int64_t v = (int64_t)mean.val + (((int64_t)z * sigma.val + (1 << (FIXED_WIDTH - 1))) >> FIXED_WIDTH);
+    return (fixed_t){__fixed_clamp64(v)};
+}
+
+#if defined(RAND_FILL_AVX2)
+
+/**
+ * @brief one xoshiro256** step of 4 lanes, the multiplies by 5 and 9 are
+ *        shifts and adds, AVX2 has no 64bit multiply.
+ */
+static inline __m256i rand_fill_step_avx2(__m256i s[4])
+{
+    __m256i r = _mm256_add_epi64(s[1], _mm256_slli_epi64(s[1], 2));
+    r = RAND_FILL_ROTL_AVX2(r, 7);
+    r = _mm256_add_epi64(r, _mm256_slli_epi64(r, 3));
+
+    __m256i t = _mm256_slli_epi64(s[1], 17);
+    s[2] = _mm256_xor_si256(s[2], s[0]);
+    s[3] = _mm256_xor_si256(s[3], s[1]);
+    s[1] = _mm256_xor_si256(s[1], s[2]);
+    s[0] = _mm256_xor_si256(s[0], s[3]);
+    s[2] = _mm256_xor_si256(s[2], t);
+    s[3] = RAND_FILL_ROTL_AVX2(s[3], 45);
+    return r;
+}
+
+#elif defined(RAND_FILL_SSE2)
+
+/// rand_fill_step_avx2() on 2 lanes
+static inline __m128i rand_fill_step_sse2(__m128i s[4])
+{
+    __m128i r = _mm_add_epi64(s[1], _mm_slli_epi64(s[1], 2));
+    r = RAND_FILL_ROTL_SSE2(r, 7);
+    r = _mm_add_epi64(r, _mm_slli_epi64(r, 3));
+
+    __m128i t = _mm_slli_epi64(s[1], 17);
+    s[2] = _mm_xor_si128(s[2], s[0]);
+    s[3] = _mm_xor_si128(s[3], s[1]);
+    s[1] = _mm_xor_si128(s[1], s[2]);
+    s[0] = _mm_xor_si128(s[0], s[3]);
+    s[2] = _mm_xor_si128(s[2], t);
+    s[3] = RAND_FILL_ROTL_SSE2(s[3], 45);
+    return r;
+}
+
+#endif
+
 /******************************************************************************/
 /*                      PUBLIC FUNCTION IMPLEMENTATIONS                       */
 /******************************************************************************/
 uint32_t rand_lcg_next(rand_lcg_t *lcg)
 {
-    uint64_t product = (uint64_t)lcg->multiplier * lcg->seed;
-    uint32_t result = (product + lcg->increment) % lcg->modulus;
+    uint64_t product = (uint64_t)lcg->multiplier * lcg->seed + lcg->increment;
+    uint32_t result = rand_lcg_reduce(lcg, product);
     lcg->seed = result;
     return result;
 }
+
+void rand_lcg_skip(rand_lcg_t *lcg, uint64_t n)
+{
+    // a^n and c (a^n - 1) / (a - 1), from the squares of the one step map
+    uint32_t mult = rand_lcg_reduce(lcg, lcg->multiplier);
+    uint32_t plus = rand_lcg_reduce(lcg, lcg->increment);
+    uint32_t acc_mult = rand_lcg_reduce(lcg, 1);
+    uint32_t acc_plus = 0;
+
+    for (; n; n >>= 1)
+    {
+        if (n & 1)
+        {
+            acc_mult = rand_lcg_reduce(lcg, (uint64_t)acc_mult * mult);
+            acc_plus = rand_lcg_reduce(lcg, (uint64_t)acc_plus * mult + plus);
+        }
+        plus = rand_lcg_reduce(lcg, (uint64_t)plus * mult + plus);
+        mult = rand_lcg_reduce(lcg, (uint64_t)mult * mult);
+    }
+    lcg->seed = rand_lcg_reduce(lcg, (uint64_t)acc_mult * lcg->seed + acc_plus);
+}
+
+uint64_t rand_splitmix64_next(rand_splitmix64_t *sm)
+{
+    uint64_t z = (sm->state += 0x9e3779b97f4a7c15u);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+    return z ^ (z >> 31);
+}
+
+void rand_xorshift128p_seed(rand_xorshift128p_t *rng, uint64_t seed)
+{
+    // splitmix64 never gives two zero words in a row
+    rand_splitmix64_t sm = {seed};
+    rng->s[0] = rand_splitmix64_next(&sm);
+    rng->s[1] = rand_splitmix64_next(&sm);
+}
+
+uint64_t rand_xorshift128p_next(rand_xorshift128p_t *rng)
+{
+    uint64_t s1 = rng->s[0];
+    const uint64_t s0 = rng->s[1];
+    const uint64_t result = s0 + s1;
+    rng->s[0] = s0;
+    s1 ^= s1 << 23;
+    rng->s[1] = s1 ^ s0 ^ (s1 >> 18) ^ (s0 >> 5);
+    return result;
+}
+
+void rand_xoshiro256ss_seed(rand_xoshiro256ss_t *rng, uint64_t seed)
+{
+    rand_splitmix64_t sm = {seed};
+    for (int i = 0; i < 4; i++)
+        rng->s[i] = rand_splitmix64_next(&sm);
+}
+
+uint64_t rand_xoshiro256ss_next(rand_xoshiro256ss_t *rng)
+{
+    uint64_t *s = rng->s;
+    const uint64_t result = rand_rotl64(s[1] * 5, 7) * 9;
+    const uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rand_rotl64(s[3], 45);
+    return result;
+}
+
+void rand_xoshiro256ss_jump(rand_xoshiro256ss_t *rng)
+{
+    // the characteristic polynomial of the 2^128 step, from the reference code
+    static const uint64_t jump[] = {0x180ec6d33cfd0abau, 0xd5a61266f0c9392cu,
+                                    0xa9582618e03fc9aau, 0x39abdc4529b1661cu};
+    uint64_t s[4] = {0, 0, 0, 0};
+
+    for (int i = 0; i < 4; i++)
+    {
+        for (int b = 0; b < 64; b++)
+        {
+            if (jump[i] & (uint64_t)1 << b)
+            {
+                s[0] ^= rng->s[0];
+                s[1] ^= rng->s[1];
+                s[2] ^= rng->s[2];
+                s[3] ^= rng->s[3];
+            }
+            rand_xoshiro256ss_next(rng);
+        }
+    }
+    memcpy(rng->s, s, sizeof(s));
+}
+
+void rand_pcg32_seed(rand_pcg32_t *rng, uint64_t seed, uint64_t stream)
+{
+    rng->state = 0;
+    rng->inc = (stream << 1) | 1;
+    rand_pcg32_next(rng);
+    rng->state += seed;
+    rand_pcg32_next(rng);
+}
+
+uint32_t rand_pcg32_next(rand_pcg32_t *rng)
+{
+    uint64_t old = rng->state;
+    rng->state = old * 6364136223846793005u + rng->inc;
+    uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+    uint32_t rot = (uint32_t)(old >> 59);
+    return (xorshifted >> rot) | (xorshifted << ((0u - rot) & 31));
+}
+
+void rand_fill_seed(rand_fill_t *rng, uint64_t seed)
+{
+    rand_xoshiro256ss_t lane;
+    rand_xoshiro256ss_seed(&lane, seed);
+    for (int l = 0; l < RAND_FILL_LANES; l++)
+    {
+        for (int i = 0; i < 4; i++)
+            rng->s[i][l] = lane.s[i];
+        rand_xoshiro256ss_jump(&lane);
+    }
+}
+
+void rand_fill_u32(rand_fill_t *rng, uint32_t *buf, size_t n)
+{
+    uint32_t tail[RAND_FILL_BATCH];
+
+#if defined(RAND_FILL_AVX2)
+    // lanes 0 - 3 and 4 - 7, two independent chains per step
+    __m256i a[4], b[4];
+    for (int i = 0; i < 4; i++)
+    {
+        a[i] = _mm256_loadu_si256((const __m256i *)&rng->s[i][0]);
+        b[i] = _mm256_loadu_si256((const __m256i *)&rng->s[i][4]);
+    }
+    while (n)
+    {
+        uint32_t *out = n >= RAND_FILL_BATCH ? buf : tail;
+        _mm256_storeu_si256((__m256i *)out, rand_fill_step_avx2(a));
+        _mm256_storeu_si256((__m256i *)(out + 8), rand_fill_step_avx2(b));
+#elif defined(RAND_FILL_SSE2)
+    __m128i a[4][4];
+    for (int v = 0; v < 4; v++)
+        for (int i = 0; i < 4; i++)
+            a[v][i] = _mm_loadu_si128((const __m128i *)&rng->s[i][2 * v]);
+    while (n)
+    {
+        uint32_t *out = n >= RAND_FILL_BATCH ? buf : tail;
+        for (int v = 0; v < 4; v++)
+            _mm_storeu_si128((__m128i *)(out + 4 * v), rand_fill_step_sse2(a[v]));
+#else
+    while (n)
+    {
+        uint32_t *out = n >= RAND_FILL_BATCH ? buf : tail;
+        for (int l = 0; l < RAND_FILL_LANES; l++)
+        {
+            rand_xoshiro256ss_t lane = {{rng->s[0][l], rng->s[1][l], rng->s[2][l], rng->s[3][l]}};
+            uint64_t r = rand_xoshiro256ss_next(&lane);
+            out[2 * l] = (uint32_t)r;
+            out[2 * l + 1] = (uint32_t)(r >> 32);
+            for (int i = 0; i < 4; i++)
+                rng->s[i][l] = lane.s[i];
+        }
+#endif
+        if (n < RAND_FILL_BATCH)
+        {
+            memcpy(buf, tail, n * sizeof(uint32_t));
+            break;
+        }
+        buf += RAND_FILL_BATCH;
+        n -= RAND_FILL_BATCH;
+    }
+
+#if defined(RAND_FILL_AVX2)
+    for (int i = 0; i < 4; i++)
+    {
+        _mm256_storeu_si256((__m256i *)&rng->s[i][0], a[i]);
+        _mm256_storeu_si256((__m256i *)&rng->s[i][4], b[i]);
+    }
+#elif defined(RAND_FILL_SSE2)
+    for (int v = 0; v < 4; v++)
+        for (int i = 0; i < 4; i++)
+            _mm_storeu_si128((__m128i *)&rng->s[i][2 * v], a[v][i]);
+#endif
+}
+
+fixed_t rand_uniform_fixed(rand_xoshiro256ss_t *rng, fixed_t a, fixed_t b)
+{
+    uint32_t range = (uint32_t)b.val - (uint32_t)a.val;
+    return rand_uniform_scale((uint32_t)(rand_xoshiro256ss_next(rng) >> 32), a, range);
+}
+
+void rand_uniform_fixed_fill(rand_xoshiro256ss_t *rng, fixed_t *buf, size_t n, fixed_t a, fixed_t b)
+{
+    // a local copy of the state stays in registers
+    rand_xoshiro256ss_t local = *rng;
+    uint32_t range = (uint32_t)b.val - (uint32_t)a.val;
+    size_t i = 0;
+
+    for (; i + 2 <= n; i += 2)
+    {
+        uint64_t r = rand_xoshiro256ss_next(&local);
+        buf[i] = rand_uniform_scale((uint32_t)(r >> 32), a, range);
+        buf[i + 1] = rand_uniform_scale((uint32_t)r, a, range);
+    }
+    if (i < n)
+        buf[i] = rand_uniform_scale((uint32_t)(rand_xoshiro256ss_next(&local) >> 32), a, range);
+    *rng = local;
+}
+
+fixed_t rand_normal_fixed(rand_xoshiro256ss_t *rng, fixed_t mean, fixed_t sigma)
+{
+    return rand_normal_scale(rand_normal_q16(rng), mean, sigma);
+}
+
+void rand_normal_fixed_fill(rand_xoshiro256ss_t *rng, fixed_t *buf, size_t n, fixed_t mean, fixed_t sigma)
+{
+    rand_xoshiro256ss_t local = *rng;
+    for (size_t i = 0; i < n; i++)
+        buf[i] = rand_normal_scale(rand_normal_q16(&local), mean, sigma);
+    *rng = local;
+}
+
+fixed_t rand_triangular_fixed(rand_xoshiro256ss_t *rng, fixed_t lsb)
+{
+    return rand_triangular_scale(rand_xoshiro256ss_next(rng), lsb);
+}
+
+void rand_triangular_fixed_fill(rand_xoshiro256ss_t *rng, fixed_t *buf, size_t n, fixed_t lsb)
+{
+    rand_xoshiro256ss_t local = *rng;
+    for (size_t i = 0; i < n; i++)
+        buf[i] = rand_triangular_scale(rand_xoshiro256ss_next(&local), lsb);
+    *rng = local;
+}
+
 /******************************************************************************/
 /*                     PRIVATE FUNCTION IMPLEMENTATIONS                       */
 /******************************************************************************/
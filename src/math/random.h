@@ -34,20 +34,28 @@
 #include <stddef.h>
 #include <stdbool.h>
 
+#include <libe15-fpa.h>
+
 /******************************************************************************/
 /*                              MACRO DEFINITIONS                             */
 /******************************************************************************/
 #ifndef __RANDOM_H__
 #define __RANDOM_H__
 
+/// the Mersenne prime 2^31 - 1 of MINSTD, reduced without a division
+#define RAND_MINSTD_MODULUS 2147483647u
+
 #define LCG_DEFAULT_INIT(_seed)         \
     ((linear_congruential_generator_t){ \
         .seed = (_seed),                \
         .multiplier = 48271,            \
         .increment = 0,                 \
-        .modulus = 2147483647,          \
+        .modulus = RAND_MINSTD_MODULUS, \
     })
 
+/// number of xoshiro256** streams in rand_fill_t
+#define RAND_FILL_LANES 8
+
 /******************************************************************************/
 /*                              TYPE DEFINITIONS                              */
 /******************************************************************************/
@@ -57,9 +65,20 @@
  *
  * @see https://en.wikipedia.org/wiki/Linear_congruential_generator
  *
+ * with modulus RAND_MINSTD_MODULUS, as in LCG_DEFAULT_INIT, the product
+ * is reduced with shifts and adds, any other modulus takes a 64bit `%`.
+ *
  * @example
  *  rand_lcg_t lcg = LCG_DEFAULT_INIT(12345678);
  *  uint32_t rand = rand_lcg_next(&lcg);
+ *
+ *  // 4 ISRs, each with its own 2^20 numbers of the same sequence
+ *  rand_lcg_t stream[4];
+ *  for (int i = 0; i < 4; i++)
+ *  {
+ *      stream[i] = LCG_DEFAULT_INIT(12345678);
+ *      rand_lcg_skip(&stream[i], (uint64_t)i << 20);
+ *  }
  */
 typedef struct
 {
@@ -71,6 +90,76 @@ typedef struct
 
 typedef linear_congruential_generator_t rand_lcg_t;
 
+/**
+ * @brief SplitMix64, used to turn one 64bit seed into the state words of
+ *        the generators below.
+ *
+ * @see https://prng.di.unimi.it/splitmix64.c
+ */
+typedef struct
+{
+    uint64_t state;
+} rand_splitmix64_t;
+
+/**
+ * @brief xorshift128+, two 64bit words of state, three shifts and one
+ *        add per number. the lowest bits are weak, use the high ones.
+ *
+ * @see https://prng.di.unimi.it/xorshift128plus.c
+ *
+ * @example
+ *  rand_xorshift128p_t rng;
+ *  rand_xorshift128p_seed(&rng, 12345678);
+ *  uint32_t rand = rand_xorshift128p_next(&rng) >> 32;
+ */
+typedef struct
+{
+    uint64_t s[2];
+} rand_xorshift128p_t;
+
+/**
+ * @brief xoshiro256**, four 64bit words of state, all 64 output bits
+ *        pass BigCrush. the general purpose choice of this file.
+ *
+ * @see https://prng.di.unimi.it/xoshiro256starstar.c
+ *
+ * @example
+ *  rand_xoshiro256ss_t rng;
+ *  rand_xoshiro256ss_seed(&rng, 12345678);
+ *  uint64_t rand = rand_xoshiro256ss_next(&rng);
+ */
+typedef struct
+{
+    uint64_t s[4];
+} rand_xoshiro256ss_t;
+
+/**
+ * @brief PCG32 (XSH RR), a 64bit LCG with a permuted 32bit output. one
+ *        64bit multiply per number, `inc` selects one of 2^63 streams.
+ *
+ * @see https://www.pcg-random.org/
+ *
+ * @example
+ *  rand_pcg32_t rng;
+ *  rand_pcg32_seed(&rng, 42, 54);
+ *  uint32_t rand = rand_pcg32_next(&rng);
+ */
+typedef struct
+{
+    uint64_t state;
+    uint64_t inc;
+} rand_pcg32_t;
+
+/**
+ * @brief RAND_FILL_LANES xoshiro256** streams for rand_fill_u32(), kept
+ *        lane by lane so a SIMD register steps several of them at once.
+ *        the streams are 2^128 numbers apart in the same sequence.
+ */
+typedef struct
+{
+    uint64_t s[4][RAND_FILL_LANES];
+} rand_fill_t;
+
 /******************************************************************************/
 /*                            CONSTANT DEFINITIONS                            */
 /******************************************************************************/
@@ -111,6 +200,181 @@ extern "C"
      */
     uint32_t rand_lcg_next(rand_lcg_t *lcg);
 
+    /**
+     * @brief Advance the LCG by n numbers in O(log n) steps.
+     *
+     * the state afterwards is the one of n rand_lcg_next() calls, so
+     * streams skipped by different amounts from one seed take disjoint
+     * parts of the sequence, the same ones on every run.
+     *
+     * @param lcg
+     * @param n number of numbers to skip
+     */
+    void rand_lcg_skip(rand_lcg_t *lcg, uint64_t n);
+
+    /**
+     * @brief Get the next random number from SplitMix64.
+     *
+     * @param sm
+     * @return uint64_t
+     */
+    uint64_t rand_splitmix64_next(rand_splitmix64_t *sm);
+
+    /**
+     * @brief Fill the state of a xorshift128+ from a 64bit seed.
+     *
+     * @param rng
+     * @param seed any value, 0 included
+     */
+    void rand_xorshift128p_seed(rand_xorshift128p_t *rng, uint64_t seed);
+
+    /**
+     * @brief Get the next random number from a xorshift128+.
+     *
+     * @param rng
+     * @return uint64_t
+     */
+    uint64_t rand_xorshift128p_next(rand_xorshift128p_t *rng);
+
+    /**
+     * @brief Fill the state of a xoshiro256** from a 64bit seed.
+     *
+     * @param rng
+     * @param seed any value, 0 included
+     */
+    void rand_xoshiro256ss_seed(rand_xoshiro256ss_t *rng, uint64_t seed);
+
+    /**
+     * @brief Get the next random number from a xoshiro256**.
+     *
+     * @param rng
+     * @return uint64_t
+     */
+    uint64_t rand_xoshiro256ss_next(rand_xoshiro256ss_t *rng);
+
+    /**
+     * @brief Advance a xoshiro256** by 2^128 numbers, the start of a
+     *        stream that does not overlap the current one.
+     *
+     * @param rng
+     */
+    void rand_xoshiro256ss_jump(rand_xoshiro256ss_t *rng);
+
+    /**
+     * @brief Seed a PCG32 the way pcg32_srandom_r() does.
+     *
+     * @param rng
+     * @param seed start state
+     * @param stream stream selector, only the low 63 bits are used
+     */
+    void rand_pcg32_seed(rand_pcg32_t *rng, uint64_t seed, uint64_t stream);
+
+    /**
+     * @brief Get the next random number from a PCG32.
+     *
+     * @param rng
+     * @return uint32_t
+     */
+    uint32_t rand_pcg32_next(rand_pcg32_t *rng);
+
+    /**
+     * @brief Set up the streams of a rand_fill_t from a 64bit seed.
+     *
+     * lane 0 is rand_xoshiro256ss_seed(seed), every other lane is the one
+     * before it after rand_xoshiro256ss_jump().
+     *
+     * @param rng
+     * @param seed any value, 0 included
+     */
+    void rand_fill_seed(rand_fill_t *rng, uint64_t seed);
+
+    /**
+     * @brief Fill a buffer with random numbers.
+     *
+     * each step of the lanes gives 2 * RAND_FILL_LANES numbers, the low
+     * and high half of each lane in order. AVX2 or SSE2 step several lanes
+     * at once on x86-64. if n is not a multiple of 2 * RAND_FILL_LANES the
+     * numbers of the last step that do not fit are dropped.
+     *
+     * @param rng
+     * @param buf n numbers
+     * @param n
+     */
+    void rand_fill_u32(rand_fill_t *rng, uint32_t *buf, size_t n);
+
+    /**
+     * @brief Uniform fixed_t in [a, b).
+     *
+     * the top 32 bits of one xoshiro256** number are scaled to the range
+     * with one multiply, the bias is below (b - a) / 2^32 per value.
+     *
+     * @param rng
+     * @param a lower bound
+     * @param b upper bound, above a
+     * @return fixed_t
+     */
+    fixed_t rand_uniform_fixed(rand_xoshiro256ss_t *rng, fixed_t a, fixed_t b);
+
+    /**
+     * @brief rand_uniform_fixed() for a whole buffer, two values from each
+     *        xoshiro256** number.
+     *
+     * @param rng
+     * @param buf n values
+     * @param n
+     * @param a lower bound
+     * @param b upper bound, above a
+     */
+    void rand_uniform_fixed_fill(rand_xoshiro256ss_t *rng, fixed_t *buf, size_t n, fixed_t a, fixed_t b);
+
+    /**
+     * @brief Normal distributed fixed_t, from the Ziggurat method.
+     *
+     * one xoshiro256** number and one multiply for 97% of the values,
+     * the rest take fixed_exp() / fixed_log() in the wedges and the tail.
+     * the tables are generated by tools/ziggurat at build time.
+     *
+     * @param rng
+     * @param mean
+     * @param sigma standard deviation
+     * @return fixed_t mean + sigma * N(0, 1), saturated
+     */
+    fixed_t rand_normal_fixed(rand_xoshiro256ss_t *rng, fixed_t mean, fixed_t sigma);
+
+    /**
+     * @brief rand_normal_fixed() for a whole buffer.
+     *
+     * @param rng
+     * @param buf n values
+     * @param n
+     * @param mean
+     * @param sigma standard deviation
+     */
+    void rand_normal_fixed_fill(rand_xoshiro256ss_t *rng, fixed_t *buf, size_t n, fixed_t mean, fixed_t sigma);
+
+    /**
+     * @brief Triangular (TPDF) dither in (-lsb, lsb), the difference of
+     *        two uniforms of one xoshiro256** number.
+     *
+     * added before a signal is quantized to steps of `lsb`, e.g. for a
+     * DAC or the levels of a LCD, the error is independent of the signal.
+     *
+     * @param rng
+     * @param lsb step of the quantizer, positive
+     * @return fixed_t
+     */
+    fixed_t rand_triangular_fixed(rand_xoshiro256ss_t *rng, fixed_t lsb);
+
+    /**
+     * @brief rand_triangular_fixed() for a whole buffer.
+     *
+     * @param rng
+     * @param buf n values
+     * @param n
+     * @param lsb step of the quantizer, positive
+     */
+    void rand_triangular_fixed_fill(rand_xoshiro256ss_t *rng, fixed_t *buf, size_t n, fixed_t lsb);
+
 #ifdef __cplusplus
 }
 #endif //! #ifdef __cplusplus
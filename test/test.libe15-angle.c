@@ -0,0 +1,81 @@
+#ifndef __BASE_FILE__
+#define __BASE_FILE__ __FILE__
+#endif
+
+#include <stdlib.h>
+#include <time.h>
+#include <cheat.h>
+#include <math.h>
+#include <angle.h>
+
+#define ANGLE_TEST_PI 3.14159265358979323846
+#define ANGLE_TEST_TURN 4294967296.0
+
+CHEAT_DECLARE(
+    /// distance of two binary angles, the shorter way round
+    static uint32_t angle_distance(angle_t a, angle_t b)
+    {
+        uint32_t d = a - b;
+        return d > ANGLE_HALF ? 0u - d : d;
+    }
+)
+
+CHEAT_TEST(angle_encoder_exact,
+    srand(time(NULL));
+    static const uint32_t counts[] = {4096, 1000, 2500, 65536, 1u << 20, 12345, 7};
+    static const uint32_t poles[] = {1, 4, 7, 50};
+    angle_encoder_t enc;
+
+    cheat_assert(angle_encoder_init(&enc, 0, 1) == E_INVALID_ARGUMENT);
+    cheat_assert(angle_encoder_init(&enc, 4096, 0) == E_INVALID_ARGUMENT);
+
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+    {
+        for (size_t p = 0; p < sizeof(poles) / sizeof(poles[0]); p++)
+        {
+            cheat_assert(angle_encoder_init(&enc, counts[c], poles[p]) == ALL_OK);
+            enc.offset = (angle_t)rand() * 2654435761u;
+
+            for (int i = 0; i < 2000; i++)
+            {
+                // a few turns either way, and the ends of the int32_t range
+                int32_t count = i < 2 ? (i ? INT32_MAX : INT32_MIN) : rand() % (int32_t)(counts[c] * 8) - (int32_t)(counts[c] * 4);
+
+                // count * poles / counts turns, the fraction of it in 2^-32
+                int64_t e = (int64_t)count * poles[p] % counts[c];
+                e = e < 0 ? e + counts[c] : e;
+                angle_t expect = (angle_t)(((uint64_t)e << 32) / counts[c] +
+                                           (((uint64_t)e << 32) % counts[c] >= (counts[c] + 1) / 2)) +
+                                 enc.offset;
+                cheat_assert(angle_distance(angle_encoder_electrical(&enc, count), expect) <= 1);
+            }
+        }
+    }
+
+    // a power of two resolution is exact
+    angle_encoder_init(&enc, 4096, 50);
+    cheat_assert(angle_encoder_electrical(&enc, 1) == 50u << 20);
+    cheat_assert(angle_encoder_electrical(&enc, -4096 * 3 + 41) == 41u * 50 << 20);
+)
+
+CHEAT_TEST(angle_sincos_bam,
+    for (int i = 0; i < 4096; i++)
+    {
+        angle_t a = i < 8 ? (angle_t)i * ANGLE_DEG(45) : (angle_t)rand() * 2654435761u;
+        double rad = a / ANGLE_TEST_TURN * 2 * ANGLE_TEST_PI;
+        fixed_t s, c;
+        angle_sincos(a, &s, &c);
+        cheat_assert(fabs(s.val / 65536.0 - sin(rad)) < 1e-3);
+        cheat_assert(fabs(c.val / 65536.0 - cos(rad)) < 1e-3);
+
+        // radian round trip, within the resolution of fixed_t
+        fixed_t r = angle_to_fixed(a);
+        cheat_assert(r.val >= -FIXED_PI.val - 1 && r.val <= FIXED_PI.val + 1);
+        cheat_assert(angle_distance(angle_from_fixed(r), a) < 1u << 17);
+    }
+
+    cheat_assert(angle_from_fixed(FIXED_PI_DIV2) - ANGLE_QUARTER < 1u << 16 ||
+                 ANGLE_QUARTER - angle_from_fixed(FIXED_PI_DIV2) < 1u << 16);
+    cheat_assert(angle_index(ANGLE_HALF + ANGLE_QUARTER, 8) == 192);
+    cheat_assert(ANGLE_DEG(-90) == 3 * ANGLE_QUARTER);
+)
@@ -0,0 +1,110 @@
+#ifndef __BASE_FILE__
+#define __BASE_FILE__ __FILE__
+#endif
+
+#include <stdlib.h>
+#include <time.h>
+#include <cheat.h>
+#include <math.h>
+#include <fft.h>
+#include <fft_twiddle.h>
+
+#define FFT_TEST_PI 3.14159265358979323846
+
+/**
+ * @brief largest |error| of `got * 2^exponent` against a double DFT of
+ *        `re` / `im`, relative to the largest bin.
+ */
+CHEAT_DECLARE(
+    static double fft_test_error(const fft_complex_q15_t *got, int32_t exponent,
+                                 const double *re, const double *im, uint32_t n, int inverse)
+    {
+        double err = 0, peak = 0;
+        for (uint32_t k = 0; k < n; k++)
+        {
+            double sr = 0, si = 0;
+            for (uint32_t j = 0; j < n; j++)
+            {
+                double a = (inverse ? 2 : -2) * FFT_TEST_PI * ((k * j) % n) / n;
+                sr += re[j] * cos(a) - im[j] * sin(a);
+                si += re[j] * sin(a) + im[j] * cos(a);
+            }
+            if (inverse)
+            {
+                sr /= n;
+                si /= n;
+            }
+            double e = hypot(ldexp(got[k].re, exponent) - sr, ldexp(got[k].im, exponent) - si);
+            err = e > err ? e : err;
+            peak = hypot(sr, si) > peak ? hypot(sr, si) : peak;
+        }
+        return err / peak;
+    }
+)
+
+CHEAT_TEST(fft_q15_against_dft,
+    srand(time(NULL));
+    static fft_complex_q15_t data[FFT_MAX_POINTS];
+    static double re[FFT_MAX_POINTS], im[FFT_MAX_POINTS];
+    int32_t exponent;
+
+    for (uint32_t n = FFT_MIN_POINTS; n <= FFT_MAX_POINTS; n *= 2)
+    {
+        // full scale noise and noise of a few LSB
+        for (int shift = 0; shift <= 12; shift += 12)
+        {
+            for (int inverse = 0; inverse < 2; inverse++)
+            {
+                for (uint32_t i = 0; i < n; i++)
+                {
+                    data[i].re = (int16_t)((rand() % 65536 - 32768) >> shift);
+                    data[i].im = (int16_t)((rand() % 65536 - 32768) >> shift);
+                    re[i] = data[i].re;
+                    im[i] = data[i].im;
+                }
+
+                cheat_assert((inverse ? ifft_q15 : fft_q15)(data, n, &exponent) == ALL_OK);
+                cheat_assert(fft_test_error(data, exponent, re, im, n, inverse) < 1.0 / 256);
+            }
+        }
+    }
+)
+
+CHEAT_TEST(fft_rfft_q15_round_trip,
+    static int16_t data[FFT_MAX_POINTS];
+    static int16_t input[FFT_MAX_POINTS];
+    int32_t exponent, inv_exponent;
+
+    for (uint32_t n = 2 * FFT_MIN_POINTS; n <= FFT_MAX_POINTS; n *= 2)
+    {
+        // a tone on bin 3 with an offset, X[0] = n * 4000, X[3] = n * 8000
+        for (uint32_t i = 0; i < n; i++)
+            input[i] = data[i] = (int16_t)lround(4000 + 16000 * cos(2 * FFT_TEST_PI * 3 * i / n));
+
+        cheat_assert(fft_rfft_q15(data, n, &exponent) == ALL_OK);
+        fft_complex_q15_t *bins = (fft_complex_q15_t *)data;
+        cheat_assert(fabs(ldexp(bins[0].re, exponent) / n - 4000) < 4);
+        cheat_assert(fabs(ldexp(bins[0].im, exponent)) < 4.0 * n);
+        cheat_assert(fabs(ldexp(bins[3].re, exponent) / n - 8000) < 8);
+        for (uint32_t k = 1; k < n / 2; k++)
+            if (k != 3)
+                cheat_assert(hypot(ldexp(bins[k].re, exponent), ldexp(bins[k].im, exponent)) < 4.0 * n);
+
+        cheat_assert(fft_irfft_q15(data, n, &inv_exponent) == ALL_OK);
+        for (uint32_t i = 0; i < n; i++)
+            cheat_assert(fabs(ldexp(data[i], exponent + inv_exponent) - input[i]) < 64);
+    }
+)
+
+CHEAT_TEST(fft_invalid_size,
+    static fft_complex_q15_t data[FFT_MAX_POINTS];
+    int32_t exponent;
+
+    cheat_assert(fft_q15(data, 0, &exponent) == E_INVALID_ARGUMENT);
+    cheat_assert(fft_q15(data, 2, &exponent) == E_INVALID_ARGUMENT);
+    cheat_assert(fft_q15(data, 48, &exponent) == E_INVALID_ARGUMENT);
+    cheat_assert(ifft_q15(data, 2 * FFT_MAX_POINTS, &exponent) == E_INVALID_ARGUMENT);
+    cheat_assert(fft_rfft_q15((int16_t *)data, 4, &exponent) == E_INVALID_ARGUMENT);
+    cheat_assert(fft_irfft_q15((int16_t *)data, 2 * FFT_MAX_POINTS, &exponent) == E_INVALID_ARGUMENT);
+    cheat_assert(fft_q15(data, 64, NULL) == E_INVALID_ARGUMENT);
+)
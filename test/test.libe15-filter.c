@@ -0,0 +1,133 @@
+#ifndef __BASE_FILE__
+#define __BASE_FILE__ __FILE__
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <cheat.h>
+#include <math.h>
+#include <filter.h>
+
+#define FILTER_TEST_TAPS 40
+#define FILTER_TEST_LEN 200
+#define FILTER_TEST_DOUBLE(v) ((v).val / 65536.0)
+
+CHEAT_DECLARE(
+    /// `filter_design lowpass 20000 1000 -o 4`
+    static const filter_biquad_coeffs_t lowpass_coeffs[2] = {
+        {23497607, 46995214, 23497607, -1826396544, 846645149},
+        {20440642, 40881285, 20440642, -1588788093, 596808838},
+    };
+
+    static int64_t round_reference(int64_t acc, int frac, int64_t lo, int64_t hi)
+    {
+        int64_t v = (acc + ((int64_t)1 << (frac - 1))) >> frac;
+        return v < lo ? lo : v > hi ? hi : v;
+    }
+)
+
+CHEAT_TEST(filter_fir_exact,
+    srand(time(NULL));
+    fixed_t h[FILTER_TEST_TAPS], state[2 * FILTER_TEST_TAPS];
+    fixed_t in[FILTER_TEST_LEN], out[FILTER_TEST_LEN];
+    filter_fir_t fir;
+
+    for (uint32_t taps = 1; taps <= FILTER_TEST_TAPS; taps++)
+    {
+        for (uint32_t k = 0; k < taps; k++)
+            h[k].val = rand() % 131072 - 65536;
+        for (int i = 0; i < FILTER_TEST_LEN; i++)
+            in[i].val = (rand() % 65536 - 32768) * (rand() % 256);
+
+        filter_fir_init(&fir, h, state, taps);
+        // samples, then blocks, then samples again, the state carries over
+        for (int i = 0; i < 7; i++)
+            out[i] = filter_fir_sample(&fir, in[i]);
+        filter_fir_block(&fir, in + 7, out + 7, 50);
+        filter_fir_block(&fir, in + 57, out + 57, FILTER_TEST_LEN - 60);
+        for (int i = FILTER_TEST_LEN - 3; i < FILTER_TEST_LEN; i++)
+            out[i] = filter_fir_sample(&fir, in[i]);
+
+        for (int i = 0; i < FILTER_TEST_LEN; i++)
+        {
+            int64_t acc = 0;
+            for (uint32_t k = 0; k < taps && k <= (uint32_t)i; k++)
+                acc += (int64_t)h[k].val * in[i - k].val;
+            cheat_assert(out[i].val == round_reference(acc, FIXED_WIDTH, INT32_MIN, INT32_MAX));
+        }
+    }
+)
+
+CHEAT_TEST(filter_fir_q15_exact,
+    int16_t h[FILTER_TEST_TAPS], state[2 * FILTER_TEST_TAPS];
+    int16_t in[FILTER_TEST_LEN], out[FILTER_TEST_LEN];
+    filter_fir_q15_t fir;
+
+    for (uint32_t taps = 1; taps <= FILTER_TEST_TAPS; taps++)
+    {
+        for (uint32_t k = 0; k < taps; k++)
+            h[k] = (int16_t)(rand() % 65536 - 32768);
+        for (int i = 0; i < FILTER_TEST_LEN; i++)
+            in[i] = (int16_t)(rand() % 65536 - 32768);
+        // (-1) * (-1) twice in a row, the one pair the SIMD lanes can not hold
+        h[0] = h[taps > 1] = INT16_MIN;
+        in[FILTER_TEST_LEN - 1] = in[FILTER_TEST_LEN - 2] = INT16_MIN;
+
+        filter_fir_q15_init(&fir, h, state, taps);
+        for (int i = 0; i < 5; i++)
+            out[i] = filter_fir_q15_sample(&fir, in[i]);
+        // in place
+        memcpy(out + 5, in + 5, (FILTER_TEST_LEN - 5) * sizeof(int16_t));
+        filter_fir_q15_block(&fir, out + 5, out + 5, FILTER_TEST_LEN - 5);
+
+        for (int i = 0; i < FILTER_TEST_LEN; i++)
+        {
+            int64_t acc = 0;
+            for (uint32_t k = 0; k < taps && k <= (uint32_t)i; k++)
+                acc += (int32_t)h[k] * in[i - k];
+            cheat_assert(out[i] == round_reference(acc, 15, INT16_MIN, INT16_MAX));
+        }
+    }
+)
+
+CHEAT_TEST(filter_biquad_lowpass,
+    filter_biquad_df1_state_t df1_state[2];
+    filter_biquad_df2t_state_t df2t_state[2];
+    filter_biquad_df1_t df1;
+    filter_biquad_df2t_t df2t;
+    fixed_t in[FILTER_TEST_LEN], out1[FILTER_TEST_LEN], out2[FILTER_TEST_LEN];
+    double x1[2] = {0}, x2[2] = {0}, y1[2] = {0}, y2[2] = {0};
+
+    // 10.0 step plus a tone at fs / 4, which the lowpass removes
+    for (int i = 0; i < FILTER_TEST_LEN; i++)
+        in[i] = fixed_from_int(10 + ((i & 3) == 0 ? 2 : (i & 3) == 2 ? -2 : 0));
+
+    filter_biquad_df1_init(&df1, lowpass_coeffs, df1_state, 2);
+    filter_biquad_df2t_init(&df2t, lowpass_coeffs, df2t_state, 2);
+    for (int i = 0; i < FILTER_TEST_LEN; i += 50)
+    {
+        filter_biquad_df1_block(&df1, in + i, out1 + i, 50);
+        filter_biquad_df2t_block(&df2t, in + i, out2 + i, 50);
+    }
+
+    for (int i = 0; i < FILTER_TEST_LEN; i++)
+    {
+        // double reference of the same coefficients
+        double y = FILTER_TEST_DOUBLE(in[i]);
+        for (int s = 0; s < 2; s++)
+        {
+            const filter_biquad_coeffs_t *c = &lowpass_coeffs[s];
+            double x = y;
+            y = (c->b0 * x + c->b1 * x1[s] + c->b2 * x2[s] - c->a1 * y1[s] - c->a2 * y2[s]) / (1 << FILTER_BIQUAD_FRAC);
+            x2[s] = x1[s];
+            x1[s] = x;
+            y2[s] = y1[s];
+            y1[s] = y;
+        }
+        cheat_assert(fabs(FILTER_TEST_DOUBLE(out1[i]) - y) < 1e-3);
+        cheat_assert(fabs(FILTER_TEST_DOUBLE(out2[i]) - y) < 1e-3);
+    }
+    cheat_assert(fabs(FILTER_TEST_DOUBLE(out1[FILTER_TEST_LEN - 1]) - 10.0) < 0.01);
+    cheat_assert(fabs(FILTER_TEST_DOUBLE(out2[FILTER_TEST_LEN - 1]) - 10.0) < 0.01);
+)
@@ -0,0 +1,71 @@
+#ifndef __BASE_FILE__
+#define __BASE_FILE__ __FILE__
+#endif
+
+#include <stdlib.h>
+#include <time.h>
+#include <cheat.h>
+#include <math.h>
+#include <foc.h>
+
+#define FOC_TEST_PI 3.14159265358979323846
+#define FOC_TEST_DOUBLE(v) ((v).val / 65536.0)
+#define FOC_TEST_FIXED(v) ((fixed_t){(fixed_value_t)lround((v) * 65536.0)})
+
+CHEAT_TEST(foc_clarke_park,
+    srand(time(NULL));
+    for (int i = 0; i < 4096; i++)
+    {
+        double amp = (rand() % 20000) / 1000.0;
+        double theta = (rand() % 62832) / 10000.0 - FOC_TEST_PI;
+        double ia = amp * cos(theta);
+        double ib = amp * cos(theta - 2 * FOC_TEST_PI / 3);
+
+        // balanced currents land on a vector of the phase amplitude at theta
+        foc_ab_t ab = foc_clarke(FOC_TEST_FIXED(ia), FOC_TEST_FIXED(ib));
+        cheat_assert(fabs(FOC_TEST_DOUBLE(ab.alpha) - amp * cos(theta)) < 1e-4 + 2e-5 * amp);
+        cheat_assert(fabs(FOC_TEST_DOUBLE(ab.beta) - amp * sin(theta)) < 1e-4 + 2e-5 * amp);
+
+        foc_abc_t abc = foc_inverse_clarke(ab);
+        cheat_assert(abc.a.val == FOC_TEST_FIXED(ia).val);
+        cheat_assert(fabs(FOC_TEST_DOUBLE(abc.b) - ib) < 1e-4 + 2e-5 * amp);
+        cheat_assert(abc.a.val + abc.b.val + abc.c.val == 0);
+
+        // rotating by the same angle leaves the whole vector on d
+        foc_sincos_t sc = foc_sincos(FOC_TEST_FIXED(theta));
+        foc_dq_t dq = foc_park(ab, sc);
+        cheat_assert(fabs(FOC_TEST_DOUBLE(dq.d) - amp) < 2e-3 * (1 + amp));
+        cheat_assert(fabs(FOC_TEST_DOUBLE(dq.q)) < 2e-3 * (1 + amp));
+
+        foc_ab_t back = foc_inverse_park(dq, sc);
+        cheat_assert(fabs(FOC_TEST_DOUBLE(back.alpha) - FOC_TEST_DOUBLE(ab.alpha)) < 2e-3 * (1 + amp));
+        cheat_assert(fabs(FOC_TEST_DOUBLE(back.beta) - FOC_TEST_DOUBLE(ab.beta)) < 2e-3 * (1 + amp));
+    }
+)
+
+CHEAT_TEST(foc_svpwm_duty,
+    foc_abc_t zero = foc_svpwm((foc_ab_t){FIXED_ZERO, FIXED_ZERO});
+    cheat_assert(zero.a.val == FIXED_ONE.val / 2 && zero.b.val == FIXED_ONE.val / 2 && zero.c.val == FIXED_ONE.val / 2);
+
+    for (int i = 0; i < 4096; i++)
+    {
+        // up to the edge of the linear range
+        double mag = (rand() % 1000) / 1000.0 / sqrt(3.0);
+        double theta = (rand() % 62832) / 10000.0;
+        foc_ab_t v = {FOC_TEST_FIXED(mag * cos(theta)), FOC_TEST_FIXED(mag * sin(theta))};
+        foc_abc_t duty = foc_svpwm(v);
+        foc_abc_t phase = foc_inverse_clarke(v);
+
+        cheat_assert(duty.a.val >= 0 && duty.a.val <= FIXED_ONE.val);
+        cheat_assert(duty.b.val >= 0 && duty.b.val <= FIXED_ONE.val);
+        cheat_assert(duty.c.val >= 0 && duty.c.val <= FIXED_ONE.val);
+        // the line to line voltages are the requested ones
+        cheat_assert(abs((duty.a.val - duty.b.val) - (phase.a.val - phase.b.val)) <= 1);
+        cheat_assert(abs((duty.b.val - duty.c.val) - (phase.b.val - phase.c.val)) <= 1);
+    }
+
+    // over modulation clamps
+    foc_abc_t full = foc_svpwm((foc_ab_t){FIXED_ONE, FIXED_ZERO});
+    cheat_assert(full.a.val == FIXED_ONE.val);
+    cheat_assert(full.b.val == 0 && full.c.val == 0);
+)
@@ -0,0 +1,70 @@
+#ifndef __BASE_FILE__
+#define __BASE_FILE__ __FILE__
+#endif
+
+#include <stdlib.h>
+#include <time.h>
+#include <cheat.h>
+#include <fpa.hpp>
+
+#define RAND_FULL_VAL ((fixed_value_t)(((uint32_t)rand() << 17) ^ ((uint32_t)rand() << 2) ^ (uint32_t)rand()))
+
+CHEAT_DECLARE(
+    using namespace libe15;
+    using namespace libe15::literals;
+
+    // literals and constants fold at compile time
+    static_assert((1.5_fx).raw() == 0x18000, "1.5_fx");
+    static_assert((-0.35_fx).raw() == -22938, "-0.35_fx rounds to nearest");
+    static_assert((3_fx).raw() == 3 << FIXED_WIDTH, "3_fx");
+    static_assert(fixed_pi.raw() == 205887 && fixed_pi_div2.raw() == 102943 && fixed_2pi.raw() == 411774, "pi");
+    static_assert(fixed_eps.raw() == 1 && fixed_max_inf.raw() == INT32_MAX, "limits");
+
+    // operators
+    static_assert((1.5_fx + 2.25_fx) == 3.75_fx, "operator+");
+    static_assert((1.5_fx - 2.25_fx) == -0.75_fx, "operator-");
+    static_assert((-1.5_fx * 2_fx).raw() == -0x30000, "operator*");
+    static_assert((3_fx / -2_fx).raw() == -0x18000, "operator/");
+    static_assert((1_fx << 2) == 4_fx && (-4_fx >> 1) == -2_fx, "shifts");
+    static_assert(abs(-2.25_fx) == 2.25_fx && min(1_fx, -1_fx) == -1_fx && max(1_fx, -1_fx) == 1_fx, "abs min max");
+    static_assert(0.5_fx < 1_fx && 1_fx >= 1_fx && 2_fx != 1_fx, "compare");
+    static_assert(sizeof(fixed) == sizeof(fixed_t), "layout");
+)
+
+CHEAT_TEST(fpa_hpp_constants,
+    cheat_assert(fixed_zero.raw() == FIXED_ZERO.val);
+    cheat_assert(fixed_one.raw() == FIXED_ONE.val);
+    cheat_assert(fixed_pi.raw() == FIXED_PI.val);
+    cheat_assert(fixed_pi_div2.raw() == FIXED_PI_DIV2.val);
+    cheat_assert(fixed_2pi.raw() == FIXED_2PI.val);
+    cheat_assert(fixed_max_inf.raw() == FIXED_MAX_INF.val);
+    cheat_assert(fixed_min_ninf.raw() == FIXED_MIN_NINF.val);
+)
+
+CHEAT_TEST(fpa_hpp_same_bits_as_c,
+    srand(time(NULL));
+    for (int i = 0; i < 1 << 20; i++)
+    {
+        fixed_t a = {RAND_FULL_VAL};
+        fixed_t b = {RAND_FULL_VAL >> (rand() % 32)};
+        fixed fa = a, fb = b;
+
+        cheat_assert((fa + fb).raw() == fixed_add(a, b).val);
+        cheat_assert((fa - fb).raw() == fixed_sub(a, b).val);
+        cheat_assert((fa * fb).raw() == fixed_mul(a, b).val);
+
+        // quotients that fit fixed_t
+        int64_t q = b.val ? (int64_t)a.val * (1 << FIXED_WIDTH) / b.val : 0;
+        if (b.val != 0 && q >= INT32_MIN && q <= INT32_MAX)
+            cheat_assert((fa / fb).raw() == fixed_div(a, b).val);
+
+        uint32_t bits = rand() % 16;
+        cheat_assert((fa << bits).raw() == fixed_move_left(a, bits).val);
+        cheat_assert((fa >> bits).raw() == fixed_move_right(a, bits).val);
+
+        fixed acc = fa;
+        acc *= fb;
+        acc += fa;
+        cheat_assert(acc.raw() == fixed_add(fixed_mul(a, b), a).val);
+    }
+)
@@ -5,10 +5,13 @@
 #define _CRT_SECURE_NO_WARNINGS
 
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <cheat.h>
 #include <math.h>
 #include <libe15-fpa.h>
+#include <qformat.h>
+#include <fpa_array.h>
 
 #define TEST_MULTIPLIER 16
 
@@ -291,17 +294,13 @@ CHEAT_TEST(fixed_ftoa_cont,
         fixed_t fv = (fixed_t){RAND_TEST_VAL};
         fixed_ftoa(fv, as);
 
-        float ffv = fv.val / 65536.0;
+        double ffv = fv.val / 65536.0;
 
         char fas[256] = { 0 };
 
+        // every digit, fixed_ftoa rounds the same way as printf
         sprintf(fas,"%.06f",ffv);
 
-        int a = strlen(as);
-        int b = strlen(fas);
-        as[a-1] = 0;
-        fas[b-1] = 0;
-
         cheat_assert_not(strcmp(fas,as) != 0);
         if(strcmp(fas,as) != 0)
         {
@@ -313,6 +312,51 @@ CHEAT_TEST(fixed_ftoa_cont,
 
 )
 
+CHEAT_TEST(fixed_atof_ftoa_round_trip,
+    srand(time(NULL));
+    uint32_t test_cnt = 1 << TEST_MULTIPLIER;
+    for(uint32_t i = 0; i < test_cnt; i++){
+        char as[64] = { 0 };
+        fixed_t fv = (fixed_t){(fixed_value_t)((uint32_t)rand() << 1 ^ (uint32_t)rand())};
+
+        // 6 digits tell every Q16 value apart, so it must parse back exactly
+        fixed_ftoa(fv, as);
+        cheat_assert(fixed_atof(as).val == fv.val);
+
+        // the exact value, with its 16 digits, or with one digit more
+        // than needed, is always the nearest value to itself
+        sprintf(as, "%.17f", fv.val / 65536.0);
+        cheat_assert(fixed_atof(as).val == fv.val);
+
+        // random 9 digit fractions against the correctly rounded double
+        sprintf(as, "  %d.%09d", 25 - (rand() % 50), rand() % 1000000000);
+        cheat_assert(fixed_atof(as).val == (fixed_value_t)llrint(strtod(as, NULL) * 65536.0));
+    }
+
+    // ties to even, 2^-17 is half of one LSB
+    cheat_assert(fixed_atof("0.00000762939453125").val == 0);
+    cheat_assert(fixed_atof("0.00002288818359375").val == 2);
+    cheat_assert(fixed_atof("0.000007629394531250001").val == 1);
+    cheat_assert(fixed_atof("\t-32768").val == FIXED_MIN_NINF.val);
+    cheat_assert(fixed_atof("40000.5").val == FIXED_MAX_INF.val);
+    cheat_assert(fixed_atof("-0.5").val == -(1 << (FIXED_WIDTH - 1)));
+)
+
+CHEAT_TEST(fixed_format_array_cont,
+    fixed_t vals[3] = {fixed_from_int(1), fixed_from_int(-2), FIXED_MIN_NINF};
+    char buf[64];
+
+    cheat_assert(fixed_format_array(buf, sizeof(buf), vals, 3, ',') == 32);
+    cheat_assert(strcmp(buf, "1.000000,-2.000000,-32768.000000") == 0);
+
+    // the third value does not fit, the first two are kept whole
+    cheat_assert(fixed_format_array(buf, 20, vals, 3, ' ') == -1);
+    cheat_assert(strcmp(buf, "1.000000 -2.000000") == 0);
+
+    cheat_assert(fixed_format_array(buf, sizeof(buf), vals, 0, ',') == 0);
+    cheat_assert(buf[0] == '\0');
+)
+
 CHEAT_TEST(
     fixed_sin_calc,
     uint32_t test_cnt = 1 << TEST_MULTIPLIER;
@@ -334,4 +378,400 @@ CHEAT_TEST(
             fprintf(stderr, "test_output_val : %f\n", 1.0 * sin_val.val / (1 << FIXED_WIDTH));
             fprintf(stderr, "+++++++++++++++++++\n");
         }
-    })
\ No newline at end of file
+    })
+CHEAT_TEST(
+    fixed_cos_calc,
+    uint32_t test_cnt = 1 << TEST_MULTIPLIER;
+    for (uint32_t i = 0; i < test_cnt; i++) {
+        int32_t test_val = RAND_TEST_VAL;
+        fixed_t fv = (fixed_t){test_val};
+
+        fixed_t cos_val = fixed_cos(fv);
+
+        double real_cos = cos(1.0 * test_val / (1 << FIXED_WIDTH));
+
+        fixed_t rfv = fixed_from_float(real_cos);
+
+        cheat_assert_not(abs(cos_val.val - rfv.val) > 10);
+        if (abs(cos_val.val - rfv.val) > 10)
+        {
+            fprintf(stderr, "input_val       : %f 0x%08X\n", 1.0 * test_val / (1 << FIXED_WIDTH),test_val);
+            fprintf(stderr, "true_output_val : %f\n", real_cos);
+            fprintf(stderr, "test_output_val : %f\n", 1.0 * cos_val.val / (1 << FIXED_WIDTH));
+            fprintf(stderr, "+++++++++++++++++++\n");
+        }
+    })
+
+CHEAT_TEST(
+    fixed_sincos_calc,
+    uint32_t test_cnt = 1 << TEST_MULTIPLIER;
+    for (uint32_t i = 0; i < test_cnt; i++) {
+        int32_t test_val = RAND_TEST_VAL;
+        fixed_t fv = (fixed_t){test_val};
+
+        fixed_t sin_val, cos_val;
+        fixed_sincos(fv, &sin_val, &cos_val);
+
+        // must agree bit-by-bit with the single output functions
+        cheat_assert(sin_val.val == fixed_sin(fv).val);
+        cheat_assert(cos_val.val == fixed_cos(fv).val);
+    })
+
+CHEAT_TEST(
+    fixed_atan2_hypot_calc,
+    uint32_t test_cnt = 1 << TEST_MULTIPLIER;
+    for (uint32_t i = 0; i < test_cnt; i++) {
+        fixed_t fy = (fixed_t){RAND_TEST_VAL};
+        fixed_t fx = (fixed_t){RAND_TEST_VAL};
+
+        fixed_t angle, mag;
+        fixed_atan2_hypot(fy, fx, &angle, &mag);
+
+        double real_angle = atan2(fy.val, fx.val) * (1 << FIXED_WIDTH);
+        double real_mag = hypot(fy.val, fx.val);
+
+        cheat_assert_not(fabs(angle.val - real_angle) > 2);
+        cheat_assert_not(fabs(mag.val - real_mag) > 2);
+        if (fabs(angle.val - real_angle) > 2 || fabs(mag.val - real_mag) > 2)
+        {
+            fprintf(stderr, "input_val       : 0x%08X 0x%08X\n", fy.val, fx.val);
+            fprintf(stderr, "true_output_val : %f %f\n", real_angle, real_mag);
+            fprintf(stderr, "test_output_val : %d %d\n", angle.val, mag.val);
+            fprintf(stderr, "+++++++++++++++++++\n");
+        }
+
+        cheat_assert(fixed_atan2(fy, fx).val == angle.val);
+        cheat_assert(fixed_hypot(fx, fy).val == mag.val);
+    })
+
+CHEAT_TEST(
+    fixed_atan2_hypot_full_range,
+    uint32_t test_cnt = 1 << TEST_MULTIPLIER;
+    for (uint32_t i = 0; i < test_cnt; i++) {
+        // any int32_t, shifted down by 0 to 31 bits to cover every magnitude
+        int shift = rand() % 32;
+        int32_t vy = (int32_t)(((uint32_t)rand() << 17) ^ ((uint32_t)rand() << 2) ^ (uint32_t)rand());
+        int32_t vx = (int32_t)(((uint32_t)rand() << 17) ^ ((uint32_t)rand() << 2) ^ (uint32_t)rand());
+        if (i == 0)
+        {
+            vy = (int32_t)0x92BF9833;
+            vx = 0x0933CBE7;
+            shift = 0;
+        }
+        fixed_t fy = (fixed_t){vy >> shift};
+        fixed_t fx = (fixed_t){vx >> shift};
+
+        fixed_t angle, mag;
+        fixed_atan2_hypot(fy, fx, &angle, &mag);
+
+        double real_angle = atan2(fy.val, fx.val) * (1 << FIXED_WIDTH);
+        double real_mag = fmin(hypot(fy.val, fx.val), FIXED_MAX_INF.val);
+
+        cheat_assert_not(fabs(angle.val - real_angle) > 1);
+        cheat_assert_not(fabs(mag.val - real_mag) > 1);
+        if (fabs(angle.val - real_angle) > 1 || fabs(mag.val - real_mag) > 1)
+        {
+            fprintf(stderr, "input_val       : 0x%08X 0x%08X\n", fy.val, fx.val);
+            fprintf(stderr, "true_output_val : %f %f\n", real_angle, real_mag);
+            fprintf(stderr, "test_output_val : %d %d\n", angle.val, mag.val);
+            fprintf(stderr, "+++++++++++++++++++\n");
+        }
+    })
+
+CHEAT_TEST(
+    fixed_exp_calc,
+    uint32_t test_cnt = 1 << TEST_MULTIPLIER;
+    for (uint32_t i = 0; i < test_cnt; i++) {
+        // -12 ~ ln(32768)
+        int32_t test_val = (int32_t)(rand() % 1467824) - 786432;
+        fixed_t fv = (fixed_t){test_val};
+
+        fixed_t exp_val = fixed_exp(fv);
+
+        double real_exp = exp(1.0 * test_val / (1 << FIXED_WIDTH)) * (1 << FIXED_WIDTH);
+        // error relative to the value, 1 LSB for the small ones
+        double tolerance = real_exp / (1 << 22) + 1;
+
+        cheat_assert_not(fabs(exp_val.val - real_exp) > tolerance);
+        if (fabs(exp_val.val - real_exp) > tolerance)
+        {
+            fprintf(stderr, "input_val       : %f 0x%08X\n", 1.0 * test_val / (1 << FIXED_WIDTH), test_val);
+            fprintf(stderr, "true_output_val : %f\n", real_exp);
+            fprintf(stderr, "test_output_val : %d\n", exp_val.val);
+            fprintf(stderr, "+++++++++++++++++++\n");
+        }
+    }
+
+    cheat_assert(fixed_exp(fixed_from_int(11)).val == FIXED_MAX_INF.val);
+    cheat_assert(fixed_exp(fixed_from_int(-12)).val == 0);)
+
+CHEAT_TEST(
+    fixed_log_calc,
+    uint32_t test_cnt = 1 << TEST_MULTIPLIER;
+    for (uint32_t i = 0; i < test_cnt; i++) {
+        int32_t test_val = (rand() & 0x7FFF) << (rand() % 17) | (rand() & 0xFF);
+        if (test_val <= 0)
+            continue;
+        fixed_t fv = (fixed_t){test_val};
+
+        fixed_t log_val = fixed_log(fv);
+
+        double real_log = log(1.0 * test_val / (1 << FIXED_WIDTH)) * (1 << FIXED_WIDTH);
+
+        cheat_assert_not(fabs(log_val.val - real_log) > 1);
+        if (fabs(log_val.val - real_log) > 1)
+        {
+            fprintf(stderr, "input_val       : %f 0x%08X\n", 1.0 * test_val / (1 << FIXED_WIDTH), test_val);
+            fprintf(stderr, "true_output_val : %f\n", real_log);
+            fprintf(stderr, "test_output_val : %d\n", log_val.val);
+            fprintf(stderr, "+++++++++++++++++++\n");
+        }
+    }
+
+    cheat_assert(fixed_log(FIXED_ZERO).val == FIXED_MIN_NINF.val);)
+
+CHEAT_TEST(fixed_t_div_fast,
+    srand(time(NULL));
+    uint32_t test_cnt = 1 << TEST_MULTIPLIER;
+    for(uint32_t i = 0; i < test_cnt; i++){
+        int32_t r1 = RAND_TEST_VAL;
+        int32_t r2 = RAND_TEST_VAL;
+        if (r2 == 0)
+            continue;
+        int64_t t1 = r1,t2 = r2;
+        int64_t t3 = (t1 << FIXED_WIDTH) / t2;
+        if (t3 > INT32_MAX || t3 < INT32_MIN)
+            continue;
+        fixed_t val1, val2;
+        val1.val = r1;
+        val2.val = r2;
+
+        fixed_t val3 = fixed_div_fast(val1, val2);
+
+        cheat_assert_not(llabs(val3.val - t3) > 2);
+
+        if(llabs(val3.val - t3) > 2)
+        {
+            fprintf(stderr,"val1  : 0x%08X\n",r1);
+            fprintf(stderr,"val2  : 0x%08X\n",r2);
+            fprintf(stderr,"val3_T: 0x%08X\n",(int32_t)t3);
+            fprintf(stderr,"val3  : 0x%08X\n",val3.val);
+        }
+    }
+
+    cheat_assert(fixed_div_fast(FIXED_ONE, FIXED_ZERO).val == FIXED_MAX_INF.val);
+    cheat_assert(fixed_div_fast(fixed_from_int(-1), FIXED_ZERO).val == FIXED_MIN_NINF.val);
+)
+
+CHEAT_TEST(fixed_t_reciprocal,
+    srand(time(NULL));
+    uint32_t test_cnt = 1 << TEST_MULTIPLIER;
+    for(uint32_t i = 0; i < test_cnt; i++){
+        int32_t r1 = RAND_TEST_VAL;
+        // 1 / r1 must fit in fixed_t
+        if (abs(r1) < 3)
+            continue;
+        fixed_t val1;
+        val1.val = r1;
+
+        fixed_t val3 = fixed_reciprocal(val1);
+
+        cheat_assert(val3.val == fixed_div_fast(FIXED_ONE, val1).val);
+        cheat_assert_not(abs(val3.val - fixed_div(FIXED_ONE, val1).val) > 2);
+    }
+)
+
+CHEAT_DECLARE(
+    /**
+     * sqrt(v * 2^16) rounded to nearest, from integer math only
+     */
+    static uint64_t fixed_sqrt_reference(uint32_t v)
+    {
+        uint64_t n = (uint64_t)v << FIXED_WIDTH;
+        uint64_t r = (uint64_t)sqrt((double)n);
+        while (r * r > n)
+            r--;
+        while ((r + 1) * (r + 1) <= n)
+            r++;
+        return n - r * r > r ? r + 1 : r;
+    }
+)
+
+/**
+ * every input below 2^20, a dense stride over the rest of the range and
+ * the values around every power of 2.
+ */
+#define FIXED_SQRT_TEST_INPUTS(v, body)                         \
+    for (uint32_t v = 1; v < (1u << 20); v++) { body }          \
+    for (uint32_t v = 1u << 20; v < 0x7FFFFE00u; v += 509) { body } \
+    for (uint32_t p = 2; p < 31; p++)                           \
+        for (uint32_t v = (1u << p) - 2; v <= (1u << p) + 2; v++) { body } \
+    { uint32_t v = 0x7FFFFFFFu; body }
+
+CHEAT_TEST(
+    fixed_sqrt_calc,
+    uint32_t fail_cnt = 0;
+    FIXED_SQRT_TEST_INPUTS(v,
+        int32_t sqrt_val = fixed_sqrt((fixed_t){(fixed_value_t)v}).val;
+        int32_t real_sqrt = (int32_t)fixed_sqrt_reference(v);
+        if (sqrt_val != real_sqrt && fail_cnt++ < 8)
+            fprintf(stderr, "sqrt(0x%08X) = 0x%08X, expect 0x%08X\n", v, sqrt_val, real_sqrt);
+    )
+    cheat_assert(fail_cnt == 0);
+
+    cheat_assert(fixed_sqrt(FIXED_ZERO).val == 0);
+    cheat_assert(fixed_sqrt(fixed_from_int(-4)).val == 0);
+    cheat_assert(fixed_sqrt(fixed_from_int(16384)).val == fixed_from_int(128).val);)
+
+CHEAT_TEST(
+    fixed_rsqrt_calc,
+    uint32_t fail_cnt = 0;
+    FIXED_SQRT_TEST_INPUTS(v,
+        int32_t rsqrt_val = fixed_rsqrt((fixed_t){(fixed_value_t)v}).val;
+        double real_rsqrt = 16777216.0 / sqrt((double)v);
+        if (fabs(rsqrt_val - real_rsqrt) > 1 && fail_cnt++ < 8)
+            fprintf(stderr, "rsqrt(0x%08X) = 0x%08X, expect %f\n", v, rsqrt_val, real_rsqrt);
+    )
+    cheat_assert(fail_cnt == 0);
+
+    cheat_assert(fixed_rsqrt(FIXED_ZERO).val == FIXED_MAX_INF.val);
+    cheat_assert(fixed_rsqrt(fixed_from_int(4)).val == (FIXED_ONE.val >> 1));)
+
+CHEAT_DECLARE(
+    static fixed_value_t clamp_reference(int64_t v)
+    {
+        return v > INT32_MAX ? INT32_MAX : v < INT32_MIN ? INT32_MIN : (fixed_value_t)v;
+    }
+)
+
+CHEAT_TEST(fixed_t_saturate,
+    srand(time(NULL));
+    uint32_t test_cnt = 1 << TEST_MULTIPLIER;
+    for(uint32_t i = 0; i < test_cnt; i++){
+        // full range, so about half of the sums and most products overflow
+        fixed_t a = (fixed_t){(fixed_value_t)((uint32_t)rand() << 1 ^ (uint32_t)rand()) >> (rand() % 16)};
+        fixed_t b = (fixed_t){(fixed_value_t)((uint32_t)rand() << 1 ^ (uint32_t)rand()) >> (rand() % 16)};
+        fixed_t c = (fixed_t){(fixed_value_t)((uint32_t)rand() << 1 ^ (uint32_t)rand())};
+        int64_t p = ((int64_t)a.val * b.val) >> FIXED_WIDTH;
+
+        cheat_assert(fixed_add_sat(a, b).val == clamp_reference((int64_t)a.val + b.val));
+        cheat_assert(fixed_sub_sat(a, b).val == clamp_reference((int64_t)a.val - b.val));
+        cheat_assert(fixed_mul_sat(a, b).val == clamp_reference(p));
+        cheat_assert(fixed_mac_sat(c, a, b).val == clamp_reference(c.val + p));
+    }
+
+    cheat_assert(fixed_add_sat(FIXED_MAX_INF, FIXED_EPS).val == FIXED_MAX_INF.val);
+    cheat_assert(fixed_sub_sat(FIXED_MIN_NINF, FIXED_EPS).val == FIXED_MIN_NINF.val);
+    cheat_assert(fixed_sub_sat(FIXED_ZERO, FIXED_MIN_NINF).val == FIXED_MAX_INF.val);
+    cheat_assert(fixed_mul_sat(FIXED_MIN_NINF, fixed_from_int(-1)).val == FIXED_MAX_INF.val);
+    cheat_assert(fixed_mac_sat(FIXED_MAX_INF, fixed_from_int(-2), fixed_from_int(2)).val == FIXED_MAX_INF.val - (4 << FIXED_WIDTH));
+)
+
+#define RAND_U64 (((uint64_t)rand() << 62) ^ ((uint64_t)rand() << 31) ^ (uint64_t)rand())
+
+CHEAT_TEST(qformat_mul_div,
+    srand(time(NULL));
+    uint32_t test_cnt = 1 << TEST_MULTIPLIER;
+    for(uint32_t i = 0; i < test_cnt; i++){
+        int16_t a15 = (int16_t)rand(), b15 = (int16_t)rand();
+        cheat_assert(q15_mul((q15_t){a15}, (q15_t){b15}).val == (int16_t)(((int32_t)a15 * b15) >> 15));
+        if (abs(a15) < abs(b15))
+            cheat_assert(q15_div((q15_t){a15}, (q15_t){b15}).val == (int16_t)(((int32_t)a15 * (1 << 15)) / b15));
+
+        int32_t a31 = (int32_t)RAND_U64, b31 = (int32_t)RAND_U64;
+        cheat_assert(q31_mul((q31_t){a31}, (q31_t){b31}).val == (int32_t)(((int64_t)a31 * b31) >> 31));
+        cheat_assert(q16_16_mul((q16_16_t){a31}, (q16_16_t){b31}).val == (int32_t)(((int64_t)a31 * b31) >> 16));
+        if (b31 != 0)
+            cheat_assert(q16_16_div((q16_16_t){a31}, (q16_16_t){b31 | 0x10000}).val == fixed_div((fixed_t){a31}, (fixed_t){b31 | 0x10000}).val);
+
+        // values below 2^40 so the products fit, checked with double
+        int64_t a64 = (int64_t)RAND_U64 >> 24, b64 = (int64_t)RAND_U64 >> 24;
+        double p64 = (double)a64 * (double)b64 / 4294967296.0;
+        cheat_assert(fabs(q32_32_mul((q32_32_t){a64}, (q32_32_t){b64}).val - p64) <= 1 + fabs(p64) / 1e15);
+        if (b64 != 0)
+        {
+            double d64 = (double)a64 / (double)b64 * 4294967296.0;
+            cheat_assert(fabs(q32_32_div((q32_32_t){a64}, (q32_32_t){b64}).val - d64) <= 1 + fabs(d64) / 1e15);
+        }
+    }
+    cheat_assert(q32_32_mul(q32_32_from_int(-3), q32_32_from_float(0.5f)).val == -((int64_t)3 << 31));
+    cheat_assert(q32_32_div(q32_32_from_int(-3), q32_32_from_int(2)).val == -((int64_t)3 << 31));
+)
+
+CHEAT_TEST(qformat_conversion,
+    srand(time(NULL));
+    uint32_t test_cnt = 1 << TEST_MULTIPLIER;
+    for(uint32_t i = 0; i < test_cnt; i++){
+        int16_t v15 = (int16_t)rand();
+        q15_t a = (q15_t){v15};
+        cheat_assert(q15_from_q31(q31_from_q15(a)).val == v15);
+        cheat_assert(q15_from_q32_32(q32_32_from_q15(a)).val == v15);
+        cheat_assert(q15_from_fixed(fixed_from_q15(a)).val == v15);
+        cheat_assert(q31_from_q15(a).val == (int32_t)v15 * (1 << 16));
+
+        fixed_t f = (fixed_t){RAND_TEST_VAL};
+        cheat_assert(fixed_from_q16_16(q16_16_from_fixed(f)).val == f.val);
+        cheat_assert(fixed_from_q32_32(q32_32_from_fixed(f)).val == f.val);
+        cheat_assert(q32_32_from_fixed(f).val == (int64_t)f.val * (1 << 16));
+    }
+    cheat_assert(q15_to_int(q15_from_float(-1.0f)) == -1);
+    cheat_assert(q31_from_float(0.5f).val == 0x40000000);
+
+    // out of range clamps like fixed_from_float
+    cheat_assert(q15_from_float(1.0f).val == INT16_MAX);
+    cheat_assert(q15_from_float(-1.0f).val == INT16_MIN);
+    cheat_assert(q15_from_float(-3.0f).val == INT16_MIN);
+    cheat_assert(q31_from_float(1.0f).val == INT32_MAX);
+    cheat_assert(q31_from_float(-2.0f).val == INT32_MIN);
+    cheat_assert(q32_32_from_float(1e10f).val == INT64_MAX);
+)
+
+#define ARRAY_TEST_LEN 67
+
+CHEAT_TEST(fixed_array_kernels,
+    srand(time(NULL));
+    fixed_t a[ARRAY_TEST_LEN], b[ARRAY_TEST_LEN], out[ARRAY_TEST_LEN], acc[ARRAY_TEST_LEN];
+    uint32_t test_cnt = 1 << (TEST_MULTIPLIER - 6);
+    for(uint32_t i = 0; i < test_cnt; i++){
+        // every length up to 67 over the runs, so the scalar tail of each
+        // vector loop is covered
+        size_t n = i % (ARRAY_TEST_LEN + 1);
+        for (size_t j = 0; j < n; j++)
+        {
+            a[j] = (fixed_t){RAND_TEST_VAL};
+            b[j] = (fixed_t){RAND_TEST_VAL >> (rand() % 31)};
+            acc[j] = (fixed_t){RAND_TEST_VAL};
+        }
+        fixed_t k = (fixed_t){RAND_TEST_VAL >> (rand() % 31)};
+        int64_t dot = 0;
+
+        fixed_add_array(out, a, b, n);
+        for (size_t j = 0; j < n; j++)
+            cheat_assert(out[j].val == fixed_add(a[j], b[j]).val);
+
+        fixed_mul_array(out, a, b, n);
+        for (size_t j = 0; j < n; j++)
+            cheat_assert(out[j].val == fixed_mul(a[j], b[j]).val);
+
+        fixed_scale_array(out, a, k, n);
+        for (size_t j = 0; j < n; j++)
+            cheat_assert(out[j].val == fixed_mul(a[j], k).val);
+
+        memcpy(out, acc, sizeof(acc));
+        fixed_axpy(out, k, b, n);
+        for (size_t j = 0; j < n; j++)
+            cheat_assert(out[j].val == fixed_add(acc[j], fixed_mul(k, b[j])).val);
+
+        memcpy(out, acc, sizeof(acc));
+        fixed_mac(out, a, b, n);
+        for (size_t j = 0; j < n; j++)
+            cheat_assert(out[j].val == fixed_add(acc[j], fixed_mul(a[j], b[j])).val);
+
+        for (size_t j = 0; j < n; j++)
+            dot = (int64_t)((uint64_t)dot + (uint64_t)((int64_t)a[j].val * b[j].val));
+        cheat_assert(fixed_dot(a, b, n).val == (fixed_value_t)(uint32_t)((uint64_t)dot >> FIXED_WIDTH));
+    }
+
+    fixed_t ones[5] = {FIXED_ONE, FIXED_ONE, FIXED_ONE, FIXED_ONE, FIXED_ONE};
+    cheat_assert(fixed_dot(ones, ones, 5).val == fixed_from_int(5).val);
+)
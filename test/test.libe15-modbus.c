@@ -0,0 +1,357 @@
+#ifndef __BASE_FILE__
+#define __BASE_FILE__ __FILE__
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <cheat.h>
+#include <modbus.h>
+
+#define MODBUS_TEST_RANGES 1000
+
+CHEAT_DECLARE(
+    static uint8_t modbus_test_resp[MODBUS_ADU_MAX];
+    static uint32_t modbus_test_resp_len;
+    static uint16_t modbus_test_regs[0x10000];
+
+    static error_t modbus_test_transmit(uint32_t size, const void *pdata)
+    {
+        memcpy(modbus_test_resp, pdata, size);
+        modbus_test_resp_len = size;
+        return ALL_OK;
+    }
+
+    /// every register reads as its offset in its range
+    static error_t modbus_test_read(uint32_t offset, uint32_t size, uint8_t *data, uint8_t *error_code_out)
+    {
+        (void)error_code_out;
+        for (uint32_t i = 0; i < size; i++)
+        {
+            data[2 * i] = (offset + i) >> 8;
+            data[2 * i + 1] = (offset + i) & 0xFF;
+        }
+        return ALL_OK;
+    }
+
+    /// writes of the ranges at 0x10 and 0x20, stored at their address
+    static error_t modbus_test_write(uint32_t base, uint32_t offset, uint32_t data, uint8_t *error_code_out)
+    {
+        if (data == 0xDEAD)
+        {
+            *error_code_out = MODBUS_ERR_ILLEGAL_DATA_VALUE;
+            return E_INVALID_ARGUMENT;
+        }
+        modbus_test_regs[base + offset] = data;
+        return ALL_OK;
+    }
+
+    static error_t modbus_test_write_10(uint32_t offset, uint32_t data, uint8_t *error_code_out)
+    {
+        return modbus_test_write(0x10, offset, data, error_code_out);
+    }
+
+    static error_t modbus_test_write_20(uint32_t offset, uint32_t data, uint8_t *error_code_out)
+    {
+        return modbus_test_write(0x20, offset, data, error_code_out);
+    }
+
+    /// bitwise CRC-16/MODBUS
+    static uint16_t modbus_test_crc(const uint8_t *data, uint32_t size)
+    {
+        uint16_t crc = 0xFFFF;
+        for (uint32_t i = 0; i < size; i++)
+        {
+            crc ^= data[i];
+            for (int b = 0; b < 8; b++)
+                crc = crc & 1 ? (crc >> 1) ^ 0xA001 : crc >> 1;
+        }
+        return crc;
+    }
+
+    /**
+     * @brief send a request without its CRC byte by byte, the response is in
+     *        modbus_test_resp without its CRC
+     * @return size of the response, 0 if there is none
+     */
+    static uint32_t modbus_test_request(modbus_slave_t *slave, const uint8_t *req, uint32_t size)
+    {
+        uint8_t frame[MODBUS_ADU_MAX + 2];
+        memcpy(frame, req, size);
+        uint16_t crc = modbus_test_crc(req, size);
+        frame[size] = crc & 0xFF;
+        frame[size + 1] = crc >> 8;
+
+        modbus_test_resp_len = 0;
+        for (uint32_t i = 0; i < size + 2; i++)
+            modbus_slave_recv_handler(slave, frame[i], MODBUS_RECV_DATA);
+        modbus_slave_recv_handler(slave, 0, MODBUS_RECV_END);
+
+        if (modbus_test_resp_len == 0)
+            return 0;
+        crc = modbus_test_crc(modbus_test_resp, modbus_test_resp_len - 2);
+        cheat_assert(modbus_test_resp[modbus_test_resp_len - 2] == (crc & 0xFF));
+        cheat_assert(modbus_test_resp[modbus_test_resp_len - 1] == crc >> 8);
+        return modbus_test_resp_len - 2;
+    }
+)
+
+CHEAT_TEST(modbus_register_map,
+    // ranges of 1 to 8 registers, with a gap after every 4th one
+    static modbus_reg_desc_t holding[MODBUS_TEST_RANGES];
+    uint32_t addr = 3;
+    for (int i = 0; i < MODBUS_TEST_RANGES; i++)
+    {
+        holding[i] = (modbus_reg_desc_t){.reg_start_addr = addr, .reg_map_len = 1 + rand() % 8,
+                                         .read_handler = modbus_test_read};
+        addr += holding[i].reg_map_len + (i % 4 == 3);
+    }
+    // shuffled, modbus_slave_init sorts them
+    for (int i = MODBUS_TEST_RANGES - 1; i > 0; i--)
+    {
+        int j = rand() % (i + 1);
+        modbus_reg_desc_t t = holding[i];
+        holding[i] = holding[j];
+        holding[j] = t;
+    }
+
+    static modbus_reg_desc_t input[1] = {{.reg_start_addr = 0x100, .reg_map_len = 4, .read_handler = modbus_test_read}};
+    modbus_slave_init_t desc = {.input_regs = input, .input_reg_cnt = 1, .holding_regs = holding,
+                                .holding_reg_cnt = MODBUS_TEST_RANGES, .request_pdu_transmit = modbus_test_transmit};
+    modbus_slave_t slave;
+    cheat_assert(modbus_slave_init(&slave, &desc, 7) == ALL_OK);
+    for (int i = 1; i < MODBUS_TEST_RANGES; i++)
+        cheat_assert(holding[i - 1].reg_start_addr < holding[i].reg_start_addr);
+
+    // reads of up to 125 registers from every range, within or across ranges
+    for (int i = 0; i < MODBUS_TEST_RANGES; i++)
+    {
+        uint32_t start = holding[i].reg_start_addr + rand() % holding[i].reg_map_len;
+        uint32_t qty = 1 + rand() % MODBUS_READ_REGS_MAX;
+
+        // the offset of each register in its range, until the first gap
+        uint16_t expect[MODBUS_READ_REGS_MAX];
+        int ok = 1;
+        for (uint32_t r = start, k = i; r < start + qty; r++)
+        {
+            if (r >= holding[k].reg_start_addr + holding[k].reg_map_len)
+                k++;
+            if (k >= MODBUS_TEST_RANGES || r < holding[k].reg_start_addr)
+            {
+                ok = 0;
+                break;
+            }
+            expect[r - start] = r - holding[k].reg_start_addr;
+        }
+
+        uint8_t req[] = {7, 0x03, start >> 8, start & 0xFF, 0, qty};
+        uint32_t len = modbus_test_request(&slave, req, sizeof(req));
+        if (ok)
+        {
+            cheat_assert(len == 3 + 2 * qty && modbus_test_resp[1] == 0x03 && modbus_test_resp[2] == 2 * qty);
+            for (uint32_t r = 0; r < qty; r++)
+                cheat_assert(((modbus_test_resp[3 + 2 * r] << 8) | modbus_test_resp[4 + 2 * r]) == expect[r]);
+        }
+        else
+        {
+            cheat_assert(len == 3 && modbus_test_resp[1] == 0x83 &&
+                         modbus_test_resp[2] == MODBUS_ERR_ILLEGAL_DATA_ADDRESS);
+        }
+    }
+
+    // below the first range, and input registers through 0x04 only
+    uint8_t below[] = {7, 0x03, 0, 2, 0, 2};
+    cheat_assert(modbus_test_request(&slave, below, sizeof(below)) == 3 && modbus_test_resp[2] == 0x02);
+    uint8_t in[] = {7, 0x04, 0x01, 0x02, 0, 2};
+    cheat_assert(modbus_test_request(&slave, in, sizeof(in)) == 7 && modbus_test_resp[4] == 0x02 &&
+                 modbus_test_resp[6] == 0x03);
+    in[3] = 0x03;
+    cheat_assert(modbus_test_request(&slave, in, sizeof(in)) == 3 && modbus_test_resp[1] == 0x84);
+    uint8_t too_many[] = {7, 0x04, 0x01, 0x00, 0, MODBUS_READ_REGS_MAX + 1};
+    cheat_assert(modbus_test_request(&slave, too_many, sizeof(too_many)) == 3 &&
+                 modbus_test_resp[2] == MODBUS_ERR_ILLEGAL_DATA_VALUE);
+
+    // overlapping ranges are rejected
+    modbus_reg_desc_t overlap[2] = {{.reg_start_addr = 10, .reg_map_len = 5}, {.reg_start_addr = 14, .reg_map_len = 1}};
+    modbus_slave_init_t bad = desc;
+    bad.holding_regs = overlap;
+    bad.holding_reg_cnt = 2;
+    cheat_assert(modbus_slave_init(&slave, &bad, 7) == E_INVALID_ARGUMENT);
+)
+
+CHEAT_TEST(modbus_write_registers,
+    static modbus_reg_desc_t holding[3] = {
+        {.reg_start_addr = 0x20, .reg_map_len = 2, .read_handler = modbus_test_read, .write_handler = modbus_test_write_20},
+        {.reg_start_addr = 0x10, .reg_map_len = 16, .read_handler = modbus_test_read, .write_handler = modbus_test_write_10},
+        {.reg_start_addr = 0x40, .reg_map_len = 4, .read_handler = modbus_test_read},
+    };
+    modbus_slave_init_t desc = {.holding_regs = holding, .holding_reg_cnt = 3,
+                                .request_pdu_transmit = modbus_test_transmit};
+    modbus_slave_t slave;
+    cheat_assert(modbus_slave_init(&slave, &desc, 9) == ALL_OK);
+    memset(modbus_test_regs, 0, sizeof(modbus_test_regs));
+
+    // 0x06 echoes the request
+    uint8_t single[] = {9, 0x06, 0x00, 0x12, 0xAB, 0xCD};
+    cheat_assert(modbus_test_request(&slave, single, sizeof(single)) == 6);
+    cheat_assert(memcmp(modbus_test_resp, single, sizeof(single)) == 0);
+    cheat_assert(modbus_test_regs[0x12] == 0xABCD);
+
+    // 0x10 across two adjacent ranges
+    uint8_t multi[] = {9, 0x10, 0x00, 0x1E, 0x00, 0x03, 6, 0x11, 0x11, 0x22, 0x22, 0x33, 0x33};
+    cheat_assert(modbus_test_request(&slave, multi, sizeof(multi)) == 6);
+    cheat_assert(memcmp(modbus_test_resp, multi, 6) == 0);
+    cheat_assert(modbus_test_regs[0x1E] == 0x1111 && modbus_test_regs[0x1F] == 0x2222 &&
+                 modbus_test_regs[0x20] == 0x3333);
+
+    // a byte count that does not match, a read only range, a gap, a value the handler refuses
+    multi[6] = 4;
+    cheat_assert(modbus_test_request(&slave, multi, sizeof(multi)) == 3 && modbus_test_resp[1] == 0x90 &&
+                 modbus_test_resp[2] == MODBUS_ERR_ILLEGAL_DATA_VALUE);
+    uint8_t read_only[] = {9, 0x06, 0x00, 0x41, 0x00, 0x01};
+    cheat_assert(modbus_test_request(&slave, read_only, sizeof(read_only)) == 3 && modbus_test_resp[1] == 0x86 &&
+                 modbus_test_resp[2] == MODBUS_ERR_ILLEGAL_DATA_ADDRESS);
+    uint8_t gap[] = {9, 0x10, 0x00, 0x21, 0x00, 0x02, 4, 0, 1, 0, 2};
+    cheat_assert(modbus_test_request(&slave, gap, sizeof(gap)) == 3 && modbus_test_resp[2] == 0x02);
+    cheat_assert(modbus_test_regs[0x21] == 0);
+    uint8_t refused[] = {9, 0x06, 0x00, 0x10, 0xDE, 0xAD};
+    cheat_assert(modbus_test_request(&slave, refused, sizeof(refused)) == 3 &&
+                 modbus_test_resp[2] == MODBUS_ERR_ILLEGAL_DATA_VALUE);
+
+    // broadcast writes are executed without a response, other slaves are ignored
+    single[0] = 0;
+    single[5] = 0xEF;
+    cheat_assert(modbus_test_request(&slave, single, sizeof(single)) == 0);
+    cheat_assert(modbus_test_regs[0x12] == 0xABEF);
+    single[0] = 8;
+    single[5] = 0x00;
+    cheat_assert(modbus_test_request(&slave, single, sizeof(single)) == 0);
+    cheat_assert(modbus_test_regs[0x12] == 0xABEF);
+
+    // 123 registers is the largest write
+    uint8_t big[7 + 2 * MODBUS_WRITE_REGS_MAX] = {9, 0x10, 0x00, 0x00, 0x00, MODBUS_WRITE_REGS_MAX,
+                                                   2 * MODBUS_WRITE_REGS_MAX};
+    cheat_assert(modbus_test_request(&slave, big, sizeof(big)) == 3 && modbus_test_resp[2] == 0x02);
+
+    uint8_t unknown[] = {9, 0x2B, 0x0E, 0x01, 0x00};
+    cheat_assert(modbus_test_request(&slave, unknown, sizeof(unknown)) == 3 && modbus_test_resp[1] == 0xAB &&
+                 modbus_test_resp[2] == MODBUS_ERR_ILLEGAL_FUNCTION);
+)
+
+CHEAT_TEST(modbus_recv_frame,
+    static modbus_reg_desc_t holding[2] = {
+        {.reg_start_addr = 0x10, .reg_map_len = 16, .read_handler = modbus_test_read, .write_handler = modbus_test_write_10},
+        {.reg_start_addr = 0x20, .reg_map_len = 2, .read_handler = modbus_test_read, .write_handler = modbus_test_write_20},
+    };
+    modbus_slave_init_t desc = {.holding_regs = holding, .holding_reg_cnt = 2,
+                                .request_pdu_transmit = modbus_test_transmit};
+    modbus_slave_t slave;
+    cheat_assert(modbus_slave_init(&slave, &desc, 5) == ALL_OK);
+    memset(modbus_test_regs, 0, sizeof(modbus_test_regs));
+
+    // the same response as the byte handler gives
+    uint8_t frame[] = {5, 0x03, 0x00, 0x1E, 0x00, 0x03, 0, 0};
+    uint16_t crc = modbus_test_crc(frame, 6);
+    frame[6] = crc & 0xFF;
+    frame[7] = crc >> 8;
+    uint8_t expect[MODBUS_ADU_MAX];
+    uint32_t expect_len = modbus_test_request(&slave, frame, 6) + 2;
+    cheat_assert(expect_len == 11);
+    memcpy(expect, modbus_test_resp, expect_len);
+
+    modbus_test_resp_len = 0;
+    cheat_assert(modbus_slave_recv_frame(&slave, frame, sizeof(frame)) == ALL_OK);
+    cheat_assert(modbus_test_resp_len == expect_len && memcmp(modbus_test_resp, expect, expect_len) == 0);
+
+    // wrapped around the end of a ring, and not wrapped
+    uint8_t ring[16];
+    for (uint32_t start = 0; start < sizeof(ring); start++)
+    {
+        for (uint32_t i = 0; i < sizeof(frame); i++)
+            ring[(start + i) % sizeof(ring)] = frame[i];
+        modbus_test_resp_len = 0;
+        cheat_assert(modbus_slave_recv_ring(&slave, ring, sizeof(ring), start, sizeof(frame)) == ALL_OK);
+        cheat_assert(modbus_test_resp_len == expect_len && memcmp(modbus_test_resp, expect, expect_len) == 0);
+    }
+    cheat_assert(modbus_slave_recv_ring(&slave, ring, sizeof(ring), sizeof(ring), 8) == E_INVALID_ARGUMENT);
+
+    // a bad CRC, a short frame and another slave get no response
+    modbus_test_resp_len = 0;
+    frame[7] ^= 1;
+    cheat_assert(modbus_slave_recv_frame(&slave, frame, sizeof(frame)) == E_INVALID_ARGUMENT);
+    cheat_assert(modbus_slave_recv_frame(&slave, frame, 3) == E_INVALID_ARGUMENT);
+    frame[7] ^= 1;
+    frame[0] = 6;
+    cheat_assert(modbus_slave_recv_frame(&slave, frame, sizeof(frame)) == ALL_OK);
+    cheat_assert(modbus_test_resp_len == 0);
+
+    // a broadcast write is executed without a response
+    uint8_t write[] = {0, 0x06, 0x00, 0x21, 0x12, 0x34, 0, 0};
+    crc = modbus_test_crc(write, 6);
+    write[6] = crc & 0xFF;
+    write[7] = crc >> 8;
+    cheat_assert(modbus_slave_recv_frame(&slave, write, sizeof(write)) == ALL_OK);
+    cheat_assert(modbus_test_resp_len == 0 && modbus_test_regs[0x21] == 0x1234);
+)
+
+CHEAT_TEST(modbus_send_frame,
+    static modbus_reg_desc_t holding[1] = {{.reg_start_addr = 0, .reg_map_len = 8, .read_handler = modbus_test_read}};
+    modbus_slave_init_t desc = {.holding_regs = holding, .holding_reg_cnt = 1,
+                                .request_pdu_transmit = modbus_test_transmit};
+    modbus_slave_t slave;
+    cheat_assert(modbus_slave_init(&slave, &desc, 3) == ALL_OK);
+
+    const uint8_t *frame;
+    uint32_t size;
+    cheat_assert(modbus_slave_send_frame(&slave, &frame, &size) == E_INVALID_OPERATION);
+
+    // the whole response at once, the same as request_pdu_transmit got
+    uint8_t req[] = {3, 0x03, 0x00, 0x02, 0x00, 0x04};
+    cheat_assert(modbus_test_request(&slave, req, sizeof(req)) == 11);
+    cheat_assert(modbus_slave_send_frame(&slave, &frame, &size) == ALL_OK);
+    cheat_assert(size == modbus_test_resp_len && memcmp(frame, modbus_test_resp, size) == 0);
+    modbus_slave_send_cplt_handler(&slave);
+    cheat_assert(modbus_slave_send_frame(&slave, &frame, &size) == E_INVALID_OPERATION);
+
+    // byte by byte, until MODBUS_SEND_CPLT
+    cheat_assert(modbus_test_request(&slave, req, sizeof(req)) == 11);
+    uint8_t byte;
+    for (uint32_t i = 0; i < modbus_test_resp_len; i++)
+        cheat_assert(modbus_slave_send_get_data(&slave, &byte) == MODBUS_SEND_NORMAL && byte == modbus_test_resp[i]);
+    cheat_assert(modbus_slave_send_get_data(&slave, &byte) == MODBUS_SEND_CPLT);
+    cheat_assert(modbus_slave_send_frame(&slave, &frame, &size) == E_INVALID_OPERATION);
+)
+
+CHEAT_TEST(modbus_recv_short_frame,
+    static modbus_reg_desc_t holding[1] = {{.reg_start_addr = 0, .reg_map_len = 8, .read_handler = modbus_test_read}};
+    modbus_slave_init_t desc = {.holding_regs = holding, .holding_reg_cnt = 1,
+                                .request_pdu_transmit = modbus_test_transmit};
+    modbus_slave_t slave;
+    cheat_assert(modbus_slave_init(&slave, &desc, 4) == ALL_OK);
+
+    // address, function and CRC only, in a buffer of exactly that size
+    static const uint8_t funcs[] = {0x07, MODBUS_FN_READ_HOLDING_REGISTERS, MODBUS_FN_WRITE_SINGLE_REGISTER,
+                                    MODBUS_FN_WRITE_MULTIPLE_REGISTERS};
+    for (size_t f = 0; f < sizeof(funcs); f++)
+    {
+        uint8_t *frame = malloc(4);
+        frame[0] = 4;
+        frame[1] = funcs[f];
+        uint16_t crc = modbus_test_crc(frame, 2);
+        frame[2] = crc & 0xFF;
+        frame[3] = crc >> 8;
+
+        modbus_test_resp_len = 0;
+        cheat_assert(modbus_slave_recv_frame(&slave, frame, 4) == ALL_OK);
+        cheat_assert(modbus_test_resp_len == 5 && modbus_test_resp[1] == (funcs[f] | 0x80));
+        cheat_assert(modbus_test_resp[2] ==
+                     (f ? MODBUS_ERR_ILLEGAL_DATA_VALUE : MODBUS_ERR_ILLEGAL_FUNCTION));
+
+        // the same frame at the end of a ring
+        uint8_t ring[8];
+        memcpy(ring + 4, frame, 4);
+        modbus_test_resp_len = 0;
+        cheat_assert(modbus_slave_recv_ring(&slave, ring, sizeof(ring), 4, 4) == ALL_OK);
+        cheat_assert(modbus_test_resp_len == 5 && modbus_test_resp[1] == (funcs[f] | 0x80));
+        free(frame);
+    }
+)
@@ -2,6 +2,8 @@
 #define __BASE_FILE__ __FILE__
 #endif
 
+#include <stdlib.h>
+#include <math.h>
 #include <cheat.h>
 #include <libe15-pid.h>
 
@@ -16,4 +18,201 @@ CHEAT_TEST(pid_value_init_test,
     pid_init_controller(kp, ki, kd, &pid_state);
 
     cheat_assert(pid_state.kp.val == kp.val);
-)
\ No newline at end of file
+)
+
+#define PID_TEST_BANK 45
+
+CHEAT_DECLARE(
+    static uint32_t pid_test_callback_count;
+
+    static void pid_test_bank_callback(pid_bank_t *bank, const fixed_t *output, uint32_t count)
+    {
+        (void)bank;
+        (void)output;
+        pid_test_callback_count += count;
+    }
+)
+
+CHEAT_TEST(pid_bank_update_test,
+    fixed_t storage[PID_BANK_STORAGE_WORDS(PID_TEST_BANK)];
+    pid_state_t single[PID_TEST_BANK];
+    pid_bank_t bank;
+
+    pid_bank_init(&bank, storage, PID_TEST_BANK);
+    pid_bank_set_callback(&bank, pid_test_bank_callback);
+    for (int i = 0; i < PID_TEST_BANK; i++)
+    {
+        // gains and errors small enough that nothing saturates
+        fixed_t kp = {rand() % 0x40000 - 0x20000}, ki = {rand() % 0x4000}, kd = {rand() % 0x40000};
+        pid_bank_set_gains(&bank, i, kp, ki, kd);
+        pid_init_controller(kp, ki, kd, &single[i]);
+    }
+
+    for (int step = 0; step < 200; step++)
+    {
+        fixed_t error[PID_TEST_BANK];
+        fixed_t error_i[PID_TEST_BANK];
+        for (int i = 0; i < PID_TEST_BANK; i++)
+        {
+            error[i].val = rand() % 0x80000 - 0x40000;
+            error_i[i] = bank.error_i[i];
+        }
+        fixed_t last[PID_TEST_BANK];
+        for (int i = 0; i < PID_TEST_BANK; i++)
+            last[i] = bank.error[i];
+
+        pid_bank_update(&bank, error);
+
+        for (int i = 0; i < PID_TEST_BANK; i++)
+        {
+            pid_update_controller(&single[i], error[i]);
+            cheat_assert(bank.error_i[i].val == single[i].error_i.val);
+            cheat_assert(abs(bank.output[i].val - single[i].output.val) <= 3);
+
+            // one rounding of the exact sum
+            int64_t acc = (int64_t)bank.kp[i].val * error[i].val +
+                          (int64_t)bank.ki[i].val * (error_i[i].val + error[i].val) +
+                          (int64_t)bank.kd[i].val * (error[i].val - last[i].val);
+            cheat_assert(bank.output[i].val == (acc + 0x8000) >> 16);
+        }
+    }
+    cheat_assert(pid_test_callback_count == 200 * PID_TEST_BANK);
+
+    // a clamped integrator and output, the same on every lane
+    for (int i = 0; i < PID_TEST_BANK; i++)
+        pid_bank_set_gains(&bank, i, fixed_from_int(1000), fixed_from_int(1), FIXED_ZERO);
+    fixed_t big[PID_TEST_BANK];
+    for (int i = 0; i < PID_TEST_BANK; i++)
+        big[i] = fixed_from_int(i & 1 ? 30000 : -30000);
+    pid_bank_update(&bank, big);
+    pid_bank_update(&bank, big);
+    for (int i = 0; i < PID_TEST_BANK; i++)
+    {
+        cheat_assert(bank.error_i[i].val == (i & 1 ? INT32_MAX : INT32_MIN));
+        cheat_assert(bank.output[i].val == (i & 1 ? INT32_MAX : INT32_MIN));
+    }
+
+    pid_bank_reset(&bank);
+    cheat_assert(bank.output[PID_TEST_BANK - 1].val == 0 && bank.error_i[0].val == 0);
+    cheat_assert(bank.kp[0].val == fixed_from_int(1000).val);
+)
+
+CHEAT_TEST(pid_incr_against_double,
+    // 10 kHz, derivative filtered at 500 Hz, kp 2.5, ki 40, kd 0.002
+    const fixed_t kp = {163840}, ki = {40 << 16}, kd = {131};
+    const double ts = 1e-4, tf = 1 / (2 * 3.14159265358979 * 500);
+    pid_incr_t pid;
+    cheat_assert(pid_incr_init(&pid, kp, ki, kd, 0, 500, fixed_from_int(-100), fixed_from_int(100)) == E_INVALID_ARGUMENT);
+    cheat_assert(pid_incr_init(&pid, kp, ki, kd, 10000, 500, fixed_from_int(-100), fixed_from_int(100)) == ALL_OK);
+
+    double u = 0, d = 0, e1 = 0;
+    for (int i = 0; i < 5000; i++)
+    {
+        double e = 3 * sin(i * 0.003) + ((i / 700) & 1 ? 1.5 : -1.5);
+        pid_incr_update(&pid, (fixed_t){(fixed_value_t)lround(e * 65536)});
+
+        double d_new = tf / (tf + ts) * d + kd.val / 65536.0 / (tf + ts) * (e - e1);
+        u += kp.val / 65536.0 * (e - e1) + ki.val / 65536.0 * ts * e + d_new - d;
+        d = d_new;
+        e1 = e;
+        cheat_assert(fabs(pid.output.val / 65536.0 - u) < 2e-3);
+    }
+)
+
+CHEAT_TEST(pid_incr_windup,
+    pid_incr_t pid;
+    // tiny ki Ts, the increments are far below 1 LSB of fixed_t
+    pid_incr_init(&pid, FIXED_ZERO, fixed_from_int(1), FIXED_ZERO, 100000, 0,
+                  fixed_from_int(-1), fixed_from_int(1));
+    fixed_t e = {655}; // 0.01
+    for (int i = 0; i < 100000; i++)
+        pid_incr_update(&pid, e);
+    // 1 s of 0.01 integrated
+    cheat_assert(abs(pid.output.val - 655) <= 1);
+
+    // held at the limit, and leaves it on the first step back
+    pid_incr_init(&pid, fixed_from_int(1), fixed_from_int(100), FIXED_ZERO, 1000, 0,
+                  fixed_from_int(-1), fixed_from_int(1));
+    for (int i = 0; i < 10000; i++)
+        cheat_assert(pid_incr_update(&pid, fixed_from_int(10)).val <= FIXED_ONE.val);
+    cheat_assert(pid.output.val == FIXED_ONE.val);
+    cheat_assert(pid_incr_update(&pid, fixed_from_int(-1)).val < FIXED_ONE.val);
+
+    pid_incr_reset(&pid, fixed_from_int(5));
+    cheat_assert(pid.output.val == FIXED_ONE.val);
+)
+
+CHEAT_DECLARE(
+    static uint32_t pid_test_clock_now;
+
+    /// every read of the clock advances it by 10
+    static uint32_t pid_test_clock(void)
+    {
+        return pid_test_clock_now += 10;
+    }
+
+    /// the feedback of a stage is in its user pointer, each read counts
+    static fixed_t pid_test_measure(pid_cascade_stage_t *stage)
+    {
+        fixed_t *feedback = stage->user;
+        pid_test_clock_now += stage->divider;
+        return *feedback;
+    }
+)
+
+CHEAT_TEST(pid_cascade_rates,
+    // position, velocity, current at 1 / 5 / 20 kHz of a 20 kHz tick
+    pid_state_t pid[3];
+    pid_cascade_stage_t stages[3];
+    pid_cascade_t cascade;
+    fixed_t feedback[3] = {fixed_from_int(1), fixed_from_int(2), fixed_from_int(3)};
+    const uint32_t divider[3] = {20, 4, 1};
+
+    for (int i = 0; i < 3; i++)
+    {
+        pid_init_controller(fixed_from_int(2), FIXED_ZERO, FIXED_ZERO, &pid[i]);
+        pid_cascade_stage_init(&stages[i], &pid[i], pid_test_measure, divider[i], 0);
+        stages[i].user = &feedback[i];
+    }
+    pid_cascade_init(&cascade, stages, 3, pid_test_clock);
+    pid_cascade_set_setpoint(&cascade, fixed_from_int(10));
+
+    // the first tick runs all stages, outer outputs feed forward at once
+    fixed_t out = pid_cascade_tick(&cascade);
+    cheat_assert(pid[0].output.val == fixed_from_int(2 * (10 - 1)).val);
+    cheat_assert(stages[1].setpoint.val == pid[0].output.val);
+    cheat_assert(pid[1].output.val == fixed_from_int(2 * (18 - 2)).val);
+    cheat_assert(out.val == fixed_from_int(2 * (32 - 3)).val);
+
+    for (uint32_t t = 1; t < 100; t++)
+    {
+        pid_cascade_tick(&cascade);
+        // only the inner stages run between the outer ones
+        if (t % 20 != 0)
+            cheat_assert(stages[0].countdown == 20 - t % 20);
+    }
+    cheat_assert(stages[0].runs == 5 && stages[1].runs == 25 && stages[2].runs == 100);
+
+    // the measure callback moves the clock by the divider, plus 10 per read
+    cheat_assert(stages[0].cycles_last == 30 && stages[0].cycles_max == 30);
+    cheat_assert(stages[2].cycles_total == 100 * 11);
+
+    pid_cascade_clear_stats(&cascade);
+    cheat_assert(stages[0].runs == 0 && stages[2].cycles_total == 0);
+
+    // a phase spreads stages of the same rate over the ticks
+    pid_cascade_stage_init(&stages[0], &pid[0], pid_test_measure, 4, 1);
+    pid_cascade_stage_init(&stages[1], &pid[1], pid_test_measure, 4, 3);
+    stages[0].user = &feedback[0];
+    stages[1].user = &feedback[1];
+    for (int t = 0; t < 8; t++)
+    {
+        pid_cascade_tick(&cascade);
+        cheat_assert(stages[0].runs + stages[1].runs == (uint32_t)((t >= 1) + (t >= 3) + (t >= 5) + (t >= 7)));
+    }
+
+    // a cascade without stages does nothing
+    pid_cascade_init(&cascade, stages, 0, pid_test_clock);
+    cheat_assert(pid_cascade_tick(&cascade).val == 0);
+    cheat_assert(stages[0].runs + stages[1].runs == 4);
+)
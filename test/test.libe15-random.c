@@ -0,0 +1,277 @@
+#ifndef __BASE_FILE__
+#define __BASE_FILE__ __FILE__
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <cheat.h>
+#include <random.h>
+
+#define RANDOM_TEST_BUCKETS 256
+#define RANDOM_TEST_SAMPLES (RANDOM_TEST_BUCKETS * 1024)
+
+CHEAT_DECLARE(
+    /**
+     * @brief chi-square of the top byte of RANDOM_TEST_SAMPLES numbers,
+     *        255 degrees of freedom, mean 255 and sigma 22.6
+     */
+    static double random_test_chi2(const uint32_t *v)
+    {
+        uint32_t count[RANDOM_TEST_BUCKETS] = {0};
+        for (int i = 0; i < RANDOM_TEST_SAMPLES; i++)
+            count[v[i] >> 24]++;
+
+        double chi2 = 0, expect = RANDOM_TEST_SAMPLES / RANDOM_TEST_BUCKETS;
+        for (int b = 0; b < RANDOM_TEST_BUCKETS; b++)
+            chi2 += (count[b] - expect) * (count[b] - expect) / expect;
+        return chi2;
+    }
+)
+
+CHEAT_TEST(random_reference_vectors,
+    // pcg32-demo, pcg32_srandom_r(&rng, 42, 54)
+    static const uint32_t pcg[] = {0xa15c02b7, 0x7b47f409, 0xba1d3330, 0x83d2f293, 0xbfa4784b, 0xcbed606e};
+    rand_pcg32_t p;
+    rand_pcg32_seed(&p, 42, 54);
+    for (int i = 0; i < 6; i++)
+        cheat_assert(rand_pcg32_next(&p) == pcg[i]);
+
+    static const uint64_t xoshiro[] = {11520, 0, 1509978240, 1215971899390074240u, 1216172134540287360u};
+    rand_xoshiro256ss_t x = {{1, 2, 3, 4}};
+    for (int i = 0; i < 5; i++)
+        cheat_assert(rand_xoshiro256ss_next(&x) == xoshiro[i]);
+
+    rand_splitmix64_t sm = {1234567};
+    cheat_assert(rand_splitmix64_next(&sm) == 6457827717110365317u);
+    cheat_assert(rand_splitmix64_next(&sm) == 3203168211198807973u);
+
+    rand_xorshift128p_t y = {{1, 2}};
+    cheat_assert(rand_xorshift128p_next(&y) == 3);
+    cheat_assert(rand_xorshift128p_next(&y) == 0x800025);
+
+    // a jump is a polynomial of the step, the two commute
+    rand_xoshiro256ss_t j1, j2;
+    rand_xoshiro256ss_seed(&j1, 99);
+    j2 = j1;
+    rand_xoshiro256ss_jump(&j1);
+    rand_xoshiro256ss_next(&j1);
+    rand_xoshiro256ss_next(&j2);
+    rand_xoshiro256ss_jump(&j2);
+    cheat_assert(memcmp(&j1, &j2, sizeof(j1)) == 0);
+)
+
+CHEAT_TEST(random_fill_lanes,
+    static uint32_t buf[1000];
+    rand_fill_t fill;
+    rand_xoshiro256ss_t lane[RAND_FILL_LANES];
+
+    rand_fill_seed(&fill, 12345);
+    rand_xoshiro256ss_seed(&lane[0], 12345);
+    for (int l = 1; l < RAND_FILL_LANES; l++)
+    {
+        lane[l] = lane[l - 1];
+        rand_xoshiro256ss_jump(&lane[l]);
+    }
+
+    // whole steps, then a short call that drops part of its last step
+    for (int call = 0; call < 3; call++)
+    {
+        size_t n = call == 1 ? 21 : 1000 / (2 * RAND_FILL_LANES) * (2 * RAND_FILL_LANES);
+        memset(buf, 0, sizeof(buf));
+        rand_fill_u32(&fill, buf, n);
+        for (size_t i = 0; i < n; i += 2 * RAND_FILL_LANES)
+        {
+            for (int l = 0; l < RAND_FILL_LANES; l++)
+            {
+                uint64_t r = rand_xoshiro256ss_next(&lane[l]);
+                if (i + 2 * l < n)
+                    cheat_assert(buf[i + 2 * l] == (uint32_t)r);
+                if (i + 2 * l + 1 < n)
+                    cheat_assert(buf[i + 2 * l + 1] == (uint32_t)(r >> 32));
+            }
+        }
+        cheat_assert(buf[n] == 0);
+    }
+)
+
+CHEAT_TEST(random_uniformity,
+    static uint32_t v[RANDOM_TEST_SAMPLES];
+    rand_xorshift128p_t xs;
+    rand_xoshiro256ss_t xo;
+    rand_pcg32_t pcg;
+    rand_fill_t fill;
+
+    // 6 sigma either way
+    rand_xorshift128p_seed(&xs, 1);
+    for (int i = 0; i < RANDOM_TEST_SAMPLES; i++)
+        v[i] = rand_xorshift128p_next(&xs) >> 32;
+    cheat_assert(random_test_chi2(v) < 255 + 6 * 22.6);
+
+    rand_xoshiro256ss_seed(&xo, 2);
+    for (int i = 0; i < RANDOM_TEST_SAMPLES; i++)
+        v[i] = (uint32_t)rand_xoshiro256ss_next(&xo);
+    cheat_assert(random_test_chi2(v) < 255 + 6 * 22.6);
+
+    rand_pcg32_seed(&pcg, 3, 0);
+    for (int i = 0; i < RANDOM_TEST_SAMPLES; i++)
+        v[i] = rand_pcg32_next(&pcg);
+    cheat_assert(random_test_chi2(v) < 255 + 6 * 22.6);
+
+    rand_fill_seed(&fill, 4);
+    rand_fill_u32(&fill, v, RANDOM_TEST_SAMPLES);
+    double chi2 = random_test_chi2(v);
+    cheat_assert(chi2 < 255 + 6 * 22.6 && chi2 > 255 - 6 * 22.6);
+)
+
+CHEAT_TEST(random_lcg_minstd,
+    static const uint32_t multipliers[] = {48271, 16807, 0x7ffffffe, 1};
+    for (int m = 0; m < 4; m++)
+    {
+        rand_lcg_t lcg = LCG_DEFAULT_INIT((uint32_t)rand() * 2654435761u);
+        lcg.multiplier = multipliers[m];
+        lcg.increment = m == 3 ? 0xffffffffu : 0;
+
+        // the Mersenne reduction against the 64bit modulo
+        for (int i = 0; i < 100000; i++)
+        {
+            uint32_t seed = lcg.seed;
+            uint64_t expect = ((uint64_t)lcg.multiplier * seed + lcg.increment) % RAND_MINSTD_MODULUS;
+            cheat_assert(rand_lcg_next(&lcg) == expect);
+        }
+    }
+
+    // MINSTD has the full period 2^31 - 2
+    rand_lcg_t lcg = LCG_DEFAULT_INIT(12345678);
+    rand_lcg_skip(&lcg, RAND_MINSTD_MODULUS - 1);
+    cheat_assert(lcg.seed == 12345678);
+    rand_lcg_skip(&lcg, (uint64_t)(RAND_MINSTD_MODULUS - 1) * 1000 + 1);
+    cheat_assert(lcg.seed == 12345678u * 48271ull % RAND_MINSTD_MODULUS);
+)
+
+CHEAT_TEST(random_lcg_skip,
+    static const rand_lcg_t gens[] = {
+        LCG_DEFAULT_INIT(1),
+        {.seed = 42, .multiplier = 69069, .increment = 1, .modulus = 1000003},
+        {.seed = 7, .multiplier = 1103515245, .increment = 12345, .modulus = 0x80000000u},
+    };
+    for (int g = 0; g < 3; g++)
+    {
+        // skips of random length against the same number of steps
+        rand_lcg_t step = gens[g];
+        for (int k = 0; k < 50; k++)
+        {
+            rand_lcg_t skip = step;
+            uint32_t n = rand() % 2000;
+            for (uint32_t i = 0; i < n; i++)
+                rand_lcg_next(&step);
+            rand_lcg_skip(&skip, n);
+            cheat_assert(skip.seed == step.seed);
+        }
+    }
+)
+
+#define RANDOM_TEST_DIST (1 << 20)
+
+CHEAT_TEST(random_uniform_fixed,
+    static fixed_t v[RANDOM_TEST_DIST];
+    rand_xoshiro256ss_t rng;
+    rand_xoshiro256ss_seed(&rng, 5);
+
+    // the whole range of fixed_t, and a narrow one
+    rand_uniform_fixed_fill(&rng, v, RANDOM_TEST_DIST, FIXED_MIN_NINF, FIXED_MAX_INF);
+    double mean = 0;
+    for (int i = 0; i < RANDOM_TEST_DIST; i++)
+        mean += v[i].val / 65536.0 / RANDOM_TEST_DIST;
+    cheat_assert(fabs(mean) < 32768 * 0.01);
+
+    fixed_t a = fixed_from_int(-3), b = fixed_from_int(5);
+    uint32_t count[8] = {0};
+    rand_uniform_fixed_fill(&rng, v, RANDOM_TEST_DIST / 2, a, b);
+    for (int i = RANDOM_TEST_DIST / 2; i < RANDOM_TEST_DIST; i++)
+        v[i] = rand_uniform_fixed(&rng, a, b);
+    for (int i = 0; i < RANDOM_TEST_DIST; i++)
+    {
+        cheat_assert(v[i].val >= a.val && v[i].val < b.val);
+        count[(v[i].val - a.val) >> 16]++;
+    }
+    for (int k = 0; k < 8; k++)
+        cheat_assert(fabs(count[k] - RANDOM_TEST_DIST / 8.0) < 6 * sqrt(RANDOM_TEST_DIST / 8.0));
+)
+
+CHEAT_TEST(random_normal_fixed,
+    static fixed_t v[RANDOM_TEST_DIST];
+    rand_xoshiro256ss_t rng, copy;
+    rand_xoshiro256ss_seed(&rng, 6);
+    copy = rng;
+
+    rand_normal_fixed_fill(&rng, v, RANDOM_TEST_DIST, FIXED_ZERO, FIXED_ONE);
+    for (int i = 0; i < 1000; i++)
+        cheat_assert(rand_normal_fixed(&copy, FIXED_ZERO, FIXED_ONE).val == v[i].val);
+
+    // moments, and the fraction within 1, 2, 3 sigma and beyond the tail start
+    double sum = 0, sum2 = 0, sum4 = 0;
+    uint32_t within[3] = {0}, tail = 0;
+    for (int i = 0; i < RANDOM_TEST_DIST; i++)
+    {
+        double x = v[i].val / 65536.0;
+        sum += x;
+        sum2 += x * x;
+        sum4 += x * x * x * x;
+        for (int s = 0; s < 3; s++)
+            within[s] += fabs(x) < s + 1;
+        tail += fabs(x) > 3.442619855899;
+    }
+    double n = RANDOM_TEST_DIST;
+    cheat_assert(fabs(sum / n) < 5 / sqrt(n));
+    cheat_assert(fabs(sum2 / n - 1) < 5 * sqrt(2 / n));
+    cheat_assert(fabs(sum4 / n - 3) < 5 * sqrt(96 / n));
+    static const double expect[3] = {0.682689492137, 0.954499736104, 0.997300203937};
+    for (int s = 0; s < 3; s++)
+        cheat_assert(fabs(within[s] / n - expect[s]) < 5 * sqrt(expect[s] * (1 - expect[s]) / n));
+    cheat_assert(fabs(tail - 5.7607e-4 * n) < 5 * sqrt(5.7607e-4 * n));
+
+    // mean and sigma are applied to the same N(0, 1) values, and saturate
+    fixed_t m = fixed_from_int(100), sigma = {FIXED_ONE.val / 4};
+    for (int i = 0; i < 1000; i++)
+    {
+        rand_xoshiro256ss_t again = copy;
+        fixed_t z = rand_normal_fixed(&copy, FIXED_ZERO, FIXED_ONE);
+        fixed_t scaled = rand_normal_fixed(&again, m, sigma);
+        cheat_assert(abs(scaled.val - m.val - z.val / 4) <= 1);
+    }
+    for (int i = 0; i < 1000; i++)
+    {
+        // about half of these are above FIXED_MAX_INF, none may wrap around
+        fixed_t big = rand_normal_fixed(&rng, fixed_from_int(32000), fixed_from_int(1000));
+        cheat_assert(big.val > fixed_from_int(32000 - 7000).val);
+    }
+)
+
+CHEAT_TEST(random_triangular_fixed,
+    static fixed_t v[RANDOM_TEST_DIST];
+    rand_xoshiro256ss_t rng;
+    rand_xoshiro256ss_seed(&rng, 7);
+
+    // one of 256 levels of a full scale of 1
+    fixed_t lsb = {FIXED_ONE.val >> 8};
+    rand_triangular_fixed_fill(&rng, v, RANDOM_TEST_DIST, lsb);
+    double sum = 0, sum2 = 0;
+    uint32_t inner = 0;
+    for (int i = 0; i < RANDOM_TEST_DIST; i++)
+    {
+        cheat_assert(v[i].val > -lsb.val && v[i].val < lsb.val);
+        double x = (double)v[i].val / lsb.val;
+        sum += x;
+        sum2 += x * x;
+        inner += fabs(x) < 0.5;
+    }
+    double n = RANDOM_TEST_DIST;
+    cheat_assert(fabs(sum / n) < 5 * sqrt(1 / 6.0 / n));
+    cheat_assert(fabs(sum2 / n - 1 / 6.0) < 0.005);
+    // 3/4 of a triangle lies within half its width
+    cheat_assert(fabs(inner / n - 0.75) < 5 * sqrt(0.75 * 0.25 / n));
+
+    fixed_t t = rand_triangular_fixed(&rng, FIXED_ONE);
+    cheat_assert(t.val > -FIXED_ONE.val && t.val < FIXED_ONE.val);
+)
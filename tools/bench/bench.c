@@ -0,0 +1,848 @@
+/**
+ * @file bench.c
+ * @author simakeng (simakeng@outlook.com)
+ * @brief Host side speed and error benchmark of libe15 math kernels
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * run `make bench` for all sections, or `bench <section> ...` for some
+ * of them. ns/op numbers are from the host cpu, only compare them with
+ * each other.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#include <libe15-fpa.h>
+#include <libe15-pid.h>
+#include <qformat.h>
+#include <fpa_array.h>
+#include <fft.h>
+#include <filter.h>
+#include <foc.h>
+#include <random.h>
+#include <modbus.h>
+#include <fft_twiddle.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_TSC 1
+#endif
+
+/// `stmt` only where the time stamp counter can be read
+#ifdef BENCH_HAS_TSC
+#define BENCH_TSC(stmt) stmt
+#else
+#define BENCH_TSC(stmt)
+#endif
+
+#define BENCH_SAMPLES (1 << 20)
+#define BENCH_ROUNDS 8
+
+static fixed_t bench_a[BENCH_SAMPLES];
+static fixed_t bench_b[BENCH_SAMPLES];
+
+/// results are added here, so the compiler can not drop the calls
+static volatile fixed_value_t bench_sink;
+
+/**
+ * @brief time `expr` over all samples, `i` is the index of the sample
+ */
+#define BENCH_RUN(name, expr)                                                 \
+    do                                                                        \
+    {                                                                         \
+        fixed_value_t acc = 0;                                                \
+        double start = bench_now_ns();                                        \
+        for (int round = 0; round < BENCH_ROUNDS; round++)                    \
+            for (int i = 0; i < BENCH_SAMPLES; i++)                           \
+                acc += (expr).val;                                            \
+        double ns = (bench_now_ns() - start) / BENCH_ROUNDS / BENCH_SAMPLES; \
+        bench_sink = acc;                                                     \
+        printf("  %-28s %8.2f ns/op\n", name, ns);                           \
+    } while (0)
+
+static double bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief xorshift32, the inputs are the same on every run
+ */
+static uint32_t bench_rand(void)
+{
+    static uint32_t state = 2463534242u;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+/**
+ * @brief full range value with a random magnitude, so small and large
+ *        operands are both covered.
+ */
+static fixed_t bench_rand_fixed(void)
+{
+    return (fixed_t){(fixed_value_t)bench_rand() >> (bench_rand() % 31)};
+}
+
+static void bench_div(void)
+{
+    for (int i = 0; i < BENCH_SAMPLES; i++)
+    {
+        bench_a[i] = bench_rand_fixed();
+        do
+            bench_b[i] = bench_rand_fixed();
+        while (bench_b[i].val == 0);
+    }
+
+    BENCH_RUN("fixed_div", fixed_div(bench_a[i], bench_b[i]));
+    BENCH_RUN("fixed_div_fast", fixed_div_fast(bench_a[i], bench_b[i]));
+    BENCH_RUN("fixed_reciprocal", fixed_reciprocal(bench_b[i]));
+
+    // error of fixed_div_fast against fixed_div, where the quotient fits
+    uint64_t count = 0, exact = 0, err_sum = 0, err_max = 0;
+    for (int i = 0; i < BENCH_SAMPLES; i++)
+    {
+        int64_t ref = ((int64_t)bench_a[i].val << FIXED_WIDTH) / bench_b[i].val;
+        if (ref > INT32_MAX || ref < INT32_MIN)
+            continue;
+        int64_t val = fixed_div_fast(bench_a[i], bench_b[i]).val;
+        uint64_t err = (uint64_t)llabs(val - ref);
+        count++;
+        exact += err == 0;
+        err_sum += err;
+        if (err > err_max)
+            err_max = err;
+    }
+    printf("  fixed_div_fast error: max %llu LSB, mean %.4f LSB, exact %.2f%%\n",
+           (unsigned long long)err_max, (double)err_sum / count, 100.0 * exact / count);
+}
+
+static void bench_sqrt(void)
+{
+    for (int i = 0; i < BENCH_SAMPLES; i++)
+        bench_a[i] = fixed_abs(bench_rand_fixed());
+
+    BENCH_RUN("fixed_sqrt", fixed_sqrt(bench_a[i]));
+    BENCH_RUN("fixed_rsqrt", fixed_rsqrt(bench_a[i]));
+}
+
+/// sin + cos, BENCH_RUN takes one fixed_t expression
+static inline fixed_t bench_sincos_sum(fixed_t v)
+{
+    fixed_t sn, cs;
+    fixed_sincos(v, &sn, &cs);
+    return (fixed_t){sn.val + cs.val};
+}
+
+static inline fixed_t bench_sincos_bam_sum(uint32_t bam)
+{
+    fixed_t sn, cs;
+    fixed_sincos_bam(bam, &sn, &cs);
+    return (fixed_t){sn.val + cs.val};
+}
+
+/**
+ * the sin / cos backend selected in menuconfig, the table is the one
+ * generated for it. `make trig_report` has the error of every table size.
+ */
+static void bench_trig(void)
+{
+#if defined(CONFIG_FPA_TRIG_LUT)
+    printf("  backend: table, 2^%d entries per quarter wave, %s, %s\n", CONFIG_FPA_TRIG_LUT_BITS,
+#if defined(CONFIG_FPA_TRIG_LUT_Q15)
+           "Q15",
+#else
+           "Q30",
+#endif
+#if defined(CONFIG_FPA_TRIG_LUT_QUADRATIC)
+           "quadratic");
+#else
+           "linear");
+#endif
+#else
+    printf("  backend: CORDIC\n");
+#endif
+
+    // within [-2π, 2π], where sin and cos are gated in the sweep
+    for (int i = 0; i < BENCH_SAMPLES; i++)
+        bench_a[i] = (fixed_t){(fixed_value_t)(bench_rand() % (2 * 411775u)) - 411775};
+
+    BENCH_RUN("fixed_sin", fixed_sin(bench_a[i]));
+    BENCH_RUN("fixed_cos", fixed_cos(bench_a[i]));
+    BENCH_RUN("fixed_sincos", bench_sincos_sum(bench_a[i]));
+    BENCH_RUN("fixed_sincos_bam", bench_sincos_bam_sum((uint32_t)bench_a[i].val << 12));
+}
+
+static void bench_qformat(void)
+{
+    for (int i = 0; i < BENCH_SAMPLES; i++)
+    {
+        bench_a[i] = bench_rand_fixed();
+        bench_b[i] = bench_rand_fixed();
+    }
+
+    BENCH_RUN("fixed_mul (split)", fixed_mul(bench_a[i], bench_b[i]));
+    BENCH_RUN("q16_16_mul (native)",
+              fixed_from_q16_16(q16_16_mul(q16_16_from_fixed(bench_a[i]), q16_16_from_fixed(bench_b[i]))));
+    BENCH_RUN("q31_mul",
+              fixed_from_q31(q31_mul((q31_t){bench_a[i].val}, (q31_t){bench_b[i].val})));
+    BENCH_RUN("q15_mul",
+              fixed_from_q15(q15_mul((q15_t){(int16_t)bench_a[i].val}, (q15_t){(int16_t)bench_b[i].val})));
+    BENCH_RUN("q32_32_mul",
+              fixed_from_q32_32(q32_32_mul(q32_32_from_fixed(bench_a[i]), q32_32_from_fixed(bench_b[i]))));
+}
+
+#define BENCH_BLOCK 64
+/// the blocks cycle through the first 2048 samples, which stay in cache
+#define BENCH_ARRAY_SPAN 2048
+
+static fixed_t bench_out[BENCH_SAMPLES];
+
+/**
+ * @brief time `stmt` once per block of BENCH_BLOCK samples, `i` is the
+ *        first sample of the block. prints ns per element.
+ */
+#define BENCH_ARRAY(name, stmt)                                               \
+    do                                                                        \
+    {                                                                         \
+        double start = bench_now_ns();                                        \
+        for (int round = 0; round < BENCH_ROUNDS; round++)                    \
+            for (int blk = 0; blk < BENCH_SAMPLES; blk += BENCH_BLOCK)        \
+            {                                                                 \
+                int i = blk & (BENCH_ARRAY_SPAN - 1);                         \
+                stmt;                                                         \
+            }                                                                 \
+        double ns = (bench_now_ns() - start) / BENCH_ROUNDS / BENCH_SAMPLES; \
+        bench_sink = bench_out[bench_rand() % BENCH_ARRAY_SPAN].val;          \
+        printf("  %-28s %8.3f ns/element\n", name, ns);                      \
+    } while (0)
+
+/// the same loops written with the scalar functions, as the baseline
+static void bench_scalar_mul(fixed_t *dst, const fixed_t *a, const fixed_t *b, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        dst[i] = fixed_mul(a[i], b[i]);
+}
+
+static fixed_t bench_scalar_dot(const fixed_t *a, const fixed_t *b, size_t n)
+{
+    fixed_t sum = FIXED_ZERO;
+    for (size_t i = 0; i < n; i++)
+        sum = fixed_add(sum, fixed_mul(a[i], b[i]));
+    return sum;
+}
+
+static void bench_array(void)
+{
+    for (int i = 0; i < BENCH_SAMPLES; i++)
+    {
+        bench_a[i] = bench_rand_fixed();
+        bench_b[i] = bench_rand_fixed();
+    }
+    // touch the output pages before timing
+    memset(bench_out, 0, sizeof(bench_out));
+
+    printf("  backend: %s, %d elements per call\n", fixed_array_backend(), BENCH_BLOCK);
+    BENCH_ARRAY("fixed_mul loop", bench_scalar_mul(bench_out + i, bench_a + i, bench_b + i, BENCH_BLOCK));
+    BENCH_ARRAY("fixed_add_array", fixed_add_array(bench_out + i, bench_a + i, bench_b + i, BENCH_BLOCK));
+    BENCH_ARRAY("fixed_mul_array", fixed_mul_array(bench_out + i, bench_a + i, bench_b + i, BENCH_BLOCK));
+    BENCH_ARRAY("fixed_scale_array", fixed_scale_array(bench_out + i, bench_a + i, bench_b[0], BENCH_BLOCK));
+    BENCH_ARRAY("fixed_axpy", fixed_axpy(bench_out + i, bench_b[0], bench_a + i, BENCH_BLOCK));
+    BENCH_ARRAY("fixed_mac", fixed_mac(bench_out + i, bench_a + i, bench_b + i, BENCH_BLOCK));
+    BENCH_ARRAY("fixed_mul + fixed_add loop", bench_out[i] = bench_scalar_dot(bench_a + i, bench_b + i, BENCH_BLOCK));
+    BENCH_ARRAY("fixed_dot", bench_out[i] = fixed_dot(bench_a + i, bench_b + i, BENCH_BLOCK));
+}
+
+static void bench_format(void)
+{
+    static char text[BENCH_BLOCK * (FIXED_FTOA_MAX_LEN + 1) + 1];
+    fixed_value_t acc = 0;
+
+    for (int i = 0; i < BENCH_SAMPLES; i++)
+        bench_a[i] = bench_rand_fixed();
+
+    BENCH_ARRAY("snprintf(\"%.6f\")", {
+        int len = 0;
+        for (int j = 0; j < BENCH_BLOCK; j++)
+            len += snprintf(text + len, sizeof(text) - len, "%.6f,", bench_a[i + j].val / 65536.0);
+        bench_out[i].val = len;
+    });
+    BENCH_ARRAY("fixed_format_array", bench_out[i].val = fixed_format_array(text, sizeof(text), bench_a + i, BENCH_BLOCK, ','));
+
+    // parse from different offsets of the last formatted block
+    double start = bench_now_ns();
+    for (int round = 0; round < BENCH_ROUNDS; round++)
+        for (int i = 0; i < BENCH_SAMPLES; i++)
+            acc += fixed_atof(text + (i & (BENCH_BLOCK - 1)) * 4).val;
+    bench_sink = acc;
+    printf("  %-28s %8.3f ns/op\n", "fixed_atof", (bench_now_ns() - start) / BENCH_ROUNDS / BENCH_SAMPLES);
+}
+
+/**
+ * @brief float reference: the same radix-2 DIT with a float twiddle table
+ */
+static void bench_fft_float(float *re, float *im, uint32_t n, const float *wr, const float *wi)
+{
+    for (uint32_t i = 1, j = 0; i < n; i++)
+    {
+        uint32_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j |= bit;
+        if (i < j)
+        {
+            float t = re[i];
+            re[i] = re[j];
+            re[j] = t;
+            t = im[i];
+            im[i] = im[j];
+            im[j] = t;
+        }
+    }
+
+    for (uint32_t m = 1; m < n; m *= 2)
+    {
+        uint32_t stride = FFT_MAX_POINTS / (2 * m);
+        for (uint32_t g = 0; g < n; g += 2 * m)
+            for (uint32_t k = 0; k < m; k++)
+            {
+                uint32_t a = g + k, b = a + m;
+                float tr = re[b] * wr[k * stride] - im[b] * wi[k * stride];
+                float ti = re[b] * wi[k * stride] + im[b] * wr[k * stride];
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+    }
+}
+
+/**
+ * @brief time `stmt` on a fresh copy of the input, per point
+ */
+#define BENCH_FFT(name, n, copy, stmt)                                         \
+    do                                                                         \
+    {                                                                          \
+        int reps = BENCH_SAMPLES / (n);                                        \
+        uint64_t cycles = 0;                                                   \
+        double start = bench_now_ns();                                         \
+        BENCH_TSC(cycles = __rdtsc());                                     \
+        for (int rep = 0; rep < reps; rep++)                                   \
+        {                                                                      \
+            copy;                                                              \
+            stmt;                                                              \
+        }                                                                      \
+        BENCH_TSC(cycles = __rdtsc() - cycles);                            \
+        double points = (double)reps * (n);                                    \
+        printf("  %-20s %5u %8.2f ns/point", name, (unsigned)(n),             \
+               (bench_now_ns() - start) / points);                             \
+        BENCH_TSC(printf(" %8.2f cycles/point", cycles / points));         \
+        printf("\n");                                                          \
+    } while (0)
+
+static void bench_fft(void)
+{
+    static fft_complex_q15_t input[FFT_MAX_POINTS], work[FFT_MAX_POINTS];
+    static float wr[FFT_MAX_POINTS / 2], wi[FFT_MAX_POINTS / 2];
+    static float in_re[FFT_MAX_POINTS], in_im[FFT_MAX_POINTS];
+    static float re[FFT_MAX_POINTS], im[FFT_MAX_POINTS];
+    int32_t exponent;
+    double err = 0, peak = 0;
+
+    for (uint32_t k = 0; k < FFT_MAX_POINTS / 2; k++)
+    {
+        wr[k] = (float)cos(-2 * M_PI * k / FFT_MAX_POINTS);
+        wi[k] = (float)sin(-2 * M_PI * k / FFT_MAX_POINTS);
+    }
+    for (uint32_t i = 0; i < FFT_MAX_POINTS; i++)
+    {
+        input[i].re = (int16_t)(bench_rand() >> 17);
+        input[i].im = (int16_t)(bench_rand() >> 17);
+        in_re[i] = input[i].re;
+        in_im[i] = input[i].im;
+    }
+
+    for (uint32_t n = 64; n <= FFT_MAX_POINTS; n *= 4)
+    {
+        size_t bytes = n * sizeof(fft_complex_q15_t);
+        BENCH_FFT("fft_q15", n, memcpy(work, input, bytes), fft_q15(work, n, &exponent));
+        BENCH_FFT("fft_rfft_q15", n, memcpy(work, input, bytes), fft_rfft_q15((int16_t *)work, n, &exponent));
+        BENCH_FFT("float radix-2", n,
+                  (memcpy(re, in_re, n * sizeof(float)), memcpy(im, in_im, n * sizeof(float))),
+                  bench_fft_float(re, im, n, wr, wi));
+    }
+
+    // error of the largest size against the float result
+    memcpy(work, input, sizeof(input));
+    memcpy(re, in_re, sizeof(re));
+    memcpy(im, in_im, sizeof(im));
+    fft_q15(work, FFT_MAX_POINTS, &exponent);
+    bench_fft_float(re, im, FFT_MAX_POINTS, wr, wi);
+    for (uint32_t k = 0; k < FFT_MAX_POINTS; k++)
+    {
+        double e = hypot(ldexp(work[k].re, exponent) - re[k], ldexp(work[k].im, exponent) - im[k]);
+        err = e > err ? e : err;
+        peak = hypot(re[k], im[k]) > peak ? hypot(re[k], im[k]) : peak;
+    }
+    printf("  fft_q15 %u max error %.1f dB of the peak bin\n", FFT_MAX_POINTS, 20 * log10(err / peak));
+}
+
+#define BENCH_FIR_TAPS 32
+
+/// sample by sample FIR with fixed_mul, what callers wrote by hand
+static void bench_fir_naive(const fixed_t *h, fixed_t *history, const fixed_t *in, fixed_t *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        fixed_t acc = {0};
+        memmove(history + 1, history, (BENCH_FIR_TAPS - 1) * sizeof(fixed_t));
+        history[0] = in[i];
+        for (int k = 0; k < BENCH_FIR_TAPS; k++)
+            acc = fixed_add(acc, fixed_mul(h[k], history[k]));
+        out[i] = acc;
+    }
+}
+
+static void bench_filter(void)
+{
+    static const filter_biquad_coeffs_t lowpass[2] = {
+        {23497607, 46995214, 23497607, -1826396544, 846645149},
+        {20440642, 40881285, 20440642, -1588788093, 596808838},
+    };
+    static fixed_t h[BENCH_FIR_TAPS], fir_state[2 * BENCH_FIR_TAPS], history[BENCH_FIR_TAPS];
+    static int16_t h_q15[BENCH_FIR_TAPS], fir_q15_state[2 * BENCH_FIR_TAPS];
+    static int16_t in_q15[BENCH_ARRAY_SPAN + BENCH_BLOCK], out_q15[BENCH_ARRAY_SPAN + BENCH_BLOCK];
+    filter_biquad_df1_state_t df1_state[2];
+    filter_biquad_df2t_state_t df2t_state[2];
+    filter_fir_t fir;
+    filter_fir_q15_t fir_q15;
+    filter_biquad_df1_t df1;
+    filter_biquad_df2t_t df2t;
+
+    for (int k = 0; k < BENCH_FIR_TAPS; k++)
+    {
+        h[k].val = (fixed_value_t)(bench_rand() % 4096);
+        h_q15[k] = (int16_t)(bench_rand() % 2048);
+    }
+    for (int i = 0; i < BENCH_ARRAY_SPAN + BENCH_BLOCK; i++)
+    {
+        bench_a[i].val = (fixed_value_t)bench_rand() >> 8;
+        in_q15[i] = (int16_t)bench_rand();
+    }
+
+    filter_fir_init(&fir, h, fir_state, BENCH_FIR_TAPS);
+    filter_fir_q15_init(&fir_q15, h_q15, fir_q15_state, BENCH_FIR_TAPS);
+    filter_biquad_df1_init(&df1, lowpass, df1_state, 2);
+    filter_biquad_df2t_init(&df2t, lowpass, df2t_state, 2);
+
+    printf("  %d taps FIR, 4th order biquad cascade, ns per sample\n", BENCH_FIR_TAPS);
+    BENCH_ARRAY("fixed_mul loop FIR", bench_fir_naive(h, history, bench_a + i, bench_out + i, BENCH_BLOCK));
+    BENCH_ARRAY("filter_fir_block", filter_fir_block(&fir, bench_a + i, bench_out + i, BENCH_BLOCK));
+    BENCH_ARRAY("filter_fir_q15_block", filter_fir_q15_block(&fir_q15, in_q15 + i, out_q15 + i, BENCH_BLOCK));
+    BENCH_ARRAY("filter_biquad_df1_block", filter_biquad_df1_block(&df1, bench_a + i, bench_out + i, BENCH_BLOCK));
+    BENCH_ARRAY("filter_biquad_df2t_block", filter_biquad_df2t_block(&df2t, bench_a + i, bench_out + i, BENCH_BLOCK));
+    bench_sink = out_q15[bench_rand() % BENCH_ARRAY_SPAN];
+}
+
+#define BENCH_MOTOR_POLE_PAIRS 50
+#define BENCH_MOTOR_STEPS 4096
+
+/// the angle and rotation of the old examples/pid_42_foc.c, per transform
+static void bench_foc_example(int32_t position, fixed_t ia, fixed_t ib, fixed_t *da, fixed_t *db)
+{
+    fixed_t angle = fixed_from_int(position % BENCH_MOTOR_STEPS);
+    angle = fixed_mul(angle, fixed_from_int(BENCH_MOTOR_POLE_PAIRS));
+    angle = fixed_mul(angle, FIXED_2PI);
+    angle = fixed_div(angle, fixed_from_int(BENCH_MOTOR_STEPS));
+    angle.val = -angle.val;
+
+    fixed_t s, c;
+    fixed_sincos(angle, &s, &c);
+    fixed_t id = fixed_sub(fixed_mul(ia, c), fixed_mul(ib, s));
+    fixed_t iq = fixed_add(fixed_mul(ia, s), fixed_mul(ib, c));
+
+    // the inverse transform computed the angle again
+    angle = fixed_from_int(position % BENCH_MOTOR_STEPS);
+    angle = fixed_mul(angle, fixed_from_int(BENCH_MOTOR_POLE_PAIRS));
+    angle = fixed_mul(angle, FIXED_2PI);
+    angle = fixed_div(angle, fixed_from_int(BENCH_MOTOR_STEPS));
+    fixed_sincos(angle, &s, &c);
+    *da = fixed_sub(fixed_mul(id, c), fixed_mul(iq, s));
+    *db = fixed_add(fixed_mul(id, s), fixed_mul(iq, c));
+}
+
+/// one current loop step with foc.h, Clarke to SVPWM
+static foc_abc_t bench_foc_cycle(const angle_encoder_t *enc, int32_t position, fixed_t ia, fixed_t ib)
+{
+    foc_sincos_t sc = foc_sincos_angle(angle_encoder_electrical(enc, position));
+    foc_dq_t i = foc_park(foc_clarke(ia, ib), sc);
+    // a P controller stands in for the PI loops
+    foc_dq_t v = {{-i.d.val >> 4}, {(FIXED_ONE.val >> 3) - (i.q.val >> 4)}};
+    return foc_svpwm(foc_inverse_park(v, sc));
+}
+
+/**
+ * @brief time the statement over all samples, it handles `per` samples
+ *        from `i` on. prints ns and cycles per sample.
+ */
+#define BENCH_CYCLES(name, per, ...)                                          \
+    do                                                                        \
+    {                                                                         \
+        uint64_t cycles = 0;                                                  \
+        int ops = 0;                                                          \
+        double start = bench_now_ns();                                        \
+        BENCH_TSC(cycles = __rdtsc());                                        \
+        for (int i = 0; i + (per) <= BENCH_SAMPLES; i += (per), ops += (per)) \
+            __VA_ARGS__;                                                      \
+        BENCH_TSC(cycles = __rdtsc() - cycles);                               \
+        printf("  %-28s %8.2f ns/op", name, (bench_now_ns() - start) / ops); \
+        BENCH_TSC(printf(" %8.1f cycles/op", (double)cycles / ops));         \
+        printf("\n");                                                         \
+    } while (0)
+
+static void bench_foc(void)
+{
+    static int32_t position[BENCH_SAMPLES];
+    fixed_value_t acc = 0;
+    angle_encoder_t enc;
+    // a resolution that is not a power of two
+    angle_encoder_init(&enc, BENCH_MOTOR_STEPS - 96, BENCH_MOTOR_POLE_PAIRS);
+
+    for (int i = 0; i < BENCH_SAMPLES; i++)
+    {
+        position[i] = (int32_t)(bench_rand() % BENCH_MOTOR_STEPS);
+        bench_a[i].val = (fixed_value_t)bench_rand() >> 12;
+        bench_b[i].val = (fixed_value_t)bench_rand() >> 12;
+    }
+
+    BENCH_CYCLES("example Park + inverse", 1, {
+        fixed_t da, db;
+        bench_foc_example(position[i], bench_a[i], bench_b[i], &da, &db);
+        acc += da.val + db.val;
+    });
+    BENCH_CYCLES("angle, fixed_mul / fixed_div", 1, {
+        fixed_t a = fixed_mul(fixed_from_int(position[i]), fixed_from_int(BENCH_MOTOR_POLE_PAIRS));
+        acc += fixed_div(fixed_mul(a, FIXED_2PI), fixed_from_int(BENCH_MOTOR_STEPS)).val;
+    });
+    BENCH_CYCLES("angle_encoder_electrical", 1, acc += (fixed_value_t)angle_encoder_electrical(&enc, position[i]));
+    BENCH_CYCLES("fixed_sincos", 1, {
+        fixed_t s, c;
+        fixed_sincos(bench_a[i], &s, &c);
+        acc += s.val + c.val;
+    });
+    BENCH_CYCLES("fixed_sincos_bam", 1, {
+        fixed_t s, c;
+        fixed_sincos_bam((uint32_t)bench_a[i].val << 12, &s, &c);
+        acc += s.val + c.val;
+    });
+    BENCH_CYCLES("foc_park + foc_inverse_park", 1, {
+        foc_sincos_t sc = {bench_a[i], bench_b[i]};
+        foc_ab_t v = foc_inverse_park(foc_park((foc_ab_t){bench_b[i], bench_a[i]}, sc), sc);
+        acc += v.alpha.val + v.beta.val;
+    });
+    BENCH_CYCLES("foc_svpwm", 1, {
+        foc_abc_t d = foc_svpwm((foc_ab_t){{bench_a[i].val >> 4}, {bench_b[i].val >> 4}});
+        acc += d.a.val + d.b.val + d.c.val;
+    });
+    BENCH_CYCLES("angle to svpwm, one cycle", 1, {
+        foc_abc_t d = bench_foc_cycle(&enc, position[i], bench_a[i], bench_b[i]);
+        acc += d.a.val + d.b.val + d.c.val;
+    });
+    bench_sink = acc;
+}
+
+#define BENCH_PID_ZONES 48
+
+static void bench_pid_callback(pid_state_t *pstate, fixed_t output)
+{
+    (void)pstate;
+    bench_sink = output.val;
+}
+
+static void bench_pid_bank_callback(pid_bank_t *bank, const fixed_t *output, uint32_t count)
+{
+    (void)bank;
+    bench_sink = output[count - 1].val;
+}
+
+static fixed_t bench_cascade_measure(pid_cascade_stage_t *stage)
+{
+    return bench_a[(uintptr_t)stage->user++ & (BENCH_SAMPLES - 1)];
+}
+
+#ifdef BENCH_HAS_TSC
+static uint32_t bench_cascade_clock(void)
+{
+    return (uint32_t)__rdtsc();
+}
+#else
+#define bench_cascade_clock NULL
+#endif
+
+static void bench_pid(void)
+{
+    static pid_state_t zones[BENCH_PID_ZONES];
+    static pid_incr_t incr[BENCH_PID_ZONES];
+    static fixed_t storage[PID_BANK_STORAGE_WORDS(BENCH_PID_ZONES)];
+    pid_bank_t bank;
+
+    pid_bank_init(&bank, storage, BENCH_PID_ZONES);
+    for (int k = 0; k < BENCH_PID_ZONES; k++)
+    {
+        fixed_t kp = {(fixed_value_t)(bench_rand() % 0x40000)}, ki = {(fixed_value_t)(bench_rand() % 0x1000)};
+        fixed_t kd = {(fixed_value_t)(bench_rand() % 0x20000)};
+        pid_init_controller(kp, ki, kd, &zones[k]);
+        pid_bank_set_gains(&bank, k, kp, ki, kd);
+        pid_incr_init(&incr[k], kp, ki, kd, 10000, 1000, fixed_from_int(-100), fixed_from_int(100));
+    }
+    for (int i = 0; i < BENCH_SAMPLES; i++)
+        bench_a[i].val = (fixed_value_t)bench_rand() >> 12;
+
+    // one op is one controller, a statement updates all zones
+    BENCH_CYCLES("pid_update_controller", BENCH_PID_ZONES, {
+        for (int k = 0; k < BENCH_PID_ZONES; k++)
+            pid_update_controller(&zones[k], bench_a[i + k]);
+    });
+    for (int k = 0; k < BENCH_PID_ZONES; k++)
+        zones[k].callback = bench_pid_callback;
+    BENCH_CYCLES("  + callback", BENCH_PID_ZONES, {
+        for (int k = 0; k < BENCH_PID_ZONES; k++)
+            pid_update_controller(&zones[k], bench_a[i + k]);
+    });
+    BENCH_CYCLES("pid_incr_update", BENCH_PID_ZONES, {
+        for (int k = 0; k < BENCH_PID_ZONES; k++)
+            pid_incr_update(&incr[k], bench_a[i + k]);
+    });
+    BENCH_CYCLES("pid_bank_update", BENCH_PID_ZONES, pid_bank_update(&bank, bench_a + i));
+    pid_bank_set_callback(&bank, bench_pid_bank_callback);
+    BENCH_CYCLES("  + callback", BENCH_PID_ZONES, pid_bank_update(&bank, bench_a + i));
+
+    // position / velocity / current at 1 / 5 / 20 kHz, one op is one tick
+    pid_cascade_stage_t stages[3];
+    pid_cascade_t cascade;
+    for (int k = 0; k < 3; k++)
+    {
+        zones[k].callback = NULL;
+        pid_cascade_stage_init(&stages[k], &zones[k], bench_cascade_measure, k == 0 ? 20 : k == 1 ? 4 : 1, 0);
+    }
+    pid_cascade_init(&cascade, stages, 3, NULL);
+    BENCH_CYCLES("pid_cascade_tick", 1, pid_cascade_tick(&cascade));
+    pid_cascade_init(&cascade, stages, 3, bench_cascade_clock);
+    BENCH_CYCLES("  + timing", 1, pid_cascade_tick(&cascade));
+    bench_sink = zones[0].output.val + incr[0].output.val + bank.output[0].val;
+}
+
+static uint32_t bench_random_out[BENCH_SAMPLES];
+
+/**
+ * @brief chi-square of 256 buckets of bits `shift` to `shift` + 7 of the
+ *        numbers in bench_random_out, 255 +- 22.6 for uniform numbers.
+ *        every generator here has at least 31 bits.
+ */
+static double bench_random_chi2(int shift)
+{
+    uint32_t count[256] = {0};
+    for (int i = 0; i < BENCH_SAMPLES; i++)
+        count[(bench_random_out[i] >> shift) & 0xff]++;
+
+    double chi2 = 0, expect = BENCH_SAMPLES / 256.0;
+    for (int b = 0; b < 256; b++)
+        chi2 += (count[b] - expect) * (count[b] - expect) / expect;
+    return chi2;
+}
+
+#define BENCH_RANDOM_FILL_BLOCK 1024
+
+/**
+ * @brief time `next` for one number per op, then the chi-square of the
+ *        low byte and of bits 23 - 30 of the numbers.
+ */
+#define BENCH_RANDOM(name, next)                                                                    \
+    do                                                                                              \
+    {                                                                                               \
+        BENCH_CYCLES(name, 1, bench_random_out[i] = (uint32_t)(next));                              \
+        printf("  %-28s chi2 %6.1f / %6.1f\n", "", bench_random_chi2(0), bench_random_chi2(23)); \
+    } while (0)
+
+/**
+ * @brief rand_lcg_next() with the 64bit modulo it had before the
+ *        Mersenne reduction
+ */
+static uint32_t bench_lcg_modulo(rand_lcg_t *lcg)
+{
+    uint64_t product = (uint64_t)lcg->multiplier * lcg->seed;
+    uint32_t result = (product + lcg->increment) % lcg->modulus;
+    lcg->seed = result;
+    return result;
+}
+
+static void bench_random(void)
+{
+    rand_lcg_t lcg = LCG_DEFAULT_INIT(12345678);
+    rand_xorshift128p_t xorshift;
+    rand_xoshiro256ss_t xoshiro;
+    rand_pcg32_t pcg;
+    rand_fill_t fill;
+
+    rand_xorshift128p_seed(&xorshift, 12345678);
+    rand_xoshiro256ss_seed(&xoshiro, 12345678);
+    rand_pcg32_seed(&pcg, 12345678, 0);
+    rand_fill_seed(&fill, 12345678);
+
+    BENCH_RANDOM("rand_lcg_next, % modulus", bench_lcg_modulo(&lcg));
+    BENCH_RANDOM("rand_lcg_next", rand_lcg_next(&lcg));
+    BENCH_CYCLES("rand_lcg_skip, 2^31 - 2", 1, rand_lcg_skip(&lcg, RAND_MINSTD_MODULUS - 1));
+    BENCH_RANDOM("rand_xorshift128p_next >> 32", rand_xorshift128p_next(&xorshift) >> 32);
+    BENCH_RANDOM("rand_xoshiro256ss_next", rand_xoshiro256ss_next(&xoshiro));
+    BENCH_RANDOM("rand_pcg32_next", rand_pcg32_next(&pcg));
+    BENCH_CYCLES("rand_fill_u32", BENCH_RANDOM_FILL_BLOCK,
+                 rand_fill_u32(&fill, bench_random_out + i, BENCH_RANDOM_FILL_BLOCK));
+    printf("  %-28s chi2 %6.1f / %6.1f\n", "", bench_random_chi2(0), bench_random_chi2(23));
+
+    // fixed_t distributions, against going through float
+    fixed_t lo = fixed_from_int(-1), hi = fixed_from_int(1), lsb = {FIXED_ONE.val >> 8};
+    BENCH_CYCLES("uniform via float", 1,
+                 bench_a[i] = fixed_from_float(rand_lcg_next(&lcg) * (2.0f / RAND_MINSTD_MODULUS) - 1.0f));
+    BENCH_CYCLES("rand_uniform_fixed", 1, bench_a[i] = rand_uniform_fixed(&xoshiro, lo, hi));
+    BENCH_CYCLES("rand_uniform_fixed_fill", BENCH_RANDOM_FILL_BLOCK,
+                 rand_uniform_fixed_fill(&xoshiro, bench_a + i, BENCH_RANDOM_FILL_BLOCK, lo, hi));
+    BENCH_CYCLES("normal via float Box-Muller", 2, {
+        float r = sqrtf(-2.0f * logf((rand_lcg_next(&lcg) + 1.0f) / RAND_MINSTD_MODULUS));
+        float t = rand_lcg_next(&lcg) * (6.2831853f / RAND_MINSTD_MODULUS);
+        bench_a[i] = fixed_from_float(r * cosf(t));
+        bench_a[i + 1] = fixed_from_float(r * sinf(t));
+    });
+    BENCH_CYCLES("rand_normal_fixed", 1, bench_a[i] = rand_normal_fixed(&xoshiro, FIXED_ZERO, FIXED_ONE));
+    BENCH_CYCLES("rand_normal_fixed_fill", BENCH_RANDOM_FILL_BLOCK,
+                 rand_normal_fixed_fill(&xoshiro, bench_a + i, BENCH_RANDOM_FILL_BLOCK, FIXED_ZERO, FIXED_ONE));
+    BENCH_CYCLES("rand_triangular_fixed", 1, bench_a[i] = rand_triangular_fixed(&xoshiro, lsb));
+    BENCH_CYCLES("rand_triangular_fixed_fill", BENCH_RANDOM_FILL_BLOCK,
+                 rand_triangular_fixed_fill(&xoshiro, bench_a + i, BENCH_RANDOM_FILL_BLOCK, lsb));
+}
+
+#define BENCH_MODBUS_FRAMES 4096
+
+static error_t bench_modbus_read(uint32_t offset, uint32_t size, uint8_t *data, uint8_t *error_code_out)
+{
+    (void)error_code_out;
+    for (uint32_t i = 0; i < size; i++)
+    {
+        data[2 * i] = 0;
+        data[2 * i + 1] = offset + i;
+    }
+    return ALL_OK;
+}
+
+/// "sent within the callback", the slave keeps no transmit state
+static error_t bench_modbus_transmit(uint32_t size, const void *pdata)
+{
+    bench_sink = ((const uint8_t *)pdata)[size - 1];
+    return 1;
+}
+
+static uint16_t bench_modbus_crc(const uint8_t *data, uint32_t size)
+{
+    uint16_t crc = 0xFFFF;
+    for (uint32_t i = 0; i < size; i++)
+    {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++)
+            crc = crc & 1 ? (crc >> 1) ^ 0xA001 : crc >> 1;
+    }
+    return crc;
+}
+
+static void bench_modbus(void)
+{
+    static modbus_reg_desc_t regs[4096];
+    static uint8_t frames[BENCH_MODBUS_FRAMES][8];
+    static const uint32_t sizes[] = {8, 256, 4096};
+    char name[64];
+
+    // one op is a 0x03 read of 8 registers, byte by byte as from the UART
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        // ranges of 4 registers with a gap of 1, the reads stay in 2 ranges
+        for (uint32_t r = 0; r < sizes[s]; r++)
+            regs[r] = (modbus_reg_desc_t){.reg_start_addr = r * 5, .reg_map_len = 4, .read_handler = bench_modbus_read};
+        for (int f = 0; f < BENCH_MODBUS_FRAMES; f++)
+        {
+            uint32_t addr = bench_rand() % sizes[s] * 5;
+            uint8_t *frame = frames[f];
+            frame[0] = 1;
+            frame[1] = MODBUS_FN_READ_HOLDING_REGISTERS;
+            frame[2] = addr >> 8;
+            frame[3] = addr & 0xFF;
+            frame[4] = 0;
+            frame[5] = 4;
+            uint16_t crc = bench_modbus_crc(frame, 6);
+            frame[6] = crc & 0xFF;
+            frame[7] = crc >> 8;
+        }
+
+        modbus_slave_init_t desc = {.holding_regs = regs, .holding_reg_cnt = sizes[s],
+                                    .request_pdu_transmit = bench_modbus_transmit};
+        modbus_slave_t slave;
+        modbus_slave_init(&slave, &desc, 1);
+
+        snprintf(name, sizeof(name), "0x03, %u ranges", sizes[s]);
+        BENCH_CYCLES(name, 1, {
+            const uint8_t *frame = frames[i & (BENCH_MODBUS_FRAMES - 1)];
+            for (int b = 0; b < 8; b++)
+                modbus_slave_recv_handler(&slave, frame[b], MODBUS_RECV_DATA);
+            modbus_slave_recv_handler(&slave, 0, MODBUS_RECV_END);
+        });
+
+        // the same frames as one DMA buffer at the idle line
+        snprintf(name, sizeof(name), "0x03, %u ranges, whole frame", sizes[s]);
+        BENCH_CYCLES(name, 1, { modbus_slave_recv_frame(&slave, frames[i & (BENCH_MODBUS_FRAMES - 1)], 8); });
+    }
+}
+
+typedef struct
+{
+    const char *name;
+    void (*run)(void);
+} bench_section_t;
+
+static const bench_section_t bench_sections[] = {
+    {"div", bench_div},
+    {"sqrt", bench_sqrt},
+    {"trig", bench_trig},
+    {"qformat", bench_qformat},
+    {"array", bench_array},
+    {"format", bench_format},
+    {"fft", bench_fft},
+    {"filter", bench_filter},
+    {"foc", bench_foc},
+    {"pid", bench_pid},
+    {"random", bench_random},
+    {"modbus", bench_modbus},
+};
+
+int main(int argc, char **argv)
+{
+    for (size_t s = 0; s < sizeof(bench_sections) / sizeof(bench_sections[0]); s++)
+    {
+        int selected = argc < 2;
+        for (int arg = 1; arg < argc; arg++)
+            selected |= strcmp(argv[arg], bench_sections[s].name) == 0;
+        if (!selected)
+            continue;
+
+        printf("[%s]\n", bench_sections[s].name);
+        bench_sections[s].run();
+    }
+    return 0;
+}
@@ -12,16 +12,131 @@
 #include <stdint.h>
 
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
+#include <time.h>
+
+#include <fpa_sin_lut.h>
+
+/**
+ * the generated header follows the trig backend selected in Kconfig,
+ * but this tool can still be built without a configured tree.
+ */
+#if defined(__has_include)
+#if __has_include(<generated-conf.h>)
+#include <generated-conf.h>
+#endif
+#endif
+
+#ifndef CONFIG_FPA_TRIG_LUT_BITS
+#define CONFIG_FPA_TRIG_LUT_BITS 8
+#endif
+
+#if defined(CONFIG_FPA_TRIG_LUT_Q15)
+#define LUT_Q 15
+#else
+#define LUT_Q 30
+#endif
 
 #define PI 3.1415926535897932384626433832795l
 const double pf_off = 65536;
 
 #define depth 16
-int main()
+
+/// iterations and format of the vectoring and hyperbolic kernels
+#define vector_depth 24
+#define hyper_depth 24
+const double q29_off = 536870912;
+
+/// log2 of the entry count of the reciprocal seed table
+#define recip_seed_bits 5
+
+/// log2 of the interval count of the reciprocal square root seed table
+#define rsqrt_seed_bits 5
+
+/**
+ * @brief hyperbolic CORDIC only converges if these steps are repeated,
+ *        the sequence is 4, 13, 40, ... (k' = 3k + 1)
+ */
+static int hyper_repeat(int i)
+{
+    return i == 4 || i == 13;
+}
+
+/**
+ * @brief value of the quarter-wave sine table entry `k`
+ * @note entry 0 and the last entry are guard points out of [0, pi/2],
+ *       so interpolation never needs to check the table bounds.
+ */
+static int32_t lut_entry(int bits, int q, int k)
+{
+    double step = PI / 2 / (1 << bits);
+    double v = round(sin((k - 1) * step) * ((int64_t)1 << q));
+    double max = (double)(((int64_t)1 << (q == 15 ? 15 : 31)) - 1);
+    return v > max ? (int32_t)max : (int32_t)v;
+}
+
+/**
+ * @brief print the max error and the host time per call of every table
+ *        configuration, run `cordic --report` to see the trade-off before
+ *        picking the table size in menuconfig. the lookup is the one of
+ *        src/math/fpa.c, only the layout is passed at runtime here, so
+ *        compare the times between rows rather than with the target.
+ */
+static int lut_report(void)
+{
+    static int32_t lut32[(1 << 12) + 3];
+    static int16_t lut16[(1 << 12) + 3];
+    const uint32_t samples = 1u << 22;
+    const uint32_t step = (uint32_t)(0x100000000ull / samples) + 1;
+    volatile int32_t sink = 0;
+
+    printf("bits entries  q  interp     bytes  max_err(lsb)  ns/call\n");
+    for (int bits = 4; bits <= 12; bits++)
+        for (int q = 15; q <= 30; q += 15)
+            for (int quadratic = 0; quadratic < 2; quadratic++)
+            {
+                const void *lut = q == 15 ? (const void *)lut16 : (const void *)lut32;
+                for (int k = 0; k < (1 << bits) + 3; k++)
+                {
+                    lut32[k] = lut_entry(bits, q, k);
+                    lut16[k] = (int16_t)lut32[k];
+                }
+
+                double max_err = 0;
+                uint32_t phase = 0;
+                for (uint32_t i = 0; i < samples; i++, phase += step)
+                {
+                    double ref = sin(phase * (2 * PI / 4294967296.0)) * 65536.0;
+                    double err = fabs(fpa_sin_lut_lookup(lut, bits, q, quadratic, phase) - ref);
+                    if (err > max_err)
+                        max_err = err;
+                }
+
+                int32_t acc = 0;
+                phase = 0;
+                clock_t start = clock();
+                for (uint32_t i = 0; i < samples; i++, phase += step)
+                    acc += fpa_sin_lut_lookup(lut, bits, q, quadratic, phase);
+                double ns = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / samples;
+                sink = acc;
+
+                printf("%4d %7d %2d  %-9s %6d  %12.2f  %7.2f\n",
+                       bits, (1 << bits) + 3, q, quadratic ? "quadratic" : "linear",
+                       ((1 << bits) + 3) * (q == 15 ? 2 : 4), max_err, ns);
+            }
+
+    (void)sink;
+    return 0;
+}
+
+int main(int argc, char **argv)
 {
     int i = 0;
 
+    if (argc > 1 && strcmp(argv[1], "--report") == 0)
+        return lut_report();
+
     double gain = 1.0;
 
     // fprintf(stderr, "  2^-i     angle     factor     gain\n");
@@ -52,10 +167,11 @@ int main()
 
         gain *= scaling_factor;
 
-        uint32_t di_fp = di * pf_off;
-        uint32_t angle_fp = angle * pf_off;
-        uint32_t sf_fp = scaling_factor * pf_off;
-        uint32_t ga_fp = (1.0 / gain) * pf_off;
+        // round to nearest, truncation errors would pile up along the rotation
+        uint32_t di_fp = di * pf_off + 0.5;
+        uint32_t angle_fp = angle * pf_off + 0.5;
+        uint32_t sf_fp = scaling_factor * pf_off + 0.5;
+        uint32_t ga_fp = (1.0 / gain) * pf_off + 0.5;
 
         cordic_value[i] = di_fp;
         cordic_angle[i] = angle_fp;
@@ -84,4 +200,97 @@ int main()
         printf("    (fixed_t){0x%08Xu},\n", cordic_gain[i]);
 
     printf("};\n\n");
+
+    // vectoring mode, atan(2^-i) in Q29 and 1 / gain in Q32
+    double vector_gain = 1.0;
+    printf(
+        "#define CORDIC_VECTOR_DEPTH %d\n"
+        "\n"
+        "static const int32_t cordic_atan_q29[] = {\n",
+        vector_depth);
+
+    for (int i = 0; i < vector_depth; i++)
+    {
+        double di = pow(2.0, -i);
+        vector_gain *= sqrt(1 + di * di);
+        printf("    0x%08X,\n", (uint32_t)(atan(di) * q29_off + 0.5));
+    }
+
+    printf("};\n\n");
+
+    printf("static const uint32_t cordic_vector_gain_q32 = 0x%08Xu;\n\n",
+           (uint32_t)(1.0 / vector_gain * 4294967296.0 + 0.5));
+
+    // hyperbolic mode, atanh(2^-i) starts from i = 1
+    double hyper_gain = 1.0;
+    printf("#define CORDIC_HYPER_DEPTH %d\n", hyper_depth);
+
+    // the kernel repeats the same steps the gain below is computed with
+    printf("#define CORDIC_HYPER_REPEAT(i) (0");
+    for (int i = 1; i <= hyper_depth; i++)
+        if (hyper_repeat(i))
+            printf(" || (i) == %d", i);
+    printf(")\n"
+           "\n"
+           "static const int32_t cordic_atanh_q29[] = {\n");
+
+    for (int i = 1; i <= hyper_depth; i++)
+    {
+        double di = pow(2.0, -i);
+        double scaling_factor = sqrt(1 - di * di);
+        hyper_gain *= scaling_factor;
+        if (hyper_repeat(i))
+            hyper_gain *= scaling_factor;
+        printf("    0x%08X,\n", (uint32_t)(atanh(di) * q29_off + 0.5));
+    }
+
+    printf("};\n\n");
+
+    printf("static const int32_t cordic_hyper_gain_q29 = 0x%08X;\n\n",
+           (uint32_t)(1.0 / hyper_gain * q29_off + 0.5));
+
+    // seed of 1 / d for d in [0.5, 1), taken at the middle of each interval
+    printf(
+        "#define FPA_RECIP_SEED_BITS %d\n"
+        "\n"
+        "static const uint16_t fpa_recip_seed[] = {\n",
+        recip_seed_bits);
+
+    for (int i = 0; i < (1 << recip_seed_bits); i++)
+    {
+        double d = 0.5 + (i + 0.5) / (2 << recip_seed_bits);
+        printf("    0x%04X,\n", (uint32_t)(1.0 / d * 32768 + 0.5));
+    }
+
+    printf("};\n\n");
+
+    // seed of 1 / sqrt(m) for m in [0.25, 1), taken at the middle of each interval
+    printf(
+        "#define FPA_RSQRT_SEED_BITS %d\n"
+        "\n"
+        "static const uint16_t fpa_rsqrt_seed[] = {\n",
+        rsqrt_seed_bits);
+
+    for (int i = (1 << rsqrt_seed_bits) / 4; i < (1 << rsqrt_seed_bits); i++)
+    {
+        double m = (i + 0.5) / (1 << rsqrt_seed_bits);
+        printf("    0x%04X,\n", (uint32_t)(1.0 / sqrt(m) * 32768 + 0.5));
+    }
+
+    printf("};\n\n");
+
+#ifdef CONFIG_FPA_TRIG_LUT
+    int lut_size = (1 << CONFIG_FPA_TRIG_LUT_BITS) + 3;
+    printf(
+        "#define FPA_SIN_LUT_BITS %d\n"
+        "#define FPA_SIN_LUT_Q %d\n"
+        "\n"
+        "static const %s fpa_sin_lut[] = {\n",
+        CONFIG_FPA_TRIG_LUT_BITS, LUT_Q, LUT_Q == 15 ? "int16_t" : "int32_t");
+
+    for (int k = 0; k < lut_size; k++)
+        printf("    %d,\n", lut_entry(CONFIG_FPA_TRIG_LUT_BITS, LUT_Q, k));
+
+    printf("};\n\n");
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,261 @@
+/**
+ * @file filter_design.c
+ * @author simakeng (simakeng@outlook.com)
+ * @brief This tool prints filter coefficients in the types of filter.h
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *  filter_design <type> <fs> <fc> [-o order] [-q Q] [-t taps] [-n name]
+ *
+ *  lowpass, highpass   Butterworth of `-o` order (default 2) as a
+ *                      cascade of biquads
+ *  bandpass, notch     one biquad centered on fc, `-q` (default 0.707)
+ *  fir-lowpass,        windowed sinc (Hamming) of `-t` taps (default
+ *  fir-highpass        31, odd for highpass), printed as fixed_t and Q15
+ *
+ * the response of the quantized coefficients at a few frequencies is
+ * printed as a comment, to check that the rounding did not move it.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <complex.h>
+#include <math.h>
+
+#define PI 3.14159265358979323846
+
+/// same as filter.h, the tool does not depend on the library headers
+#define BIQUAD_FRAC 30
+#define FIXED_WIDTH 16
+
+#define MAX_SECTIONS 8
+#define MAX_TAPS 1024
+
+typedef struct
+{
+    double b0, b1, b2, a1, a2;
+} biquad_t;
+
+static int32_t to_q30(double v)
+{
+    double r = round(v * (1 << BIQUAD_FRAC));
+    if (r >= 2147483648.0 || r < -2147483648.0)
+    {
+        fprintf(stderr, "coefficient %f is out of the Q2.30 range [-2, 2)\n", v);
+        exit(1);
+    }
+    return (int32_t)r;
+}
+
+static int16_t to_q15(double v)
+{
+    double r = round(v * 32768);
+    if (r > 32767 || r < -32768)
+        fprintf(stderr, "warning: coefficient %f clipped to Q15\n", v);
+    return (int16_t)(r > 32767 ? 32767 : r < -32768 ? -32768 : r);
+}
+
+/**
+ * @brief RBJ cookbook second order section, normalized to a0 = 1
+ */
+static biquad_t biquad_rbj(const char *type, double w0, double q)
+{
+    double c = cos(w0), alpha = sin(w0) / (2 * q);
+    double b0, b1, b2, a0 = 1 + alpha, a1 = -2 * c, a2 = 1 - alpha;
+
+    if (strcmp(type, "lowpass") == 0)
+        b0 = (1 - c) / 2, b1 = 1 - c, b2 = (1 - c) / 2;
+    else if (strcmp(type, "highpass") == 0)
+        b0 = (1 + c) / 2, b1 = -(1 + c), b2 = (1 + c) / 2;
+    else if (strcmp(type, "bandpass") == 0) // 0 dB peak gain
+        b0 = alpha, b1 = 0, b2 = -alpha;
+    else // notch
+        b0 = 1, b1 = -2 * c, b2 = 1;
+
+    return (biquad_t){b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0};
+}
+
+/// first order section by the bilinear transform, for odd orders
+static biquad_t biquad_first_order(const char *type, double w0)
+{
+    double k = tan(w0 / 2);
+    double a1 = (k - 1) / (k + 1);
+    if (strcmp(type, "lowpass") == 0)
+        return (biquad_t){k / (k + 1), k / (k + 1), 0, a1, 0};
+    return (biquad_t){1 / (k + 1), -1 / (k + 1), 0, a1, 0};
+}
+
+/// |H(e^jw)| of the quantized cascade
+static double biquad_response(const int32_t (*q)[5], int sections, double w)
+{
+    double complex z1 = cexp(-I * w), z2 = z1 * z1, h = 1;
+    for (int s = 0; s < sections; s++)
+    {
+        double scale = 1.0 / (1 << BIQUAD_FRAC);
+        h *= (q[s][0] + q[s][1] * z1 + q[s][2] * z2) * scale / (1 + q[s][3] * scale * z1 + q[s][4] * scale * z2);
+    }
+    return cabs(h);
+}
+
+static double fir_response(const double *h, int taps, double w)
+{
+    double complex sum = 0;
+    for (int k = 0; k < taps; k++)
+        sum += h[k] * cexp(-I * w * k);
+    return cabs(sum);
+}
+
+static void print_response(double fs, double fc, double (*response)(const void *, int, double),
+                           const void *coeffs, int n)
+{
+    const double freqs[] = {0, fc / 2, fc, 2 * fc, fs / 2};
+    printf("// response:");
+    for (size_t i = 0; i < sizeof(freqs) / sizeof(freqs[0]); i++)
+        if (freqs[i] <= fs / 2)
+            printf(" %g Hz %.2f dB,", freqs[i], 20 * log10(response(coeffs, n, 2 * PI * freqs[i] / fs) + 1e-12));
+    printf("\n");
+}
+
+static double biquad_response_any(const void *q, int n, double w)
+{
+    return biquad_response((const int32_t(*)[5])q, n, w);
+}
+
+static double fir_response_any(const void *h, int n, double w)
+{
+    return fir_response((const double *)h, n, w);
+}
+
+static int design_biquad(const char *type, double fs, double fc, int order, double q, const char *name)
+{
+    biquad_t sections[MAX_SECTIONS];
+    int32_t quantized[MAX_SECTIONS][5];
+    int count = 0;
+    double w0 = 2 * PI * fc / fs;
+
+    if (strcmp(type, "lowpass") == 0 || strcmp(type, "highpass") == 0)
+    {
+        if (order < 1 || order > 2 * MAX_SECTIONS)
+        {
+            fprintf(stderr, "order must be 1 ... %d\n", 2 * MAX_SECTIONS);
+            return 1;
+        }
+        // Butterworth poles, one section per conjugate pair
+        for (int k = 0; k < order / 2; k++)
+            sections[count++] = biquad_rbj(type, w0, 1 / (2 * sin((2 * k + 1) * PI / (2 * order))));
+        if (order & 1)
+            sections[count++] = biquad_first_order(type, w0);
+    }
+    else
+        sections[count++] = biquad_rbj(type, w0, q);
+
+    printf("// %s, fs %g Hz, fc %g Hz, %d section(s), Q2.30 {b0, b1, b2, a1, a2}\n", type, fs, fc, count);
+    printf("static const filter_biquad_coeffs_t %s[%d] = {\n", name, count);
+    for (int s = 0; s < count; s++)
+    {
+        biquad_t b = sections[s];
+        quantized[s][0] = to_q30(b.b0);
+        quantized[s][1] = to_q30(b.b1);
+        quantized[s][2] = to_q30(b.b2);
+        quantized[s][3] = to_q30(b.a1);
+        quantized[s][4] = to_q30(b.a2);
+        printf("    {%d, %d, %d, %d, %d},\n", quantized[s][0], quantized[s][1], quantized[s][2],
+               quantized[s][3], quantized[s][4]);
+    }
+    printf("};\n");
+    print_response(fs, fc, biquad_response_any, quantized, count);
+    return 0;
+}
+
+static int design_fir(const char *type, double fs, double fc, int taps, const char *name)
+{
+    static double h[MAX_TAPS];
+    double fn = fc / fs, sum = 0;
+    int highpass = strcmp(type, "fir-highpass") == 0;
+
+    if (taps < 1 || taps > MAX_TAPS || (highpass && !(taps & 1)))
+    {
+        fprintf(stderr, "taps must be 1 ... %d, odd for highpass\n", MAX_TAPS);
+        return 1;
+    }
+
+    for (int k = 0; k < taps; k++)
+    {
+        double m = k - (taps - 1) / 2.0;
+        double sinc = m == 0 ? 2 * fn : sin(2 * PI * fn * m) / (PI * m);
+        double window = taps > 1 ? 0.54 - 0.46 * cos(2 * PI * k / (taps - 1)) : 1;
+        h[k] = sinc * window;
+        sum += h[k];
+    }
+    // unity gain at DC, a highpass is the spectral inversion of it
+    for (int k = 0; k < taps; k++)
+        h[k] = highpass ? -h[k] / sum : h[k] / sum;
+    if (highpass)
+        h[(taps - 1) / 2] += 1;
+
+    printf("// %s, fs %g Hz, fc %g Hz, %d taps\n", type, fs, fc, taps);
+    printf("static const fixed_t %s[%d] = {\n", name, taps);
+    for (int k = 0; k < taps; k++)
+        printf("    {%ld},\n", lround(h[k] * (1 << FIXED_WIDTH)));
+    printf("};\n");
+    printf("static const int16_t %s_q15[%d] = {\n", name, taps);
+    for (int k = 0; k < taps; k++)
+    {
+        printf("    %d,\n", to_q15(h[k]));
+        h[k] = round(h[k] * (1 << FIXED_WIDTH)) / (1 << FIXED_WIDTH);
+    }
+    printf("};\n");
+    print_response(fs, fc, fir_response_any, h, taps);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int order = 2, taps = 31;
+    double q = M_SQRT1_2;
+    const char *name = "filter_coeffs";
+
+    if (argc < 4)
+    {
+        fprintf(stderr, "usage: filter_design <lowpass|highpass|bandpass|notch|fir-lowpass|fir-highpass> "
+                        "<fs> <fc> [-o order] [-q Q] [-t taps] [-n name]\n");
+        return 1;
+    }
+
+    const char *type = argv[1];
+    double fs = atof(argv[2]), fc = atof(argv[3]);
+
+    for (int arg = 4; arg + 1 < argc; arg += 2)
+    {
+        if (strcmp(argv[arg], "-o") == 0)
+            order = atoi(argv[arg + 1]);
+        else if (strcmp(argv[arg], "-q") == 0)
+            q = atof(argv[arg + 1]);
+        else if (strcmp(argv[arg], "-t") == 0)
+            taps = atoi(argv[arg + 1]);
+        else if (strcmp(argv[arg], "-n") == 0)
+            name = argv[arg + 1];
+    }
+
+    if (!(fc > 0 && fc < fs / 2) || q <= 0)
+    {
+        fprintf(stderr, "need 0 < fc < fs / 2 and Q > 0\n");
+        return 1;
+    }
+
+    if (strncmp(type, "fir-", 4) == 0)
+    {
+        if (strcmp(type, "fir-lowpass") == 0 || strcmp(type, "fir-highpass") == 0)
+            return design_fir(type, fs, fc, taps, name);
+    }
+    else if (strcmp(type, "lowpass") == 0 || strcmp(type, "highpass") == 0 ||
+             strcmp(type, "bandpass") == 0 || strcmp(type, "notch") == 0)
+        return design_biquad(type, fs, fc, order, q, name);
+
+    fprintf(stderr, "unknown filter type %s\n", type);
+    return 1;
+}
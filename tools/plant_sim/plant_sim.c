@@ -0,0 +1,504 @@
+/**
+ * @file plant_sim.c
+ * @author simakeng (simakeng@outlook.com)
+ * @brief Closed loop plant simulator for the PID and FOC code
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *  plant_sim [-c pid|incr] [-r rate] [-t seconds] [-n noise]
+ *            [-o overshoot] [-s settle] [plant ...]
+ *
+ *  thermal  heater, first order, 30 s time constant, PID on the duty
+ *  dc       brushed DC motor, PI speed loop on the voltage
+ *  foc      PMSM, PI current loops through foc.h and angle.h, step of iq
+ *
+ *  -c  controller, pid_state_t or pid_incr_t, default both
+ *  -r  control rate in Hz, default per plant
+ *  -t  simulated time in seconds, default per plant
+ *  -n  measurement noise, a fraction of the setpoint, default 0
+ *  -o  max overshoot in percent
+ *  -s  max settling time in ms
+ *
+ * the plants are integrated in double with a fixed step, several steps
+ * per control period, and the noise comes from a fixed seed, so every
+ * run gives the same numbers. the controllers are the library code in
+ * fixed point. both forms get the same continuous gains, pid_state_t
+ * has no output limit, the actuator clamps its output.
+ *
+ * the time per controller update is measured after the run, by feeding
+ * the recorded inputs through fresh controllers in a tight loop.
+ *
+ * the exit status is 1 if a run does not settle into 2% of the step,
+ * or is above a limit of -o / -s, so a change of the controller math
+ * can be gated on it. it is 2 for an unknown plant or option, or an
+ * option without its value, so a typo can not pass the gate.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#include <libe15-fpa.h>
+#include <libe15-pid.h>
+#include <foc.h>
+
+#define PI 3.14159265358979323846
+
+/// plant integration steps per control period
+#define SIM_SUBSTEPS 20
+
+/// settled within this fraction of the step
+#define SIM_BAND 0.02
+
+/// controller updates timed per replay, at least
+#define SIM_REPLAY_UPDATES 2000000
+
+typedef enum
+{
+    SIM_PID,
+    SIM_INCR,
+} sim_kind_t;
+
+static const char *const sim_kind_name[] = {"pid", "incr"};
+
+typedef struct
+{
+    double rate;      ///< 0 for the default of the plant
+    double seconds;   ///< 0 for the default of the plant
+    double noise;     ///< fraction of the setpoint
+    double overshoot; ///< limit in percent, 0 for none
+    double settle;    ///< limit in ms, 0 for none
+} sim_config_t;
+
+/// the response of one run, one sample per control period
+typedef struct
+{
+    double *y;
+    size_t n;
+    double rate;
+    double setpoint;
+    double ns; ///< per controller update
+} sim_result_t;
+
+/// one controller in either form, the same continuous gains
+typedef struct
+{
+    sim_kind_t kind;
+    pid_state_t pid;
+    pid_incr_t incr;
+    double out_min, out_max;
+} sim_ctrl_t;
+
+/******************************************************************************/
+/*                        PRIVATE FUNCTION DEFINITIONS                        */
+/******************************************************************************/
+
+static fixed_t to_fixed(double v)
+{
+    double r = round(v * 65536);
+    return (fixed_t){(fixed_value_t)(r > INT32_MAX ? INT32_MAX : r < INT32_MIN ? INT32_MIN : r)};
+}
+
+static double from_fixed(fixed_t v)
+{
+    return v.val / 65536.0;
+}
+
+static double clamp(double v, double lo, double hi)
+{
+    return v < lo ? lo : v > hi ? hi : v;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint32_t sim_seed;
+
+/// uniform in [-amp, amp], xorshift32 from a fixed seed
+static double sim_noise(double amp)
+{
+    sim_seed ^= sim_seed << 13;
+    sim_seed ^= sim_seed >> 17;
+    sim_seed ^= sim_seed << 5;
+    return amp * (sim_seed / 2147483648.0 - 1);
+}
+
+/**
+ * @brief set up a controller, ki in 1 / s and kd in s. pid_state_t
+ *        sums the raw error and differences it per update, so its
+ *        gains are scaled by the rate.
+ */
+static void sim_ctrl_init(sim_ctrl_t *c, sim_kind_t kind, double kp, double ki, double kd, double rate,
+                          uint32_t d_cutoff_hz, double out_min, double out_max)
+{
+    c->kind = kind;
+    c->out_min = out_min;
+    c->out_max = out_max;
+    pid_init_controller(to_fixed(kp), to_fixed(ki / rate), to_fixed(kd * rate), &c->pid);
+    pid_incr_init(&c->incr, to_fixed(kp), to_fixed(ki), to_fixed(kd), (uint32_t)rate, d_cutoff_hz,
+                  to_fixed(out_min), to_fixed(out_max));
+}
+
+static fixed_t sim_ctrl_update(sim_ctrl_t *c, fixed_t error)
+{
+    if (c->kind == SIM_INCR)
+        return pid_incr_update(&c->incr, error);
+    pid_update_controller(&c->pid, error);
+    return c->pid.output;
+}
+
+/// the actuator, which clamps what pid_state_t puts out
+static double sim_ctrl_output(sim_ctrl_t *c, fixed_t out)
+{
+    return clamp(from_fixed(out), c->out_min, c->out_max);
+}
+
+/**
+ * @brief time a SISO controller over recorded errors
+ * @return double ns per update
+ */
+static double sim_replay(const sim_ctrl_t *proto, const fixed_t *error, size_t n)
+{
+    sim_ctrl_t c = *proto;
+    fixed_value_t acc = 0;
+    size_t rounds = SIM_REPLAY_UPDATES / n + 1;
+
+    double start = now_ns();
+    for (size_t r = 0; r < rounds; r++)
+        for (size_t i = 0; i < n; i++)
+            acc += sim_ctrl_update(&c, error[i]).val;
+    double ns = (now_ns() - start) / (double)(rounds * n);
+
+    // keep the result alive
+    if (acc == 0x7A5A5A5A)
+        printf(" ");
+    return ns;
+}
+
+static void sim_result_alloc(sim_result_t *res, const sim_config_t *cfg, double rate, double seconds)
+{
+    res->rate = cfg->rate > 0 ? cfg->rate : rate;
+    res->n = (size_t)((cfg->seconds > 0 ? cfg->seconds : seconds) * res->rate);
+    res->y = calloc(res->n, sizeof(double));
+}
+
+/**
+ * heater: dT/dt = (100 u - T) / 30, u in [0, 1], T above ambient.
+ * step of the setpoint to 50.
+ */
+static void plant_thermal(const sim_config_t *cfg, sim_kind_t kind, sim_result_t *res)
+{
+    sim_result_alloc(res, cfg, 10, 300);
+    res->setpoint = 50;
+
+    double ts = 1 / res->rate, dt = ts / SIM_SUBSTEPS, temp = 0;
+    fixed_t *error = calloc(res->n, sizeof(fixed_t));
+    sim_ctrl_t c, proto;
+    sim_ctrl_init(&c, kind, 0.08, 0.08 / 30, 0.1, res->rate, 1, 0, 1);
+    proto = c;
+
+    for (size_t k = 0; k < res->n; k++)
+    {
+        double measured = temp + sim_noise(cfg->noise * res->setpoint);
+        error[k] = to_fixed(res->setpoint - measured);
+        double u = sim_ctrl_output(&c, sim_ctrl_update(&c, error[k]));
+
+        for (int s = 0; s < SIM_SUBSTEPS; s++)
+            temp += dt * (100 * u - temp) / 30;
+        res->y[k] = temp;
+    }
+
+    res->ns = sim_replay(&proto, error, res->n);
+    free(error);
+}
+
+/**
+ * brushed DC motor on 24 V, R 1 Ω, L 1 mH, Kt = Ke 0.05, J 1e-5,
+ * b 1e-6. step of the speed setpoint to 300 rad/s.
+ */
+static void plant_dc(const sim_config_t *cfg, sim_kind_t kind, sim_result_t *res)
+{
+    const double r = 1, l = 1e-3, k_e = 0.05, j = 1e-5, b = 1e-6, vbus = 24;
+    sim_result_alloc(res, cfg, 1000, 0.2);
+    res->setpoint = 300;
+
+    double ts = 1 / res->rate, dt = ts / SIM_SUBSTEPS, i = 0, w = 0;
+    fixed_t *error = calloc(res->n, sizeof(fixed_t));
+    sim_ctrl_t c, proto;
+    sim_ctrl_init(&c, kind, 0.05, 0.05 / 0.004, 0, res->rate, 0, -vbus, vbus);
+    proto = c;
+
+    for (size_t k = 0; k < res->n; k++)
+    {
+        double measured = w + sim_noise(cfg->noise * res->setpoint);
+        error[k] = to_fixed(res->setpoint - measured);
+        double v = sim_ctrl_output(&c, sim_ctrl_update(&c, error[k]));
+
+        for (int s = 0; s < SIM_SUBSTEPS; s++)
+        {
+            double di = (v - r * i - k_e * w) / l;
+            double dw = (k_e * i - b * w) / j;
+            i += dt * di;
+            w += dt * dw;
+        }
+        res->y[k] = w;
+    }
+
+    res->ns = sim_replay(&proto, error, res->n);
+    free(error);
+}
+
+/// encoder counts per mechanical turn of the PMSM
+#define FOC_COUNTS 4096
+
+/// pole pairs of the PMSM
+#define FOC_POLE_PAIRS 4
+
+/// the current loop of the firmware: encoder, Clarke, Park, PI, SVPWM
+typedef struct
+{
+    angle_encoder_t enc;
+    sim_ctrl_t d, q;
+    fixed_t iq_ref;
+    fixed_t inv_vbus;
+} foc_loop_t;
+
+/// the recorded inputs of one current loop step
+typedef struct
+{
+    int32_t count;
+    fixed_t ia, ib;
+} foc_input_t;
+
+static foc_abc_t foc_loop_step(foc_loop_t *loop, const foc_input_t *in)
+{
+    foc_sincos_t sc = foc_sincos_angle(angle_encoder_electrical(&loop->enc, in->count));
+    foc_dq_t i = foc_park(foc_clarke(in->ia, in->ib), sc);
+
+    // the PI outputs are in volts, the modulator works in units of the bus
+    fixed_t vd = fixed_mul(sim_ctrl_update(&loop->d, (fixed_t){-i.d.val}), loop->inv_vbus);
+    fixed_t vq = fixed_mul(sim_ctrl_update(&loop->q, fixed_sub(loop->iq_ref, i.q)), loop->inv_vbus);
+    return foc_svpwm(foc_inverse_park((foc_dq_t){vd, vq}, sc));
+}
+
+/**
+ * PMSM on 24 V, R 0.5 Ω, Ld = Lq 0.5 mH, flux 0.01 Wb, 4 pole pairs,
+ * on a load of J 1e-2 turning at 100 rad/s, so the back EMF (4 V) and
+ * the cross coupling are there but barely change. step of the iq
+ * reference to 2 A at a 20 kHz current loop, id is held at 0.
+ */
+static void plant_foc(const sim_config_t *cfg, sim_kind_t kind, sim_result_t *res)
+{
+    const double r = 0.5, l = 0.5e-3, flux = 0.01, j = 1e-2, vbus = 24;
+    const double vmax = vbus / sqrt(3.0), wc = 2 * PI * 1000;
+    sim_result_alloc(res, cfg, 20000, 0.02);
+    res->setpoint = 2;
+
+    double ts = 1 / res->rate, dt = ts / SIM_SUBSTEPS;
+    double id = 0, iq = 0, w = 100, theta = 0;
+    foc_input_t *input = calloc(res->n, sizeof(foc_input_t));
+    foc_loop_t loop, proto;
+
+    // PI zero on the electrical pole, crossover at wc
+    angle_encoder_init(&loop.enc, FOC_COUNTS, FOC_POLE_PAIRS);
+    sim_ctrl_init(&loop.d, kind, l * wc, r * wc, 0, res->rate, 0, -vmax, vmax);
+    sim_ctrl_init(&loop.q, kind, l * wc, r * wc, 0, res->rate, 0, -vmax, vmax);
+    loop.iq_ref = to_fixed(res->setpoint);
+    loop.inv_vbus = to_fixed(1 / vbus);
+    proto = loop;
+
+    for (size_t k = 0; k < res->n; k++)
+    {
+        // phase currents and the encoder, as the ADC and timer see them
+        double te = theta * FOC_POLE_PAIRS;
+        double noise_a = sim_noise(cfg->noise * res->setpoint), noise_b = sim_noise(cfg->noise * res->setpoint);
+        input[k].count = (int32_t)floor(theta / (2 * PI) * FOC_COUNTS);
+        input[k].ia = to_fixed(id * cos(te) - iq * sin(te) + noise_a);
+        input[k].ib = to_fixed(id * cos(te - 2 * PI / 3) - iq * sin(te - 2 * PI / 3) + noise_b);
+
+        foc_abc_t duty = foc_loop_step(&loop, &input[k]);
+
+        // inverter, phase to neutral, back to the rotor frame
+        double da = from_fixed(duty.a), db = from_fixed(duty.b), dc = from_fixed(duty.c);
+        double mean = (da + db + dc) / 3;
+        double va = vbus * (da - mean), vb = vbus * (db - mean), vc = vbus * (dc - mean);
+        double valpha = va, vbeta = (vb - vc) / sqrt(3.0);
+
+        for (int s = 0; s < SIM_SUBSTEPS; s++)
+        {
+            double we = w * FOC_POLE_PAIRS, e = theta * FOC_POLE_PAIRS;
+            double vd = valpha * cos(e) + vbeta * sin(e), vq = -valpha * sin(e) + vbeta * cos(e);
+            double did = (vd - r * id + we * l * iq) / l;
+            double diq = (vq - r * iq - we * l * id - we * flux) / l;
+            double dw = 1.5 * FOC_POLE_PAIRS * flux * iq / j;
+            id += dt * did;
+            iq += dt * diq;
+            w += dt * dw;
+            theta += dt * w;
+        }
+        res->y[k] = iq;
+    }
+
+    // the whole current loop step is the update here
+    foc_loop_t c = proto;
+    fixed_value_t acc = 0;
+    size_t rounds = SIM_REPLAY_UPDATES / res->n + 1;
+    double start = now_ns();
+    for (size_t n = 0; n < rounds; n++)
+        for (size_t k = 0; k < res->n; k++)
+            acc += foc_loop_step(&c, &input[k]).a.val;
+    res->ns = (now_ns() - start) / (double)(rounds * res->n);
+    if (acc == 0x7A5A5A5A)
+        printf(" ");
+
+    free(input);
+}
+
+typedef struct
+{
+    const char *name;
+    void (*run)(const sim_config_t *cfg, sim_kind_t kind, sim_result_t *res);
+} sim_plant_t;
+
+static const sim_plant_t sim_plants[] = {
+    {"thermal", plant_thermal},
+    {"dc", plant_dc},
+    {"foc", plant_foc},
+};
+
+/**
+ * @brief print the metrics of a run
+ * @return int 1 if it did not settle or is above a limit
+ */
+static int sim_report(const char *plant, sim_kind_t kind, const sim_config_t *cfg, const sim_result_t *res)
+{
+    double step = res->setpoint, peak = res->y[0];
+    size_t last_out = 0;
+    int out = 0;
+
+    for (size_t k = 0; k < res->n; k++)
+    {
+        peak = res->y[k] > peak ? res->y[k] : peak;
+        if (fabs(res->y[k] - res->setpoint) > SIM_BAND * fabs(step))
+        {
+            last_out = k + 1;
+            out = 1;
+        }
+    }
+
+    double overshoot = (peak - res->setpoint) / step * 100;
+    overshoot = overshoot < 0 ? 0 : overshoot;
+    int settled = last_out < res->n;
+    double settle_ms = (out ? last_out : 0) / res->rate * 1e3;
+
+    printf("%-8s %-5s %7.0f Hz  settle ", plant, sim_kind_name[kind], res->rate);
+    if (settled)
+        printf("%9.2f ms", settle_ms);
+    else
+        printf("%9s   ", "never");
+    printf("  overshoot %6.2f %%  final %+10.4f  %7.2f ns/update\n", overshoot,
+           res->y[res->n - 1] - res->setpoint, res->ns);
+
+    return !settled || (cfg->overshoot > 0 && overshoot > cfg->overshoot) ||
+           (cfg->settle > 0 && settle_ms > cfg->settle);
+}
+
+/******************************************************************************/
+/*                         PUBLIC FUNCTION DEFINITIONS                        */
+/******************************************************************************/
+
+int main(int argc, char **argv)
+{
+    sim_config_t cfg = {0};
+    int kinds = 3; // bit 0 pid, bit 1 incr
+    const char *plants[sizeof(sim_plants) / sizeof(sim_plants[0])];
+    size_t plant_count = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (argv[i][0] == '-')
+        {
+            if (i + 1 >= argc)
+            {
+                fprintf(stderr, "option %s needs a value\n", argv[i]);
+                return 2;
+            }
+            const char *v = argv[++i];
+            switch (argv[i - 1][1])
+            {
+            case 'c':
+                kinds = strcmp(v, "pid") == 0 ? 1 : strcmp(v, "incr") == 0 ? 2 : 0;
+                break;
+            case 'r':
+                cfg.rate = atof(v);
+                break;
+            case 't':
+                cfg.seconds = atof(v);
+                break;
+            case 'n':
+                cfg.noise = atof(v);
+                break;
+            case 'o':
+                cfg.overshoot = atof(v);
+                break;
+            case 's':
+                cfg.settle = atof(v);
+                break;
+            default:
+                kinds = 0;
+                break;
+            }
+            if (kinds == 0)
+            {
+                fprintf(stderr, "unknown option %s %s\n", argv[i - 1], v);
+                return 2;
+            }
+        }
+        else
+        {
+            size_t p = 0;
+            while (p < sizeof(sim_plants) / sizeof(sim_plants[0]) && strcmp(argv[i], sim_plants[p].name) != 0)
+                p++;
+            if (p == sizeof(sim_plants) / sizeof(sim_plants[0]))
+            {
+                fprintf(stderr, "unknown plant %s\n", argv[i]);
+                return 2;
+            }
+            // a plant named twice runs once
+            if (plant_count < sizeof(plants) / sizeof(plants[0]))
+                plants[plant_count++] = argv[i];
+        }
+    }
+
+    int fail = 0;
+    for (size_t p = 0; p < sizeof(sim_plants) / sizeof(sim_plants[0]); p++)
+    {
+        int selected = plant_count == 0;
+        for (size_t i = 0; i < plant_count; i++)
+            selected |= strcmp(plants[i], sim_plants[p].name) == 0;
+        if (!selected)
+            continue;
+
+        for (int kind = SIM_PID; kind <= SIM_INCR; kind++)
+        {
+            if (!(kinds & (1 << kind)))
+                continue;
+            sim_result_t res;
+            sim_seed = 2463534242u;
+            sim_plants[p].run(&cfg, (sim_kind_t)kind, &res);
+            fail |= sim_report(sim_plants[p].name, (sim_kind_t)kind, &cfg, &res);
+            free(res.y);
+        }
+    }
+
+    return fail;
+}
@@ -0,0 +1,513 @@
+/**
+ * @file sweep.c
+ * @author simakeng (simakeng@outlook.com)
+ * @brief Exhaustive accuracy and speed sweep of libe15 math functions
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * unary functions see every one of the 2^32 inputs, binary functions
+ * an N x N grid, against libm in long double. the work is split over
+ * all cores with pthreads.
+ *
+ *  sweep [-j threads] [-s step] [-g grid] [function ...]
+ *
+ *  -j  worker threads, default all cores
+ *  -s  unary input step, a power of 2, 1 (default) is exhaustive, 256
+ *      for a quick run
+ *  -g  binary grid size, default 4096 (16M pairs)
+ *
+ * errors are in Q16 LSB, against the exact value, so a correctly rounded
+ * result has at most 0.5. inputs whose exact result does not fit fixed_t
+ * are only counted as skipped. the exit status is 1 if a function is
+ * above the max error in its table entry, so a backend change can be
+ * gated on it. it is 2 for an unknown function or option, or an option
+ * without its value, so a typo can not pass the gate.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <libe15-fpa.h>
+
+/// inputs per block, outputs of a block are timed together
+#define SWEEP_BLOCK 4096
+
+#define SWEEP_HIST_BINS 5
+
+/// upper bound (LSB) of each histogram bin
+static const double sweep_hist_limit[SWEEP_HIST_BINS] = {0.5, 1, 2, 4, INFINITY};
+
+typedef struct
+{
+    uint64_t count;
+    uint64_t skipped;
+    uint64_t hist[SWEEP_HIST_BINS];
+    double err_sum;
+    double err_max;
+    /// inputs above the limit of the table entry
+    uint64_t over;
+    int64_t max_a;
+    int64_t max_b;
+    double ns;
+} sweep_stat_t;
+
+typedef struct sweep_func sweep_func_t;
+
+struct sweep_func
+{
+    const char *name;
+    /// 1 for f(a), 2 for f(a, b), 0 for fixed_from_float on float bits
+    int arity;
+    /// unary input range, raw values (float bits for fixed_from_float)
+    int64_t lo;
+    int64_t hi;
+    /// 0 (and max_rel 0) when the function is only reported
+    double max_err;
+    /// plus this much of |exact value|, for results whose error grows with them
+    double max_rel;
+    /// computes out[i] from a[i] (and b[i]), the timed part
+    void (*run)(fixed_value_t *out, const uint32_t *a, const uint32_t *b, int n);
+    /// exact value in Q16 LSB, return 0 to skip the input
+    int (*ref)(uint32_t a, uint32_t b, long double *ref);
+};
+
+/******************************************************************************/
+/*                         FUNCTIONS AND REFERENCES                           */
+/******************************************************************************/
+
+#define LSB 65536.0L
+
+static inline long double sweep_val(uint32_t a)
+{
+    return (fixed_value_t)a / LSB;
+}
+
+static inline int sweep_fits(long double ref)
+{
+    return ref >= INT32_MIN && ref <= INT32_MAX;
+}
+
+#define SWEEP_UNARY(fn)                                                           \
+    static void run_##fn(fixed_value_t *out, const uint32_t *a, const uint32_t *b, int n) \
+    {                                                                             \
+        (void)b;                                                                  \
+        for (int i = 0; i < n; i++)                                               \
+            out[i] = fn((fixed_t){(fixed_value_t)a[i]}).val;                      \
+    }
+
+#define SWEEP_BINARY(fn)                                                          \
+    static void run_##fn(fixed_value_t *out, const uint32_t *a, const uint32_t *b, int n) \
+    {                                                                             \
+        for (int i = 0; i < n; i++)                                               \
+            out[i] = fn((fixed_t){(fixed_value_t)a[i]}, (fixed_t){(fixed_value_t)b[i]}).val; \
+    }
+
+SWEEP_UNARY(fixed_sqrt)
+SWEEP_UNARY(fixed_rsqrt)
+SWEEP_UNARY(fixed_sin)
+SWEEP_UNARY(fixed_cos)
+SWEEP_UNARY(fixed_exp)
+SWEEP_UNARY(fixed_log)
+SWEEP_UNARY(fixed_reciprocal)
+SWEEP_BINARY(fixed_mul)
+SWEEP_BINARY(fixed_div)
+SWEEP_BINARY(fixed_div_fast)
+SWEEP_BINARY(fixed_atan2)
+SWEEP_BINARY(fixed_hypot)
+
+static void run_fixed_from_float(fixed_value_t *out, const uint32_t *a, const uint32_t *b, int n)
+{
+    (void)b;
+    for (int i = 0; i < n; i++)
+    {
+        float f;
+        memcpy(&f, &a[i], sizeof(f));
+        out[i] = fixed_from_float(f).val;
+    }
+}
+
+static int ref_sqrt(uint32_t a, uint32_t b, long double *ref)
+{
+    (void)b;
+    if ((fixed_value_t)a <= 0)
+        return 0;
+    *ref = sqrtl(sweep_val(a)) * LSB;
+    return 1;
+}
+
+static int ref_rsqrt(uint32_t a, uint32_t b, long double *ref)
+{
+    (void)b;
+    if ((fixed_value_t)a <= 0)
+        return 0;
+    *ref = LSB / sqrtl(sweep_val(a));
+    return sweep_fits(*ref);
+}
+
+static int ref_sin(uint32_t a, uint32_t b, long double *ref)
+{
+    (void)b;
+    *ref = sinl(sweep_val(a)) * LSB;
+    return 1;
+}
+
+static int ref_cos(uint32_t a, uint32_t b, long double *ref)
+{
+    (void)b;
+    *ref = cosl(sweep_val(a)) * LSB;
+    return 1;
+}
+
+static int ref_exp(uint32_t a, uint32_t b, long double *ref)
+{
+    (void)b;
+    *ref = expl(sweep_val(a)) * LSB;
+    return sweep_fits(*ref);
+}
+
+static int ref_log(uint32_t a, uint32_t b, long double *ref)
+{
+    (void)b;
+    if ((fixed_value_t)a <= 0)
+        return 0;
+    *ref = logl(sweep_val(a)) * LSB;
+    return 1;
+}
+
+static int ref_reciprocal(uint32_t a, uint32_t b, long double *ref)
+{
+    (void)b;
+    if (a == 0)
+        return 0;
+    *ref = LSB / sweep_val(a);
+    return sweep_fits(*ref);
+}
+
+static int ref_mul(uint32_t a, uint32_t b, long double *ref)
+{
+    *ref = sweep_val(a) * sweep_val(b) * LSB;
+    return sweep_fits(*ref);
+}
+
+static int ref_div(uint32_t a, uint32_t b, long double *ref)
+{
+    if (b == 0)
+        return 0;
+    *ref = sweep_val(a) / sweep_val(b) * LSB;
+    return sweep_fits(*ref);
+}
+
+static int ref_atan2(uint32_t a, uint32_t b, long double *ref)
+{
+    if (a == 0 && b == 0)
+        return 0;
+    *ref = atan2l(sweep_val(a), sweep_val(b)) * LSB;
+    return 1;
+}
+
+static int ref_hypot(uint32_t a, uint32_t b, long double *ref)
+{
+    *ref = hypotl(sweep_val(a), sweep_val(b)) * LSB;
+    return sweep_fits(*ref);
+}
+
+static int ref_from_float(uint32_t a, uint32_t b, long double *ref)
+{
+    float f;
+    (void)b;
+    memcpy(&f, &a, sizeof(f));
+    if (!isfinite(f))
+        return 0;
+    // out of range values are expected to clamp
+    *ref = fmaxl(fminl((long double)f * LSB, INT32_MAX), INT32_MIN);
+    return 1;
+}
+
+#define ALL INT32_MIN, INT32_MAX
+#define TWO_PI (-411775), 411775
+#define FLOAT_BITS 0, UINT32_MAX
+#define GRID 0, 0
+
+/**
+ * an input fails when its error is above max_err + max_rel * |exact|,
+ * both are the measured bound plus some headroom, 0 and 0 means report
+ * only. exp is gated relative to its value, the CORDIC result carries
+ * about 24 significant bits.
+ * sin and cos are gated on |v| <= 2π, larger angles lose precision in
+ * the range reduction, which the second row shows.
+ */
+static const sweep_func_t sweep_funcs[] = {
+    {"fixed_sqrt", 1, ALL, 0.5, 0, run_fixed_sqrt, ref_sqrt},
+    {"fixed_rsqrt", 1, ALL, 1, 0, run_fixed_rsqrt, ref_rsqrt},
+    {"fixed_reciprocal", 1, ALL, 1, 0, run_fixed_reciprocal, ref_reciprocal},
+    {"fixed_sin", 1, TWO_PI, 6, 0, run_fixed_sin, ref_sin},
+    {"fixed_sin", 1, ALL, 0, 0, run_fixed_sin, ref_sin},
+    {"fixed_cos", 1, TWO_PI, 6, 0, run_fixed_cos, ref_cos},
+    {"fixed_cos", 1, ALL, 0, 0, run_fixed_cos, ref_cos},
+    {"fixed_exp", 1, ALL, 1, 0x1p-22, run_fixed_exp, ref_exp},
+    {"fixed_log", 1, ALL, 1, 0, run_fixed_log, ref_log},
+    {"fixed_from_float", 0, FLOAT_BITS, 1, 0, run_fixed_from_float, ref_from_float},
+    {"fixed_mul", 2, GRID, 1, 0, run_fixed_mul, ref_mul},
+    {"fixed_div", 2, GRID, 1, 0, run_fixed_div, ref_div},
+    {"fixed_div_fast", 2, GRID, 2.5, 0, run_fixed_div_fast, ref_div},
+    {"fixed_atan2", 2, GRID, 1, 0, run_fixed_atan2, ref_atan2},
+    {"fixed_hypot", 2, GRID, 1, 0, run_fixed_hypot, ref_hypot},
+};
+
+/******************************************************************************/
+/*                                  WORKERS                                   */
+/******************************************************************************/
+
+static uint32_t sweep_step = 1;
+static uint32_t sweep_grid = 4096;
+
+/**
+ * grid value k of N, the bit pattern is spread by a golden ratio
+ * multiply and shifted by k % 31, so every magnitude from 2^-16 up to
+ * 2^15 shows up on both axes. 0 is left out, the divisions would trap.
+ */
+static uint32_t sweep_grid_value(uint32_t k)
+{
+    uint32_t v = (uint32_t)((fixed_value_t)(k * 2654435761u) >> (k % 31));
+    return v != 0 ? v : 1;
+}
+
+typedef struct
+{
+    const sweep_func_t *func;
+    uint64_t inputs;
+    /// block range of this worker
+    uint64_t first;
+    uint64_t last;
+    sweep_stat_t stat;
+} sweep_job_t;
+
+static double sweep_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void sweep_account(const sweep_func_t *func, sweep_stat_t *st, uint32_t a, uint32_t b, fixed_value_t got,
+                          long double ref)
+{
+    double err = (double)fabsl((long double)got - ref);
+    int bin = 0;
+
+    st->count++;
+    // rows with no limit are report only, nothing counts as above it
+    if (func->max_err != 0 || func->max_rel != 0)
+        st->over += err > func->max_err + func->max_rel * (double)fabsl(ref);
+    st->err_sum += err;
+    if (err > st->err_max)
+    {
+        st->err_max = err;
+        st->max_a = a;
+        st->max_b = b;
+    }
+    while (err > sweep_hist_limit[bin])
+        bin++;
+    st->hist[bin]++;
+}
+
+static void *sweep_worker(void *arg)
+{
+    sweep_job_t *job = arg;
+    const sweep_func_t *func = job->func;
+    uint32_t a[SWEEP_BLOCK], b[SWEEP_BLOCK];
+    fixed_value_t out[SWEEP_BLOCK];
+
+    for (uint64_t blk = job->first; blk < job->last; blk++)
+    {
+        int n = job->inputs - blk * SWEEP_BLOCK < SWEEP_BLOCK ? (int)(job->inputs - blk * SWEEP_BLOCK) : SWEEP_BLOCK;
+
+        for (int i = 0; i < n; i++)
+        {
+            uint64_t idx = blk * SWEEP_BLOCK + i;
+            if (func->arity == 2)
+            {
+                a[i] = sweep_grid_value((uint32_t)(idx / sweep_grid));
+                b[i] = sweep_grid_value((uint32_t)(idx % sweep_grid));
+            }
+            else
+            {
+                a[i] = (uint32_t)(func->lo + (int64_t)(idx * sweep_step));
+                b[i] = 0;
+            }
+        }
+
+        double start = sweep_now_ns();
+        func->run(out, a, b, n);
+        job->stat.ns += sweep_now_ns() - start;
+
+        for (int i = 0; i < n; i++)
+        {
+            long double ref;
+            if (func->ref(a[i], b[i], &ref))
+                sweep_account(func, &job->stat, a[i], b[i], out[i], ref);
+            else
+                job->stat.skipped++;
+        }
+    }
+    return NULL;
+}
+
+static const char *sweep_domain(const sweep_func_t *func, char *buf, size_t len)
+{
+    if (func->arity == 2)
+        snprintf(buf, len, "%ux%u grid", sweep_grid, sweep_grid);
+    else if (func->arity == 0)
+        snprintf(buf, len, "all floats");
+    else if (func->lo == INT32_MIN && func->hi == INT32_MAX)
+        snprintf(buf, len, "all");
+    else
+        snprintf(buf, len, "[%.2f, %.2f]", (double)(func->lo / LSB), (double)(func->hi / LSB));
+    return buf;
+}
+
+/**
+ * @return int 1 if the function is above its max error
+ */
+static int sweep_run(const sweep_func_t *func, int threads)
+{
+    uint64_t inputs = func->arity == 2 ? (uint64_t)sweep_grid * sweep_grid
+                                       : (uint64_t)(func->hi - func->lo) / sweep_step + 1;
+    uint64_t blocks = (inputs + SWEEP_BLOCK - 1) / SWEEP_BLOCK;
+    pthread_t tid[threads];
+    sweep_job_t job[threads];
+    sweep_stat_t total = {0};
+
+    double start = sweep_now_ns();
+    for (int t = 0; t < threads; t++)
+    {
+        job[t] = (sweep_job_t){func, inputs, blocks * t / threads, blocks * (t + 1) / threads, {0}};
+        pthread_create(&tid[t], NULL, sweep_worker, &job[t]);
+    }
+
+    for (int t = 0; t < threads; t++)
+    {
+        pthread_join(tid[t], NULL);
+        sweep_stat_t *st = &job[t].stat;
+        total.count += st->count;
+        total.skipped += st->skipped;
+        total.over += st->over;
+        total.err_sum += st->err_sum;
+        total.ns += st->ns;
+        for (int bin = 0; bin < SWEEP_HIST_BINS; bin++)
+            total.hist[bin] += st->hist[bin];
+        if (st->err_max > total.err_max || t == 0)
+        {
+            total.err_max = st->err_max;
+            total.max_a = st->max_a;
+            total.max_b = st->max_b;
+        }
+    }
+    double wall = (sweep_now_ns() - start) / 1e9;
+
+    int limited = func->max_err != 0 || func->max_rel != 0;
+    int failed = total.over != 0;
+    double n = total.count ? (double)total.count : 1;
+
+    char domain[32];
+    printf("%-18s %-16s %11llu %10.3f %9.4f", func->name, sweep_domain(func, domain, sizeof(domain)),
+           (unsigned long long)total.count,
+           total.err_max, total.err_sum / n);
+    for (int bin = 0; bin < SWEEP_HIST_BINS; bin++)
+        printf(" %7.3f", 100.0 * total.hist[bin] / n);
+    printf(" %8.2f %s\n", total.ns / (double)(total.count + total.skipped), failed ? "FAIL" : "");
+
+    char over[40] = "no limit";
+    if (limited)
+        snprintf(over, sizeof(over), "%llu above limit", (unsigned long long)total.over);
+
+    if (func->arity == 2)
+        printf("%35s worst at (0x%08x, 0x%08x), %llu skipped, %s, %.1fs\n", "",
+               (uint32_t)total.max_a, (uint32_t)total.max_b, (unsigned long long)total.skipped, over, wall);
+    else
+        printf("%35s worst at 0x%08x, %llu skipped, %s, %.1fs\n", "",
+               (uint32_t)total.max_a, (unsigned long long)total.skipped, over, wall);
+
+    return failed;
+}
+
+int main(int argc, char **argv)
+{
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int first_name = argc;
+    int failed = 0;
+
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if (argv[arg][0] == '-')
+        {
+            const char *opt = argv[arg];
+            if (strcmp(opt, "-j") != 0 && strcmp(opt, "-s") != 0 && strcmp(opt, "-g") != 0)
+            {
+                fprintf(stderr, "unknown option %s\n"
+                                "usage: sweep [-j threads] [-s step] [-g grid] [function ...]\n",
+                        opt);
+                return 2;
+            }
+            if (arg + 1 >= argc)
+            {
+                fprintf(stderr, "option %s needs a value\n", opt);
+                return 2;
+            }
+            const char *v = argv[++arg];
+            if (opt[1] == 'j')
+                threads = atoi(v);
+            else if (opt[1] == 's')
+                sweep_step = (uint32_t)strtoul(v, NULL, 0);
+            else
+                sweep_grid = (uint32_t)strtoul(v, NULL, 0);
+        }
+        else
+        {
+            size_t f = 0;
+            while (f < sizeof(sweep_funcs) / sizeof(sweep_funcs[0]) && strcmp(argv[arg], sweep_funcs[f].name) != 0)
+                f++;
+            if (f == sizeof(sweep_funcs) / sizeof(sweep_funcs[0]))
+            {
+                fprintf(stderr, "unknown function %s\n", argv[arg]);
+                return 2;
+            }
+            if (first_name == argc)
+                first_name = arg;
+        }
+    }
+
+    if (threads < 1)
+        threads = 1;
+    if (sweep_step < 1)
+        sweep_step = 1;
+    while (sweep_step & (sweep_step - 1))
+        sweep_step &= sweep_step - 1;
+    // whole blocks only
+    if (sweep_grid < 64)
+        sweep_grid = 64;
+    sweep_grid &= ~63u;
+
+    printf("%d threads, unary step %u, binary grid %u x %u\n", threads, sweep_step, sweep_grid, sweep_grid);
+    printf("%-18s %-16s %11s %10s %9s %7s %7s %7s %7s %7s %8s\n", "function", "domain", "inputs", "max LSB",
+           "mean", "<=0.5%", "<=1%", "<=2%", "<=4%", ">4%", "ns/op");
+
+    for (size_t f = 0; f < sizeof(sweep_funcs) / sizeof(sweep_funcs[0]); f++)
+    {
+        int selected = first_name >= argc;
+        for (int arg = first_name; arg < argc; arg++)
+            selected |= strcmp(argv[arg], sweep_funcs[f].name) == 0;
+        if (selected)
+            failed |= sweep_run(&sweep_funcs[f], threads);
+    }
+
+    return failed;
+}
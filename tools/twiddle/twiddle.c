@@ -0,0 +1,91 @@
+/**
+ * @file twiddle.c
+ * @author simakeng (simakeng@outlook.com)
+ * @brief This tool is used to generate FFT twiddle and bit reversal tables
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * one table of the largest size serves every smaller size: a N point
+ * transform reads every (N_MAX / N)-th twiddle, and its bit reversed
+ * index is the N_MAX one shifted right.
+ */
+
+#include <stdint.h>
+
+#include <stdio.h>
+#include <math.h>
+
+/**
+ * the table size follows Kconfig, but this tool can still be built
+ * without a configured tree.
+ */
+#if defined(__has_include)
+#if __has_include(<generated-conf.h>)
+#include <generated-conf.h>
+#endif
+#endif
+
+#ifndef CONFIG_FFT_MAX_POINTS_LOG2
+#define CONFIG_FFT_MAX_POINTS_LOG2 10
+#endif
+
+#define PI 3.1415926535897932384626433832795l
+
+/**
+ * @brief round to Q15, 1.0 saturates to 32767
+ */
+static int16_t q15(long double v)
+{
+    long double r = roundl(v * 32768.0l);
+    if (r > 32767)
+        r = 32767;
+    if (r < -32768)
+        r = -32768;
+    return (int16_t)r;
+}
+
+static uint32_t bit_reverse(uint32_t v, int bits)
+{
+    uint32_t r = 0;
+    for (int i = 0; i < bits; i++)
+        r |= ((v >> i) & 1) << (bits - 1 - i);
+    return r;
+}
+
+int main(void)
+{
+    int bits = CONFIG_FFT_MAX_POINTS_LOG2;
+    uint32_t n = 1u << bits;
+
+    printf("/**\n"
+           " * @file fft_twiddle.h\n"
+           " * @brief generated by tools/twiddle/twiddle.c, do not edit\n"
+           " */\n\n");
+
+    // tests include it next to fft.h, cheat.h includes a test more than once
+    printf("#ifndef __FFT_TWIDDLE_H__\n#define __FFT_TWIDDLE_H__\n\n");
+
+    printf("#define FFT_MAX_POINTS_LOG2 %d\n", bits);
+    printf("#define FFT_MAX_POINTS %u\n\n", n);
+
+    printf("/// exp(-2πik / FFT_MAX_POINTS) in Q15, {re, im} pairs\n");
+    printf("static const int16_t fft_twiddle_q15[%u][2] = {\n", n / 2);
+    for (uint32_t k = 0; k < n / 2; k++)
+    {
+        long double angle = -2 * PI * k / n;
+        printf("    {%d, %d},\n", q15(cosl(angle)), q15(sinl(angle)));
+    }
+    printf("};\n\n");
+
+    printf("/// bit reversed index of FFT_MAX_POINTS points\n");
+    printf("static const uint16_t fft_bit_reverse[%u] = {\n", n);
+    for (uint32_t k = 0; k < n; k++)
+        printf("    %u,\n", bit_reverse(k, bits));
+    printf("};\n\n");
+
+    printf("#endif //! #ifndef __FFT_TWIDDLE_H__\n");
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file ziggurat.c
+ * @author simakeng (simakeng@outlook.com)
+ * @brief This tool is used to generate the Ziggurat tables of the normal
+ *        distribution in random.c
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * the 128 layers of Marsaglia and Tsang, "The Ziggurat Method for
+ * Generating Random Variables" (2000). layer 0 is the base strip with the
+ * tail, layer i > 0 spans [0, x_i) and lies under f(x_i), with x_127 = r.
+ */
+
+#include <stdint.h>
+
+#include <stdio.h>
+#include <math.h>
+
+#define LAYERS 128
+
+/// start of the tail and area of one layer, for 128 layers
+#define R 3.442619855899l
+#define V 9.91256303526217e-3l
+
+/// unnormalized density exp(-x^2 / 2)
+static long double f(long double x)
+{
+    return expl(-0.5l * x * x);
+}
+
+static uint32_t fix(long double v, int frac)
+{
+    return (uint32_t)llroundl(ldexpl(v, frac));
+}
+
+int main(void)
+{
+    long double x[LAYERS];
+
+    x[LAYERS - 1] = R;
+    for (int i = LAYERS - 2; i > 0; i--)
+        x[i] = sqrtl(-2 * logl(V / x[i + 1] + f(x[i + 1])));
+    // width of the base strip, its rectangle and the tail have area V
+    x[0] = V / f(R);
+
+    printf("/**\n"
+           " * @file ziggurat_table.h\n"
+           " * @brief generated by tools/ziggurat/ziggurat.c, do not edit\n"
+           " */\n\n");
+
+    printf("#define RAND_ZIGGURAT_LAYERS %d\n\n", LAYERS);
+    printf("/// start of the tail r, in Q16\n");
+    printf("#define RAND_ZIGGURAT_R_Q16 %u\n\n", fix(R, 16));
+    printf("/// 1 / r, in Q32\n");
+    printf("#define RAND_ZIGGURAT_INV_R_Q32 %u\n\n", fix(1 / R, 32));
+
+    printf("/// a uniform u below k[i] (2^-32) is inside the rectangle of layer i\n");
+    printf("static const uint32_t rand_ziggurat_k[%d] = {\n", LAYERS);
+    for (int i = 0; i < LAYERS; i++)
+    {
+        long double k = i == 0 ? R / x[0] : i == 1 ? 0 : x[i - 1] / x[i];
+        printf("    %uu,\n", (uint32_t)floorl(ldexpl(k, 32)));
+    }
+    printf("};\n\n");
+
+    printf("/// width x_i of layer i, in Q3.29\n");
+    printf("static const uint32_t rand_ziggurat_w[%d] = {\n", LAYERS);
+    for (int i = 0; i < LAYERS; i++)
+        printf("    %uu,\n", fix(x[i], 29));
+    printf("};\n\n");
+
+    printf("/// f(x_i), f(0) = 1 for layer 0, in Q31\n");
+    printf("static const uint32_t rand_ziggurat_f[%d] = {\n", LAYERS);
+    for (int i = 0; i < LAYERS; i++)
+        printf("    %uu,\n", fix(i == 0 ? 1 : f(x[i]), 31));
+    printf("};\n");
+
+    return 0;
+}